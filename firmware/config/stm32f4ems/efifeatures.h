@@ -18,6 +18,13 @@
 #define EFI_LAUNCH_CONTROL TRUE
 #endif
 
+/**
+ * closed loop VE learning, about 4K of RAM
+ */
+#ifndef EFI_VE_LEARNING
+#define EFI_VE_LEARNING TRUE
+#endif
+
 #define EFI_FSIO TRUE
 
 #ifndef EFI_CDM_INTEGRATION
@@ -107,6 +114,10 @@
 #define EFI_SIGNAL_EXECUTOR_SLEEP FALSE
 #define EFI_SIGNAL_EXECUTOR_ONE_TIMER TRUE
 #define EFI_SIGNAL_EXECUTOR_HW_TIMER FALSE
+/**
+ * host-only: discrete-event virtual clock instead of hardware timer, see virtual_clock_executor.h
+ */
+#define EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK FALSE
 
 #define FUEL_MATH_EXTREME_LOGGING FALSE
 
@@ -161,6 +172,13 @@
 #define EFI_HIP_9011 FALSE
 #endif
 
+/**
+ * knock sensor sampled by ADC3 and processed in software, alternative to HIP9011
+ */
+#ifndef EFI_SOFTWARE_KNOCK
+#define EFI_SOFTWARE_KNOCK FALSE
+#endif
+
 #ifndef EFI_CJ125
 #define EFI_CJ125 TRUE
 #endif
@@ -0,0 +1,93 @@
+/**
+ * @file	ts_frame_parser.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "ts_frame_parser.h"
+#include "tunerstudio_io.h"
+#include "crc.h"
+
+#include <string.h>
+
+/**
+ * CRC packet size is below 0x100 + BLOCKING_FACTOR so its high byte is never a printable command
+ */
+bool isTsPlainCommand(uint8_t firstByte) {
+	return firstByte == TS_HELLO_COMMAND || firstByte == TS_TEST_COMMAND || firstByte == 'T'
+			|| firstByte == TS_COMMAND_F;
+}
+
+void TsFrameParser::reset() {
+	start = end = 0;
+	isPipelined = false;
+}
+
+uint8_t *TsFrameParser::getWritePointer() {
+	return (uint8_t *)buffer + end;
+}
+
+int TsFrameParser::getFreeSize() const {
+	return sizeof(buffer) - end;
+}
+
+void TsFrameParser::onReceived(int size) {
+	end += size;
+	isPipelined = false;
+}
+
+int TsFrameParser::getPendingSize() const {
+	return end - start;
+}
+
+ts_frame_e TsFrameParser::next(char **payload, int *size) {
+	int available = end - start;
+	char *frame = buffer + start;
+	ts_frame_e result;
+	int frameSize;
+
+	if (available >= 1 && isTsPlainCommand(frame[0])) {
+		result = TS_FRAME_PLAIN;
+		*payload = frame;
+		*size = 1;
+		frameSize = 1;
+	} else if (available >= 2) {
+		int packetSize = (uint8_t)frame[0] << 8 | (uint8_t)frame[1];
+		*size = packetSize;
+		if (packetSize == 0 || packetSize > (int)sizeof(buffer) - CRC_WRAPPING_SIZE) {
+			result = TS_FRAME_INVALID_SIZE;
+			frameSize = 2;
+		} else if (available < 2 + packetSize + CRC_VALUE_SIZE) {
+			result = TS_FRAME_INCOMPLETE;
+		} else {
+			*payload = frame + 2;
+			// CRC follows the payload so it is not aligned
+			uint32_t expectedCrc;
+			memcpy(&expectedCrc, frame + 2 + packetSize, sizeof(expectedCrc));
+			expectedCrc = SWAP_UINT32(expectedCrc);
+			result = crc32(frame + 2, packetSize) == expectedCrc ? TS_FRAME_CRC : TS_FRAME_CRC_MISMATCH;
+			frameSize = 2 + packetSize + CRC_VALUE_SIZE;
+		}
+	} else {
+		result = TS_FRAME_INCOMPLETE;
+	}
+
+	if (result == TS_FRAME_INCOMPLETE) {
+		// move the partial frame to the beginning so that the rest of it has room to arrive
+		if (start != 0) {
+			memmove(buffer, buffer + start, available);
+			start = 0;
+			end = available;
+		}
+		return result;
+	}
+
+	start += frameSize;
+	frameCounter++;
+	if (isPipelined) {
+		pipelinedFrameCounter++;
+	}
+	isPipelined = true;
+	return result;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file	ts_frame_parser.h
+ * @brief	Incremental parser of TunerStudio binary protocol frames
+ *
+ * Received bytes are appended to the buffer in whatever portions the channel delivers them, complete frames
+ * are taken out in order. Host could send several requests back to back without waiting for each response:
+ * all frames which are already in the buffer are handled one after another.
+ *
+ * Two kinds of frames: single byte plain commands and CRC packets
+ * [size high][size low][command][data...][crc32 4 bytes]
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+/**
+ * Largest CRC packet together with size and CRC fits, so a partial frame never blocks the buffer.
+ * See 'blockingFactor' in rusefi.ini
+ */
+#define TS_RX_BUFFER_SIZE (BLOCKING_FACTOR + 30)
+
+typedef enum {
+	/**
+	 * not enough bytes for a complete frame yet
+	 */
+	TS_FRAME_INCOMPLETE = 0,
+	TS_FRAME_PLAIN = 1,
+	/**
+	 * CRC packet with valid CRC
+	 */
+	TS_FRAME_CRC = 2,
+	/**
+	 * size is zero or too large, size bytes were dropped
+	 */
+	TS_FRAME_INVALID_SIZE = 3,
+	/**
+	 * complete CRC packet with wrong CRC, packet was dropped
+	 */
+	TS_FRAME_CRC_MISMATCH = 4,
+} ts_frame_e;
+
+bool isTsPlainCommand(uint8_t firstByte);
+
+class TsFrameParser {
+public:
+	void reset();
+	/**
+	 * Received bytes should be written here, up to getFreeSize() bytes
+	 */
+	uint8_t *getWritePointer();
+	int getFreeSize() const;
+	void onReceived(int size);
+	/**
+	 * @return number of received bytes which are not a complete frame yet
+	 */
+	int getPendingSize() const;
+	/**
+	 * Takes next frame out of the buffer.
+	 * @param payload for TS_FRAME_CRC: command byte followed by request data, size does not include CRC.
+	 * For TS_FRAME_PLAIN: the command byte. Valid until next invocation.
+	 */
+	ts_frame_e next(char **payload, int *size);
+
+	uint32_t frameCounter;
+	/**
+	 * frames which were already in the buffer when previous frame was handled, i.e. have not waited
+	 * for a read
+	 */
+	uint32_t pipelinedFrameCounter;
+private:
+	char buffer[TS_RX_BUFFER_SIZE];
+	int start;
+	int end;
+	bool isPipelined;
+};
@@ -86,6 +86,9 @@
 #include "status_loop.h"
 #include "mmc_card.h"
 #include "perf_trace.h"
+#include "spark_logic.h"
+#include "event_queue.h"
+#include "config_dependency.h"
 
 #if EFI_SIMULATOR
 #include "rusEfiFunctionalTest.h"
@@ -139,6 +142,8 @@ static void printErrorCounters(void) {
 			tsState.outputChannelsCommandCounter, tsState.readPageCommandsCounter, tsState.burnCommandCounter);
 	scheduleMsg(&tsLogger, "TunerStudio W=%d / C=%d / P=%d", tsState.writeValueCommandCounter,
 			tsState.writeChunkCommandCounter, tsState.pageCommandCounter);
+	scheduleMsg(&tsLogger, "TunerStudio frames=%d / pipelined=%d", tsChannel.parser.frameCounter,
+			tsChannel.parser.pipelinedFrameCounter);
 }
 
 void printTsStats(void) {
@@ -269,6 +274,10 @@ static const void * getStructAddr(int structId) {
 		return static_cast<trigger_central_s*>(&engine->triggerCentral);
 	case LDS_TRIGGER_STATE_STATE_INDEX:
 		return static_cast<trigger_state_s*>(&engine->triggerCentral.triggerState);
+	case LDS_KNOCK_STATE_INDEX:
+		return static_cast<knock_state_s*>(&engine->knockTracker);
+	case LDS_MISFIRE_STATE_INDEX:
+		return static_cast<misfire_state_s*>(&engine->misfireAnalyzer);
 #if EFI_ELECTRONIC_THROTTLE_BODY
 	case LDS_ETB_PID_STATE_INDEX:
 		return static_cast<EtbController*>(engine->etbControllers[0])->getPidState();
@@ -284,6 +293,43 @@ static const void * getStructAddr(int structId) {
 	}
 }
 
+/**
+ * @return lock which writers of given structure are holding, nullptr if structure is not guarded
+ */
+static const SeqLock * getStructLock(int structId) {
+	switch (structId) {
+	case LDS_ENGINE_STATE_INDEX:
+		return &engine->engineState.stateLock;
+	case LDS_KNOCK_STATE_INDEX:
+		return &engine->knockTracker.stateLock;
+	case LDS_MISFIRE_STATE_INDEX:
+		return &engine->misfireAnalyzer.stateLock;
+#if EFI_ELECTRONIC_THROTTLE_BODY
+	case LDS_ETB_PID_STATE_INDEX:
+		return static_cast<EtbController*>(engine->etbControllers[0])->getPidLock();
+#endif /* EFI_ELECTRONIC_THROTTLE_BODY */
+
+#ifndef EFI_IDLE_CONTROL
+	case LDS_IDLE_PID_STATE_INDEX:
+		return &idlePid.stateLock;
+#endif /* EFI_IDLE_CONTROL */
+
+	// trigger structures are independent counters, each one is a single word store
+	default:
+		return nullptr;
+	}
+}
+
+/**
+ * Consistent copy of a guarded structure is sent from here, so that the response is never half old and half new
+ */
+static union {
+	engine_state2_s engineState;
+	knock_state_s knock;
+	misfire_state_s misfire;
+	pid_state_s pid;
+} structSnapshot;
+
 /**
  * Read internal structure for Live Doc
  * This is somewhat similar to read page and somewhat similar to read outputs
@@ -297,6 +343,12 @@ static void handleGetStructContent(ts_channel_s *tsChannel, int structId, int si
 		// todo: add warning code - unexpected structId
 		return;
 	}
+	const SeqLock *lock = getStructLock(structId);
+	if (lock != nullptr && size <= (int)sizeof(structSnapshot)) {
+		// a reader which gave up still has the latest copy, which is no worse than sending the live structure
+		lock->read(addr, &structSnapshot, size);
+		addr = &structSnapshot;
+	}
 	sr5SendResponse(tsChannel, TS_CRC, (const uint8_t *)addr, size);
 }
 
@@ -341,6 +393,7 @@ void handleWriteChunkCommand(ts_channel_s *tsChannel, ts_response_format_e mode,
 	uint8_t * addr = (uint8_t *) (getWorkingPageAddr() + offset);
 	memcpy(addr, content, count);
 	onlineApplyWorkingCopyBytes(offset, count);
+	configChangeTracker.onWrite(offset, count);
 
 	sendOkResponse(tsChannel, mode);
 }
@@ -393,6 +446,7 @@ void handleWriteValueCommand(ts_channel_s *tsChannel, ts_response_format_e mode,
 	getWorkingPageAddr()[offset] = value;
 
 	onlineApplyWorkingCopyBytes(offset, 1);
+	configChangeTracker.onWrite(offset, 1);
 
 //	scheduleMsg(logger, "va=%d", configWorkingCopy.boardConfiguration.idleValvePin);
 }
@@ -426,7 +480,13 @@ void requestBurn(void) {
 #if EFI_INTERNAL_FLASH
 	setNeedToWriteConfiguration();
 #endif
-	incrementGlobalConfigurationVersion(PASS_ENGINE_PARAMETER_SIGNATURE);
+	/**
+	 * only subsystems which depend on bytes written since previous burn are updated, so that
+	 * tuning a table cell does not re-initialize trigger or hardware
+	 */
+	applyConfigurationChange(configChangeTracker.takePendingOwners() PASS_ENGINE_PARAMETER_SUFFIX);
+	// 'needBurn' should not wait for version group refresh period
+	invalidateOutputChannelGroups(1 << OCG_VERSION);
 }
 
 static void sendResponseCode(ts_response_format_e mode, ts_channel_s *tsChannel, const uint8_t responseCode) {
@@ -452,7 +512,8 @@ void handleBurnCommand(ts_channel_s *tsChannel, ts_response_format_e mode, uint1
 
 	requestBurn();
 	sendResponseCode(mode, tsChannel, TS_RESPONSE_BURN_OK);
-	scheduleMsg(&tsLogger, "BURN in %dms", currentTimeMillis() - nowMs);
+	scheduleMsg(&tsLogger, "BURN in %dms owners=%x recompute=%dus", currentTimeMillis() - nowMs,
+			configChangeTracker.lastOwners, configChangeTracker.lastOwners == CO_NONE ? 0 : (int)NT2US(configChangeTracker.lastDurationNt));
 }
 
 static bool isKnownCommand(char command) {
@@ -469,12 +530,64 @@ static bool isKnownCommand(char command) {
 			|| command == TS_GET_FIRMWARE_VERSION
 			|| command == TS_PERF_TRACE_BEGIN
 			|| command == TS_PERF_TRACE_GET_BUFFER
+			|| command == TS_GET_LATENCY_HISTOGRAMS
 			|| command == TS_GET_CONFIG_ERROR;
 }
 
+static void handleCrcFrame(ts_channel_s *tsChannel, char *payload, int size) {
+	char command = payload[0];
+	if (!isKnownCommand(command)) {
+		scheduleMsg(&tsLogger, "unexpected command %x", command);
+		sendErrorCode(tsChannel);
+		return;
+	}
+
+#if EFI_SIMULATOR
+			logMsg("command %c\r\n", command);
+#endif
+
+	int success = tunerStudioHandleCrcCommand(tsChannel, payload, size);
+	if (!success)
+		print("got unexpected TunerStudio command %x:%c\r\n", command, command);
+}
+
+/**
+ * Handles all complete frames which are in the receive buffer, in the order they were sent
+ */
+static void handleReceivedFrames(ts_channel_s *tsChannel) {
+	char *payload;
+	int size;
+	while (true) {
+		ts_frame_e frame = tsChannel->parser.next(&payload, &size);
+		if (frame == TS_FRAME_INCOMPLETE) {
+			return;
+		}
+		tsState.totalCounter++;
+
+		switch (frame) {
+		case TS_FRAME_PLAIN:
+			handlePlainCommand(tsChannel, payload[0]);
+			break;
+		case TS_FRAME_INVALID_SIZE:
+			scheduleMsg(&tsLogger, "TunerStudio: invalid size: %d", size);
+			tunerStudioError("ERROR: CRC header size");
+			sendErrorCode(tsChannel);
+			break;
+		case TS_FRAME_CRC_MISMATCH:
+			scheduleMsg(&tsLogger, "TunerStudio: command %c size %d CRC mismatch", payload[0], size);
+			tunerStudioError("ERROR: CRC issue");
+			break;
+		default:
+			handleCrcFrame(tsChannel, payload, size);
+		}
+	}
+}
+
 // this function runs indefinitely
 void runBinaryProtocolLoop(ts_channel_s *tsChannel) {
 	int wasReady = false;
+	TsFrameParser *parser = &tsChannel->parser;
+	parser->reset();
 
 	while (true) {
 		int isReady = sr5IsReady(tsChannel);
@@ -489,17 +602,23 @@ void runBinaryProtocolLoop(ts_channel_s *tsChannel) {
 //			scheduleSimpleMsg(&logger, "ts channel is now ready ", hTimeNow());
 		}
 
-		tsState.totalCounter++;
-
-		uint8_t firstByte;
-		int received = sr5ReadData(tsChannel, &firstByte, 1);
+		/**
+		 * blocks until something arrives, then takes everything which is already there: a few pipelined
+		 * requests are received with one read
+		 */
+		int received = sr5ReadDataAvailable(tsChannel, parser->getWritePointer(), parser->getFreeSize(),
+				SR5_READ_TIMEOUT);
 #if EFI_SIMULATOR
 			logMsg("received %d\r\n", received);
 #endif
 
-
-		if (received != 1) {
-//			tunerStudioError("ERROR: no command");
+		if (received <= 0) {
+			if (parser->getPendingSize() > 0) {
+				scheduleMsg(&tsLogger, "Got only %d bytes of a packet", parser->getPendingSize());
+				tunerStudioError("ERROR: not enough bytes in stream");
+				sendResponseCode(TS_CRC, tsChannel, TS_RESPONSE_UNDERRUN);
+				parser->reset();
+			}
 #if EFI_BLUETOOTH_SETUP
 			// assume there's connection loss and notify the bluetooth init code
 			bluetoothSoftwareDisconnectNotify();
@@ -508,81 +627,8 @@ void runBinaryProtocolLoop(ts_channel_s *tsChannel) {
 		}
 		onDataArrived();
 
-//		scheduleMsg(logger, "Got first=%x=[%c]", firstByte, firstByte);
-		if (handlePlainCommand(tsChannel, firstByte))
-			continue;
-
-		uint8_t secondByte;
-		received = sr5ReadData(tsChannel, &secondByte, 1);
-		if (received != 1) {
-			tunerStudioError("TS: ERROR: no second byte");
-			continue;
-		}
-//		scheduleMsg(logger, "Got secondByte=%x=[%c]", secondByte, secondByte);
-
-		uint16_t incomingPacketSize = firstByte << 8 | secondByte;
-
-		if (incomingPacketSize == 0 || incomingPacketSize > (sizeof(tsChannel->crcReadBuffer) - CRC_WRAPPING_SIZE)) {
-			scheduleMsg(&tsLogger, "TunerStudio: invalid size: %d", incomingPacketSize);
-			tunerStudioError("ERROR: CRC header size");
-			sendErrorCode(tsChannel);
-			continue;
-		}
-
-		received = sr5ReadData(tsChannel, (uint8_t* )tsChannel->crcReadBuffer, 1);
-		if (received != 1) {
-			tunerStudioError("ERROR: did not receive command");
-			continue;
-		}
-
-		char command = tsChannel->crcReadBuffer[0];
-		if (!isKnownCommand(command)) {
-			scheduleMsg(&tsLogger, "unexpected command %x", command);
-			sendErrorCode(tsChannel);
-			continue;
-		}
-
-#if EFI_SIMULATOR
-			logMsg("command %c\r\n", command);
-#endif
-
-
-//		scheduleMsg(logger, "TunerStudio: reading %d+4 bytes(s)", incomingPacketSize);
-
-		received = sr5ReadData(tsChannel, (uint8_t * ) (tsChannel->crcReadBuffer + 1),
-				incomingPacketSize + CRC_VALUE_SIZE - 1);
-		int expectedSize = incomingPacketSize + CRC_VALUE_SIZE - 1;
-		if (received != expectedSize) {
-			scheduleMsg(&tsLogger, "Got only %d bytes while expecting %d for command %c", received,
-					expectedSize, command);
-			tunerStudioError("ERROR: not enough bytes in stream");
-			sendResponseCode(TS_CRC, tsChannel, TS_RESPONSE_UNDERRUN);
-			continue;
-		}
-
-		uint32_t expectedCrc = *(uint32_t*) (tsChannel->crcReadBuffer + incomingPacketSize);
-
-		expectedCrc = SWAP_UINT32(expectedCrc);
-
-		uint32_t actualCrc = crc32(tsChannel->crcReadBuffer, incomingPacketSize);
-		if (actualCrc != expectedCrc) {
-			scheduleMsg(&tsLogger, "TunerStudio: CRC %x %x %x %x", tsChannel->crcReadBuffer[incomingPacketSize + 0],
-					tsChannel->crcReadBuffer[incomingPacketSize + 1], tsChannel->crcReadBuffer[incomingPacketSize + 2],
-					tsChannel->crcReadBuffer[incomingPacketSize + 3]);
-
-			scheduleMsg(&tsLogger, "TunerStudio: command %c actual CRC %x/expected %x", tsChannel->crcReadBuffer[0],
-					actualCrc, expectedCrc);
-			tunerStudioError("ERROR: CRC issue");
-			continue;
-		}
-
-//		scheduleMsg(logger, "TunerStudio: P00-07 %x %x %x %x %x %x %x %x", crcIoBuffer[0], crcIoBuffer[1],
-//				crcIoBuffer[2], crcIoBuffer[3], crcIoBuffer[4], crcIoBuffer[5], crcIoBuffer[6], crcIoBuffer[7]);
-
-		int success = tunerStudioHandleCrcCommand(tsChannel, tsChannel->crcReadBuffer, incomingPacketSize);
-		if (!success)
-			print("got unexpected TunerStudio command %x:%c\r\n", command, command);
-
+		parser->onReceived(received);
+		handleReceivedFrames(tsChannel);
 	}
 }
 
@@ -845,6 +891,16 @@ int tunerStudioHandleCrcCommand(ts_channel_s *tsChannel, char *data, int incomin
 
 		break;
 #endif /* ENABLE_PERF_TRACE */
+#if EFI_ENGINE_CONTROL
+	case TS_GET_LATENCY_HISTOGRAMS:
+		{
+			static latency_histograms_snapshot_s snapshot;
+			triggerToSparkLatency.snapshot(&snapshot.triggerToSpark);
+			eventQueueLateness.snapshot(&snapshot.eventQueueLateness);
+			sr5SendResponse(tsChannel, TS_CRC, reinterpret_cast<const uint8_t*>(&snapshot), sizeof(snapshot));
+		}
+		break;
+#endif /* EFI_ENGINE_CONTROL */
 	case TS_GET_CONFIG_ERROR:
 		sr5SendResponse(tsChannel, TS_CRC, reinterpret_cast<const uint8_t*>(getFirmwareError()), strlen(getFirmwareError()));
 		break;
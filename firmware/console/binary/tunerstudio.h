@@ -66,6 +66,12 @@ void startTunerStudioConnectivity(void);
 void syncTunerStudioCopy(void);
 void runBinaryProtocolLoop(ts_channel_s *tsChannel);
 
+/**
+ * Live data structures which are not part of rusefi_config.txt, indices continue after LDS_TRIGGER_STATE_STATE_INDEX
+ */
+#define LDS_KNOCK_STATE_INDEX 12
+#define LDS_MISFIRE_STATE_INDEX 13
+
 #if defined __GNUC__
 // GCC
 #define pre_packed
@@ -1,4 +1,5 @@
 
 TUNERSTUDIO_SRC_CPP = $(PROJECT_DIR)/console/binary/tunerstudio_io.cpp \
 	$(PROJECT_DIR)/console/binary/tunerstudio.cpp \
+	$(PROJECT_DIR)/console/binary/ts_frame_parser.cpp \
 	$(PROJECT_DIR)/console/binary/bluetooth.cpp 
@@ -9,6 +9,8 @@
 #include "os_access.h"
 #include "tunerstudio_io.h"
 #include "console_io.h"
+
+#include <string.h>
 #if EFI_SIMULATOR
 #include "rusEfiFunctionalTest.h"
 #endif
@@ -219,32 +221,81 @@ int sr5ReadDataTimeout(ts_channel_s *tsChannel, uint8_t * buffer, int size, int
 #endif /* TS_UART_DMA_MODE */
 }
 
+int sr5ReadDataAvailable(ts_channel_s *tsChannel, uint8_t * buffer, int maxSize, int timeout) {
+	int received = sr5ReadDataTimeout(tsChannel, buffer, 1, timeout);
+	if (received != 1 || maxSize == 1) {
+		return received;
+	}
+#if TS_UART_MODE
+	// no receive queue to look into, one byte at a time
+	return received;
+#else
+	return received + sr5ReadDataTimeout(tsChannel, buffer + 1, maxSize - 1, TIME_IMMEDIATE);
+#endif /* TS_UART_MODE */
+}
+
 int sr5ReadData(ts_channel_s *tsChannel, uint8_t * buffer, int size) {
 	return sr5ReadDataTimeout(tsChannel, buffer, size, SR5_READ_TIMEOUT);
 }
 
 
+/**
+ * Every write except the last one is a multiple of TS_TX_BUFFER_SIZE, so on USB the whole response goes
+ * out as one transfer instead of a short packet per part. Parts are copied only up to packet boundary.
+ */
+void sr5WriteDataV(ts_channel_s *tsChannel, const ts_iovec_s *parts, int count) {
+	uint8_t *txBuffer = tsChannel->txBuffer;
+	int staged = 0;
+	for (int i = 0; i < count; i++) {
+		const uint8_t *data = (const uint8_t *) parts[i].data;
+		int size = parts[i].size;
+		while (size > 0) {
+			if (staged == 0 && size >= TS_TX_BUFFER_SIZE) {
+				// whole packets straight from the source
+				int direct = size - size % TS_TX_BUFFER_SIZE;
+				sr5WriteData(tsChannel, data, direct);
+				data += direct;
+				size -= direct;
+				continue;
+			}
+			int chunk = minI(size, TS_TX_BUFFER_SIZE - staged);
+			memcpy(txBuffer + staged, data, chunk);
+			staged += chunk;
+			data += chunk;
+			size -= chunk;
+			if (staged == TS_TX_BUFFER_SIZE) {
+				sr5WriteData(tsChannel, txBuffer, staged);
+				staged = 0;
+			}
+		}
+	}
+	if (staged > 0) {
+		sr5WriteData(tsChannel, txBuffer, staged);
+	}
+}
+
 /**
  * Adds size to the beginning of a packet and a crc32 at the end. Then send the packet.
  */
 void sr5WriteCrcPacket(ts_channel_s *tsChannel, const uint8_t responseCode, const void *buf, const uint16_t size) {
-	uint8_t *writeBuffer = tsChannel->writeBuffer;
-	uint8_t *crcBuffer = &tsChannel->writeBuffer[3];
+	uint8_t header[3];
+	uint8_t crcBuffer[CRC_VALUE_SIZE];
 
-	*(uint16_t *) writeBuffer = SWAP_UINT16(size + 1);   // packet size including command
-	*(uint8_t *) (writeBuffer + 2) = responseCode;
+	*(uint16_t *) header = SWAP_UINT16(size + 1);   // packet size including command
+	header[2] = responseCode;
 
 	// CRC on whole packet
-	uint32_t crc = crc32((void *) (writeBuffer + 2), 1); // command part of CRC
+	uint32_t crc = crc32((void *) (header + 2), 1); // command part of CRC
 	crc = crc32inc((void *) buf, crc, (uint32_t) (size)); // combined with packet CRC
 
 	*(uint32_t *) (crcBuffer) = SWAP_UINT32(crc);
 
-	sr5WriteData(tsChannel, writeBuffer, 3);      // header
-	if (size > 0) {
-		sr5WriteData(tsChannel, (const uint8_t*)buf, size);      // body
-	}
-	sr5WriteData(tsChannel, crcBuffer, 4);      // CRC footer
+	ts_iovec_s parts[] = {
+		{ header, sizeof(header) },
+		{ buf, size },
+		{ crcBuffer, sizeof(crcBuffer) },
+	};
+	sr5WriteDataV(tsChannel, parts, efi::size(parts));
 }
 
 void sr5SendResponse(ts_channel_s *tsChannel, ts_response_format_e mode, const uint8_t * buffer, int size) {
@@ -7,6 +7,7 @@
 
 #pragma once
 #include "global.h"
+#include "ts_frame_parser.h"
 
 #if EFI_PROD_CODE
 #include "usbconsole.h"
@@ -27,15 +28,25 @@ typedef enum {
 	TS_CRC = 1
 } ts_response_format_e;
 
+/**
+ * USB full speed bulk packet size: writes which are multiples of it are not split into short packets
+ */
+#define TS_TX_BUFFER_SIZE 64
+
 typedef struct {
 	BaseChannel * channel;
-	uint8_t writeBuffer[7];	// size(2 bytes) + response(1 byte) + crc32 (4 bytes)
 	/**
-	 * See 'blockingFactor' in rusefi.ini
+	 * response parts are gathered here, see sr5WriteDataV
 	 */
-	char crcReadBuffer[BLOCKING_FACTOR + 30];
+	uint8_t txBuffer[TS_TX_BUFFER_SIZE];
+	TsFrameParser parser;
 } ts_channel_s;
 
+typedef struct {
+	const void *data;
+	int size;
+} ts_iovec_s;
+
 // See uart_dma_s
 #define TS_FIFO_BUFFER_SIZE (BLOCKING_FACTOR + 30)
 // This must be a power of 2!
@@ -76,6 +87,8 @@ typedef struct {
 // Performance tracing
 #define TS_PERF_TRACE_BEGIN 'r'
 #define TS_PERF_TRACE_GET_BUFFER 'b'
+// Latency histograms snapshot, see latency_histograms_snapshot_s
+#define TS_GET_LATENCY_HISTOGRAMS 'h'
 
 #define TS_SINGLE_WRITE_COMMAND 'W' // 0x57 pageValueWrite
 #define TS_CHUNK_WRITE_COMMAND 'C' // 0x43 pageChunkWrite
@@ -102,9 +115,17 @@ bool stopTsPort(ts_channel_s *tsChannel);
 #define SR5_READ_TIMEOUT TIME_MS2I(1000)
 
 void sr5WriteData(ts_channel_s *tsChannel, const uint8_t * buffer, int size);
+/**
+ * Writes all parts as one stream: small parts are gathered into full packets, large ones are written in place
+ */
+void sr5WriteDataV(ts_channel_s *tsChannel, const ts_iovec_s *parts, int count);
 void sr5WriteCrcPacket(ts_channel_s *tsChannel, const uint8_t responseCode, const void *buf, const uint16_t size);
 void sr5SendResponse(ts_channel_s *tsChannel, ts_response_format_e mode, const uint8_t * buffer, int size);
 int sr5ReadData(ts_channel_s *tsChannel, uint8_t * buffer, int size);
 int sr5ReadDataTimeout(ts_channel_s *tsChannel, uint8_t * buffer, int size, int timeout);
+/**
+ * Waits up to timeout for at least one byte, then takes whatever else has already arrived, up to maxSize
+ */
+int sr5ReadDataAvailable(ts_channel_s *tsChannel, uint8_t * buffer, int maxSize, int timeout);
 bool sr5IsReady(ts_channel_s *tsChannel);
 
@@ -0,0 +1,133 @@
+/**
+ * @file	output_channel_groups.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "output_channel_groups.h"
+
+OutputChannelGroups::OutputChannelGroups() {
+	for (int i = 0; i < OCG_COUNT; i++) {
+		refreshPeriodMs[i] = 0;
+	}
+	for (int s = 0; s < OCS_COUNT; s++) {
+		subscription[s] = 0;
+		for (int i = 0; i < OCG_COUNT; i++) {
+			lastRefreshMs[s][i] = 0;
+		}
+		// everything is produced on first request
+		dirtyMask[s] = OCG_ALL;
+	}
+	resetStatistics();
+}
+
+void OutputChannelGroups::setRefreshPeriod(output_channel_group_e group, int refreshPeriodMs) {
+	this->refreshPeriodMs[group] = refreshPeriodMs;
+}
+
+void OutputChannelGroups::subscribe(output_channel_subscriber_e subscriber, uint32_t groupMask) {
+	uint32_t added = groupMask & ~subscription[subscriber];
+	bool alreadyLocked = lockAnyContext();
+	// whatever this subscriber was not interested in so far is stale in its copy
+	dirtyMask[subscriber] |= added;
+	subscription[subscriber] = groupMask & OCG_ALL;
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
+}
+
+uint32_t OutputChannelGroups::getSubscription(output_channel_subscriber_e subscriber) const {
+	return subscription[subscriber];
+}
+
+void OutputChannelGroups::invalidate(uint32_t groupMask) {
+	bool alreadyLocked = lockAnyContext();
+	for (int s = 0; s < OCS_COUNT; s++) {
+		dirtyMask[s] |= groupMask & OCG_ALL;
+	}
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
+}
+
+uint32_t OutputChannelGroups::getDueGroups(output_channel_subscriber_e subscriber, efitimems_t nowMs) {
+	bool alreadyLocked = lockAnyContext();
+	uint32_t wanted = subscription[subscriber];
+	uint32_t dirty = dirtyMask[subscriber];
+	dirtyMask[subscriber] = dirty & ~wanted;
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
+
+	uint32_t due = 0;
+	for (int i = 0; i < OCG_COUNT; i++) {
+		uint32_t bit = 1 << i;
+		if ((wanted & bit) == 0) {
+			continue;
+		}
+		// unsigned difference survives millisecond counter overflow
+		bool isFresh = (dirty & bit) == 0
+				&& (uint32_t)(nowMs - lastRefreshMs[subscriber][i]) < (uint32_t)refreshPeriodMs[i];
+		if (isFresh) {
+			skippedCounter[subscriber][i]++;
+			continue;
+		}
+		due |= bit;
+		lastRefreshMs[subscriber][i] = nowMs;
+	}
+	return due;
+}
+
+void OutputChannelGroups::onProduced(output_channel_subscriber_e subscriber, output_channel_group_e group,
+		uint32_t durationNt) {
+	producedCounter[subscriber][group]++;
+	totalDurationNt[subscriber][group] += durationNt;
+	if (durationNt > maxDurationNt[subscriber][group]) {
+		maxDurationNt[subscriber][group] = durationNt;
+	}
+}
+
+void OutputChannelGroups::resetStatistics() {
+	for (int s = 0; s < OCS_COUNT; s++) {
+		for (int i = 0; i < OCG_COUNT; i++) {
+			producedCounter[s][i] = 0;
+			skippedCounter[s][i] = 0;
+			totalDurationNt[s][i] = 0;
+			maxDurationNt[s][i] = 0;
+		}
+	}
+}
+
+const char *getOutputChannelGroupName(output_channel_group_e group) {
+	switch (group) {
+	case OCG_FAST_SENSORS:
+		return "fast sensors";
+	case OCG_SLOW_SENSORS:
+		return "slow sensors";
+	case OCG_FUEL:
+		return "fuel";
+	case OCG_IGNITION:
+		return "ignition";
+	case OCG_STATUS:
+		return "status";
+	case OCG_VERSION:
+		return "version";
+	case OCG_DEBUG:
+		return "debug";
+	default:
+		return "unknown";
+	}
+}
+
+const char *getOutputChannelSubscriberName(output_channel_subscriber_e subscriber) {
+	switch (subscriber) {
+	case OCS_TUNER_STUDIO:
+		return "TS";
+	case OCS_SD_LOG:
+		return "log";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,102 @@
+/**
+ * @file	output_channel_groups.h
+ * @brief Which parts of TunerStudio output channels need to be computed right now
+ *
+ * Output channels are split into groups, each group is filled by its own producer. Every consumer of output
+ * channels subscribes to the groups it actually reads, and each group has its own refresh period: slow changing
+ * values like temperatures or firmware version are not recomputed on every 'O' request. A group could also be
+ * marked dirty to have it recomputed on next request regardless of its period.
+ *
+ * Each subscriber has its own copy of output channels, so freshness and statistics are tracked per subscriber: a
+ * group produced into one copy says nothing about the other one. Each subscriber is expected to be served by one
+ * thread only.
+ *
+ * OutputChannelGroups only decides what is due and keeps statistics, it does not know anything about the channels
+ * themselves so that the same logic could be benchmarked on the host.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+typedef enum {
+	/**
+	 * rpm, load, throttle, MAP, MAF, AFR
+	 */
+	OCG_FAST_SENSORS = 0,
+	/**
+	 * temperatures, pressures, battery, raw sensor values
+	 */
+	OCG_SLOW_SENSORS = 1,
+	OCG_FUEL = 2,
+	OCG_IGNITION = 3,
+	/**
+	 * status flags, error codes and warnings
+	 */
+	OCG_STATUS = 4,
+	/**
+	 * configuration version, firmware version, burn and SD card state
+	 */
+	OCG_VERSION = 5,
+	/**
+	 * fields which depend on debugMode
+	 */
+	OCG_DEBUG = 6,
+	OCG_COUNT = 7,
+} output_channel_group_e;
+
+#define OCG_ALL ((1 << OCG_COUNT) - 1)
+
+typedef enum {
+	OCS_TUNER_STUDIO = 0,
+	/**
+	 * SD card log builds its line from a snapshot of TS channels and only produces debug fields on its own,
+	 * see writeLogLine()
+	 */
+	OCS_SD_LOG = 1,
+	OCS_COUNT = 2,
+} output_channel_subscriber_e;
+
+class OutputChannelGroups {
+public:
+	OutputChannelGroups();
+	/**
+	 * @param refreshPeriodMs zero to refresh the group on every request
+	 */
+	void setRefreshPeriod(output_channel_group_e group, int refreshPeriodMs);
+	void subscribe(output_channel_subscriber_e subscriber, uint32_t groupMask);
+	uint32_t getSubscription(output_channel_subscriber_e subscriber) const;
+	/**
+	 * Group would be produced for every subscriber on its next request even if refresh period has not passed yet
+	 */
+	void invalidate(uint32_t groupMask);
+	/**
+	 * Groups returned are considered refreshed for this subscriber as of nowMs.
+	 * @return mask of groups which given subscriber needs produced now
+	 */
+	uint32_t getDueGroups(output_channel_subscriber_e subscriber, efitimems_t nowMs);
+	void onProduced(output_channel_subscriber_e subscriber, output_channel_group_e group, uint32_t durationNt);
+	void resetStatistics();
+
+	uint32_t producedCounter[OCS_COUNT][OCG_COUNT];
+	/**
+	 * subscribed group was not produced since it was still fresh
+	 */
+	uint32_t skippedCounter[OCS_COUNT][OCG_COUNT];
+	uint32_t totalDurationNt[OCS_COUNT][OCG_COUNT];
+	uint32_t maxDurationNt[OCS_COUNT][OCG_COUNT];
+private:
+	int refreshPeriodMs[OCG_COUNT];
+	efitimems_t lastRefreshMs[OCS_COUNT][OCG_COUNT];
+	uint32_t subscription[OCS_COUNT];
+	/**
+	 * groups each subscriber has to produce on next request regardless of refresh period
+	 */
+	volatile uint32_t dirtyMask[OCS_COUNT];
+};
+
+const char *getOutputChannelGroupName(output_channel_group_e group);
+const char *getOutputChannelSubscriberName(output_channel_subscriber_e subscriber);
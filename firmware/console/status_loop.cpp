@@ -60,6 +60,7 @@
 #include "can_hw.h"
 #include "periodic_thread_controller.h"
 #include "cdm_ion_sense.h"
+#include "output_channel_groups.h"
 
 extern afr_Map3D_t afrMap;
 extern bool main_loop_started;
@@ -164,7 +165,8 @@ static void reportSensorI(Logging *log, const char *caption, const char *units,
 			append(log, units);
 			append(log, TAB);
 		} else {
-			appendPrintf(log, "%d%s", value, TAB);
+			appendInt(log, value);
+			append(log, TAB);
 		}
 #else
 		UNUSED(log);UNUSED(caption);UNUSED(units);UNUSED(value);
@@ -190,7 +192,10 @@ static float getAirFlowGauge(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 }
 
 #if EFI_FILE_LOGGING
-static void printSensors(Logging *log) {
+/**
+ * @param channels snapshot of output channels, never the live TunerStudio buffer
+ */
+static void printSensors(Logging *log, const TunerStudioOutputChannels *channels) {
 	bool fileFormat = true; // todo:remove this unused variable
 	// current time, in milliseconds
 	int nowMs = currentTimeMillis();
@@ -212,11 +217,11 @@ static void printSensors(Logging *log) {
 
 
 	// 312
-	reportSensorF(log, GAUGE_NAME_ETB_TARGET, "v", tsOutputChannels.etbTarget, 2);
+	reportSensorF(log, GAUGE_NAME_ETB_TARGET, "v", channels->etbTarget, 2);
 	// 316
-	reportSensorF(log, GAUGE_NAME_ETB_DUTY, "e", tsOutputChannels.etb1DutyCycle, 2);
+	reportSensorF(log, GAUGE_NAME_ETB_DUTY, "e", channels->etb1DutyCycle, 2);
 	// 320
-	reportSensorF(log, GAUGE_NAME_ETB_ERROR, "d", tsOutputChannels.etb1Error, 2);
+	reportSensorF(log, GAUGE_NAME_ETB_ERROR, "d", channels->etb1Error, 2);
 
 
 	reportSensorF(log, GAUGE_NAME_FUEL_BARO_CORR, "x", engine->engineState.baroCorrection, 2);
@@ -278,19 +283,19 @@ static void printSensors(Logging *log) {
 #define DEBUG_F_PRECISION 6
 
 #if EFI_TUNER_STUDIO
-		reportSensorF(log, GAUGE_NAME_DEBUG_F1, "v", tsOutputChannels.debugFloatField1, DEBUG_F_PRECISION);
-		reportSensorF(log, GAUGE_NAME_DEBUG_F2, "v", tsOutputChannels.debugFloatField2, DEBUG_F_PRECISION);
-		reportSensorF(log, GAUGE_NAME_DEBUG_F3, "v", tsOutputChannels.debugFloatField3, DEBUG_F_PRECISION);
-		reportSensorF(log, GAUGE_NAME_DEBUG_F4, "v", tsOutputChannels.debugFloatField4, DEBUG_F_PRECISION);
-		reportSensorF(log, GAUGE_NAME_DEBUG_F5, "v", tsOutputChannels.debugFloatField5, DEBUG_F_PRECISION);
-		reportSensorF(log, GAUGE_NAME_DEBUG_F6, "v", tsOutputChannels.debugFloatField6, DEBUG_F_PRECISION);
-		reportSensorF(log, GAUGE_NAME_DEBUG_F7, "v", tsOutputChannels.debugFloatField7, DEBUG_F_PRECISION);
-
-		reportSensorI(log, GAUGE_NAME_DEBUG_I1, "v", tsOutputChannels.debugIntField1);
-		reportSensorI(log, GAUGE_NAME_DEBUG_I2, "v", tsOutputChannels.debugIntField2);
-		reportSensorI(log, GAUGE_NAME_DEBUG_I3, "v", tsOutputChannels.debugIntField3);
-		reportSensorI(log, GAUGE_NAME_DEBUG_I4, "v", tsOutputChannels.debugIntField4);
-		reportSensorI(log, GAUGE_NAME_DEBUG_I5, "v", tsOutputChannels.debugIntField5);
+		reportSensorF(log, GAUGE_NAME_DEBUG_F1, "v", channels->debugFloatField1, DEBUG_F_PRECISION);
+		reportSensorF(log, GAUGE_NAME_DEBUG_F2, "v", channels->debugFloatField2, DEBUG_F_PRECISION);
+		reportSensorF(log, GAUGE_NAME_DEBUG_F3, "v", channels->debugFloatField3, DEBUG_F_PRECISION);
+		reportSensorF(log, GAUGE_NAME_DEBUG_F4, "v", channels->debugFloatField4, DEBUG_F_PRECISION);
+		reportSensorF(log, GAUGE_NAME_DEBUG_F5, "v", channels->debugFloatField5, DEBUG_F_PRECISION);
+		reportSensorF(log, GAUGE_NAME_DEBUG_F6, "v", channels->debugFloatField6, DEBUG_F_PRECISION);
+		reportSensorF(log, GAUGE_NAME_DEBUG_F7, "v", channels->debugFloatField7, DEBUG_F_PRECISION);
+
+		reportSensorI(log, GAUGE_NAME_DEBUG_I1, "v", channels->debugIntField1);
+		reportSensorI(log, GAUGE_NAME_DEBUG_I2, "v", channels->debugIntField2);
+		reportSensorI(log, GAUGE_NAME_DEBUG_I3, "v", channels->debugIntField3);
+		reportSensorI(log, GAUGE_NAME_DEBUG_I4, "v", channels->debugIntField4);
+		reportSensorI(log, GAUGE_NAME_DEBUG_I5, "v", channels->debugIntField5);
 #endif /* EFI_TUNER_STUDIO */
 
 		reportSensorF(log, GAUGE_NAME_TCHARGE, "K", engine->engineState.sd.tChargeK, 2); // log column #8
@@ -373,15 +378,33 @@ static void printSensors(Logging *log) {
 #endif /* EFI_FILE_LOGGING */
 
 
+#if EFI_FILE_LOGGING && EFI_TUNER_STUDIO
+static void prepareLogOutputs(TunerStudioOutputChannels *channels);
+#endif /* EFI_FILE_LOGGING && EFI_TUNER_STUDIO */
+
 void writeLogLine(void) {
 #if EFI_FILE_LOGGING
 	if (!main_loop_started)
 		return;
 	resetLogging(&fileLogger);
-	printSensors(&fileLogger);
+	/**
+	 * Log line is built from a copy: TunerStudio thread keeps writing its own buffer meanwhile, and whatever the
+	 * log produces on its own never ends up in what TunerStudio reads.
+	 */
+	static TunerStudioOutputChannels logOutputChannels;
+	bool alreadyLocked = lockAnyContext();
+	memcpy(&logOutputChannels, &tsOutputChannels, sizeof(logOutputChannels));
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
+#if EFI_TUNER_STUDIO
+	// debug fields are only computed for subscribers
+	prepareLogOutputs(&logOutputChannels);
+#endif /* EFI_TUNER_STUDIO */
+	printSensors(&fileLogger, &logOutputChannels);
 
 	if (isSdCardAlive()) {
-		appendPrintf(&fileLogger, "\r\n");
+		append(&fileLogger, "\r\n");
 		appendToLog(fileLogger.buffer);
 		logFileLineIndex++;
 	}
@@ -676,39 +699,17 @@ extern HIP9011 instance;
 
 #if EFI_TUNER_STUDIO
 
-void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+static OutputChannelGroups outputChannelGroups;
+
+static void updateFastSensorChannels(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
 #if EFI_SHAFT_POSITION_INPUT
 	int rpm = GET_RPM();
 #else /* EFI_SHAFT_POSITION_INPUT */
 	int rpm = 0;
 #endif /* EFI_SHAFT_POSITION_INPUT */
-
-#if EFI_PROD_CODE
-	executorStatistics();
-#endif /* EFI_PROD_CODE */
-
-	float engineLoad = getEngineLoadT(PASS_ENGINE_PARAMETER_SIGNATURE);
-
-	// header
-	tsOutputChannels->tsConfigVersion = TS_FILE_VERSION;
-
 	// offset 0
 	tsOutputChannels->rpm = rpm;
 
-	SensorResult clt = Sensor::get(SensorType::Clt);
-	tsOutputChannels->coolantTemperature = clt.Value;
-	tsOutputChannels->isCltError = !clt.Valid;
-
-	SensorResult iat = Sensor::get(SensorType::Iat);
-	tsOutputChannels->intakeAirTemperature = iat.Value;
-	tsOutputChannels->isIatError = !iat.Valid;
-
-	SensorResult auxTemp1 = Sensor::get(SensorType::AuxTemp1);
-	tsOutputChannels->auxTemp1 = auxTemp1.Value;
-
-	SensorResult auxTemp2 = Sensor::get(SensorType::AuxTemp2);
-	tsOutputChannels->auxTemp2 = auxTemp2.Value;
-
 	SensorResult tps1 = Sensor::get(SensorType::Tps1);
 	tsOutputChannels->throttlePosition = tps1.Value;
 	tsOutputChannels->isTpsError = !tps1.Valid;
@@ -725,9 +726,6 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 	// Set raw sensors
 	tsOutputChannels->rawTps1Primary = Sensor::getRaw(SensorType::Tps1);
 	tsOutputChannels->rawPpsPrimary = Sensor::getRaw(SensorType::AcceleratorPedal);
-	tsOutputChannels->rawClt = Sensor::getRaw(SensorType::Clt);
-	tsOutputChannels->rawIat = Sensor::getRaw(SensorType::Iat);
-	tsOutputChannels->rawOilPressure = Sensor::getRaw(SensorType::OilPressure);
 
 	// offset 16
 	tsOutputChannels->massAirFlowVoltage = hasMafSensor() ? getMafVoltage(PASS_ENGINE_PARAMETER_SIGNATURE) : 0;
@@ -737,7 +735,56 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 		tsOutputChannels->airFuelRatio = getAfr(PASS_ENGINE_PARAMETER_SIGNATURE);
 	}
 	// offset 24
-	tsOutputChannels->engineLoad = engineLoad;
+	tsOutputChannels->engineLoad = getEngineLoadT(PASS_ENGINE_PARAMETER_SIGNATURE);
+
+	// 104
+	tsOutputChannels->rpmAcceleration = engine->rpmCalculator.getRpmAcceleration();
+	// offset 108
+	// For air-interpolated tCharge mode, we calculate a decent massAirFlow approximation, so we can show it to users even without MAF sensor!
+	tsOutputChannels->massAirFlow = getAirFlowGauge(PASS_ENGINE_PARAMETER_SIGNATURE);
+	// offset 116
+	// TPS acceleration
+	tsOutputChannels->deltaTps = engine->tpsAccelEnrichment.getMaxDelta();
+	// 276
+	tsOutputChannels->accelerationX = engine->sensors.accelerometer.x;
+	// 278
+	tsOutputChannels->accelerationY = engine->sensors.accelerometer.y;
+
+	if (hasMapSensor(PASS_ENGINE_PARAMETER_SIGNATURE)) {
+		// offset 40
+		tsOutputChannels->manifoldAirPressure = getMap(PASS_ENGINE_PARAMETER_SIGNATURE);
+	}
+	tsOutputChannels->engineLoadDelta = engine->engineLoadAccelEnrichment.getMaxDelta();
+
+#if EFI_IDLE_CONTROL
+	tsOutputChannels->idlePosition = getIdlePosition();
+#endif
+
+#if EFI_PROD_CODE && EFI_VEHICLE_SPEED
+	float vehicleSpeed = getVehicleSpeed();
+	tsOutputChannels->vehicleSpeedKph = vehicleSpeed;
+	tsOutputChannels->speedToRpmRatio = vehicleSpeed / rpm;
+#endif /* EFI_PROD_CODE && EFI_VEHICLE_SPEED */
+}
+
+static void updateSlowSensorChannels(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	SensorResult clt = Sensor::get(SensorType::Clt);
+	tsOutputChannels->coolantTemperature = clt.Value;
+	tsOutputChannels->isCltError = !clt.Valid;
+
+	SensorResult iat = Sensor::get(SensorType::Iat);
+	tsOutputChannels->intakeAirTemperature = iat.Value;
+	tsOutputChannels->isIatError = !iat.Valid;
+
+	SensorResult auxTemp1 = Sensor::get(SensorType::AuxTemp1);
+	tsOutputChannels->auxTemp1 = auxTemp1.Value;
+
+	SensorResult auxTemp2 = Sensor::get(SensorType::AuxTemp2);
+	tsOutputChannels->auxTemp2 = auxTemp2.Value;
+
+	tsOutputChannels->rawClt = Sensor::getRaw(SensorType::Clt);
+	tsOutputChannels->rawIat = Sensor::getRaw(SensorType::Iat);
+	tsOutputChannels->rawOilPressure = Sensor::getRaw(SensorType::OilPressure);
 
 	// KLUDGE? we always show VBatt because Proteus board has VBatt input sensor hardcoded
 	// offset 28
@@ -747,32 +794,37 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 #if EFI_ANALOG_SENSORS
 	tsOutputChannels->baroPressure = hasBaroSensor() ? getBaroPressure() : 0;
 #endif /* EFI_ANALOG_SENSORS */
+	// 148
+	tsOutputChannels->fuelTankLevel = engine->sensors.fuelTankLevel;
+	// 280
+	tsOutputChannels->oilPressure = Sensor::get(SensorType::OilPressure).Value;
+
+#if	HAL_USE_ADC
+	tsOutputChannels->internalMcuTemperature = getMCUInternalTemperature();
+#endif /* HAL_USE_ADC */
+
+#if EFI_MAX_31855
+	for (int i = 0; i < EGT_CHANNEL_COUNT; i++)
+		tsOutputChannels->egtValues.values[i] = getEgtValue(i);
+#endif /* EFI_MAX_31855 */
+}
+
+static void updateFuelChannels(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+#if EFI_SHAFT_POSITION_INPUT
+	int rpm = GET_RPM();
+#else /* EFI_SHAFT_POSITION_INPUT */
+	int rpm = 0;
+#endif /* EFI_SHAFT_POSITION_INPUT */
 	// 48
 	tsOutputChannels->fuelBase = engine->engineState.baseFuel;
 	// 64
 	tsOutputChannels->actualLastInjection = ENGINE(actualLastInjection);
-
-
-	// 104
-	tsOutputChannels->rpmAcceleration = engine->rpmCalculator.getRpmAcceleration();
-	// offset 108
-	// For air-interpolated tCharge mode, we calculate a decent massAirFlow approximation, so we can show it to users even without MAF sensor!
-	tsOutputChannels->massAirFlow = getAirFlowGauge(PASS_ENGINE_PARAMETER_SIGNATURE);
-	// offset 116
-	// TPS acceleration
-	tsOutputChannels->deltaTps = engine->tpsAccelEnrichment.getMaxDelta();
-	// 128
-	tsOutputChannels->totalTriggerErrorCounter = engine->triggerCentral.triggerState.totalTriggerErrorCounter;
-	// 132
-	tsOutputChannels->orderingErrorCounter = engine->triggerCentral.triggerState.orderingErrorCounter;
 	// 68
 	tsOutputChannels->baroCorrection = engine->engineState.baroCorrection;
 	// 140
 #if EFI_ENGINE_CONTROL
 	tsOutputChannels->injectorDutyCycle = getInjectorDutyCycle(rpm PASS_ENGINE_PARAMETER_SUFFIX);
 #endif
-	// 148
-	tsOutputChannels->fuelTankLevel = engine->sensors.fuelTankLevel;
 	// 160
 	tsOutputChannels->wallFuelAmount = ENGINE(wallFuel[0]).getWallFuel();
 	// 164
@@ -785,27 +837,8 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 	tsOutputChannels->fuelRunning = ENGINE(engineState.running.fuel);
 	// 196
 	tsOutputChannels->injectorLagMs = ENGINE(engineState.running.injectorLag);
-	// 224
-	efitimesec_t timeSeconds = getTimeNowSeconds();
-	tsOutputChannels->timeSeconds = timeSeconds;
-
-#if EFI_SHAFT_POSITION_INPUT
-	// 248
-	tsOutputChannels->vvtPosition = engine->triggerCentral.getVVTPosition();
-#endif
-
-	// 252
-	tsOutputChannels->engineMode = packEngineMode(PASS_ENGINE_PARAMETER_SIGNATURE);
-	// 120
-	tsOutputChannels->firmwareVersion = getRusEfiVersion();
 	// 268
 	tsOutputChannels->fuelPidCorrection = ENGINE(engineState.running.pidCorrection);
-	// 276
-	tsOutputChannels->accelerationX = engine->sensors.accelerometer.x;
-	// 278
-	tsOutputChannels->accelerationY = engine->sensors.accelerometer.y;
-	// 280
-	tsOutputChannels->oilPressure = Sensor::get(SensorType::OilPressure).Value;
 	// 288
 	tsOutputChannels->injectionOffset = engine->engineState.injectionOffset;
 
@@ -815,19 +848,59 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 		tsOutputChannels->veValue = engine->engineState.currentBaroCorrectedVE * PERCENT_MULT;
 		// todo: bug here? target afr could work based on real MAF?
 		tsOutputChannels->currentTargetAfr = afrMap.getValue(rpm, mapValue);
-		// offset 40
-		tsOutputChannels->manifoldAirPressure = mapValue;
+		// engine load acceleration
+		tsOutputChannels->engineLoadAccelExtra = engine->engineLoadAccelEnrichment.getEngineLoadEnrichment(PASS_ENGINE_PARAMETER_SIGNATURE) * 100 / mapValue;
 	}
 
+	tsOutputChannels->tpsAccelFuel = engine->engineState.tpsAccelEnrich;
+
+	tsOutputChannels->fuelConsumptionPerHour = engine->engineState.fuelConsumption.perSecondConsumption;
+
+#if EFI_ENGINE_CONTROL
+	// tCharge depends on the previous state, so we should use the stored value.
+	tsOutputChannels->tCharge = ENGINE(engineState.sd.tCharge);
+	tsOutputChannels->crankingFuelMs = engine->isCylinderCleanupMode ? 0 : getCrankingFuel(PASS_ENGINE_PARAMETER_SIGNATURE);
+	tsOutputChannels->chargeAirMass = engine->engineState.sd.airMassInOneCylinder;
+#endif // EFI_ENGINE_CONTROL
+}
+
+static void updateIgnitionChannels(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+#if EFI_SHAFT_POSITION_INPUT
+	// 248
+	tsOutputChannels->vvtPosition = engine->triggerCentral.getVVTPosition();
+#endif
+
 	tsOutputChannels->knockCount = engine->knockCount;
 	tsOutputChannels->knockLevel = engine->knockVolts;
+	tsOutputChannels->knockNowIndicator = engine->knockCount > 0;
+	tsOutputChannels->knockEverIndicator = engine->knockEver;
+#if EFI_HIP_9011
+	tsOutputChannels->isKnockChipOk = (instance.invalidHip9011ResponsesCount == 0);
+#endif /* EFI_HIP_9011 */
+
+#if EFI_ENGINE_CONTROL
+	float timing = engine->engineState.timingAdvance;
+	tsOutputChannels->ignitionAdvance = timing > 360 ? timing - 720 : timing;
+	// 60
+	tsOutputChannels->sparkDwell = ENGINE(engineState.sparkDwell);
+	tsOutputChannels->coilDutyCycle = getCoilDutyCycle(GET_RPM() PASS_ENGINE_PARAMETER_SUFFIX);
+#endif // EFI_ENGINE_CONTROL
+}
+
+static void updateStatusChannels(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	// 128
+	tsOutputChannels->totalTriggerErrorCounter = engine->triggerCentral.triggerState.totalTriggerErrorCounter;
+	// 132
+	tsOutputChannels->orderingErrorCounter = engine->triggerCentral.triggerState.orderingErrorCounter;
+	// 224
+	efitimesec_t timeSeconds = getTimeNowSeconds();
+	tsOutputChannels->timeSeconds = timeSeconds;
+	// 252
+	tsOutputChannels->engineMode = packEngineMode(PASS_ENGINE_PARAMETER_SIGNATURE);
 
 	tsOutputChannels->hasCriticalError = hasFirmwareError();
 
 	tsOutputChannels->isWarnNow = engine->engineState.warnings.isWarningNow(timeSeconds, true);
-#if EFI_HIP_9011
-	tsOutputChannels->isKnockChipOk = (instance.invalidHip9011ResponsesCount == 0);
-#endif /* EFI_HIP_9011 */
 
 #if EFI_LAUNCH_CONTROL
 
@@ -838,39 +911,11 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 
 #endif
 
-	tsOutputChannels->tpsAccelFuel = engine->engineState.tpsAccelEnrich;
-	// engine load acceleration
-	if (hasMapSensor(PASS_ENGINE_PARAMETER_SIGNATURE)) {
-		tsOutputChannels->engineLoadAccelExtra = engine->engineLoadAccelEnrichment.getEngineLoadEnrichment(PASS_ENGINE_PARAMETER_SIGNATURE) * 100 / getMap(PASS_ENGINE_PARAMETER_SIGNATURE);
-	}
-	tsOutputChannels->engineLoadDelta = engine->engineLoadAccelEnrichment.getMaxDelta();
-
 	tsOutputChannels->checkEngine = hasErrorCodes();
 
-#if	HAL_USE_ADC
-	tsOutputChannels->internalMcuTemperature = getMCUInternalTemperature();
-#endif /* HAL_USE_ADC */
-
-#if EFI_MAX_31855
-	for (int i = 0; i < EGT_CHANNEL_COUNT; i++)
-		tsOutputChannels->egtValues.values[i] = getEgtValue(i);
-#endif /* EFI_MAX_31855 */
-
-#if EFI_IDLE_CONTROL
-	tsOutputChannels->idlePosition = getIdlePosition();
-#endif
-
 #if EFI_PROD_CODE
 	tsOutputChannels->isTriggerError = isTriggerErrorNow();
 
-#if EFI_INTERNAL_FLASH
-	tsOutputChannels->needBurn = getNeedToWriteConfiguration();
-#endif /* EFI_INTERNAL_FLASH */
-
-#if EFI_FILE_LOGGING
-	tsOutputChannels->hasSdCard = isSdCardAlive();
-#endif /* EFI_FILE_LOGGING */
-
 	tsOutputChannels->isFuelPumpOn = enginePins.fuelPumpRelay.getLogicValue();
 	tsOutputChannels->isFanOn = enginePins.fanRelay.getLogicValue();
 	tsOutputChannels->isO2HeaterOn = enginePins.o2heater.getLogicValue();
@@ -879,49 +924,48 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 	tsOutputChannels->isCylinderCleanupEnabled = engineConfiguration->isCylinderCleanupEnabled;
 	tsOutputChannels->isCylinderCleanupActivated = engine->isCylinderCleanupMode;
 	tsOutputChannels->secondTriggerChannelEnabled = engineConfiguration->secondTriggerChannelEnabled;
-#if EFI_VEHICLE_SPEED
-	float vehicleSpeed = getVehicleSpeed();
-	tsOutputChannels->vehicleSpeedKph = vehicleSpeed;
-	tsOutputChannels->speedToRpmRatio = vehicleSpeed / rpm;
-
-#endif /* EFI_VEHICLE_SPEED */
 #endif /* EFI_PROD_CODE */
 
-	tsOutputChannels->fuelConsumptionPerHour = engine->engineState.fuelConsumption.perSecondConsumption;
-
 	tsOutputChannels->warningCounter = engine->engineState.warnings.warningCounter;
 	tsOutputChannels->lastErrorCode = engine->engineState.warnings.lastErrorCode;
 	for (int i = 0; i < 8;i++) {
 		tsOutputChannels->recentErrorCodes[i] = engine->engineState.warnings.recentWarnings.get(i);
 	}
 
-	tsOutputChannels->knockNowIndicator = engine->knockCount > 0;
-	tsOutputChannels->knockEverIndicator = engine->knockEver;
-
 	tsOutputChannels->clutchUpState = engine->clutchUpState;
 	tsOutputChannels->clutchDownState = engine->clutchDownState;
 	tsOutputChannels->brakePedalState = engine->brakePedalState;
 	tsOutputChannels->acSwitchState = engine->acSwitchState;
+}
 
-#if EFI_ENGINE_CONTROL
-	// tCharge depends on the previous state, so we should use the stored value.
-	tsOutputChannels->tCharge = ENGINE(engineState.sd.tCharge);
-	float timing = engine->engineState.timingAdvance;
-	tsOutputChannels->ignitionAdvance = timing > 360 ? timing - 720 : timing;
-	// 60
-	tsOutputChannels->sparkDwell = ENGINE(engineState.sparkDwell);
-	tsOutputChannels->crankingFuelMs = engine->isCylinderCleanupMode ? 0 : getCrankingFuel(PASS_ENGINE_PARAMETER_SIGNATURE);
-	tsOutputChannels->chargeAirMass = engine->engineState.sd.airMassInOneCylinder;
+static void updateVersionChannels(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	// header
+	tsOutputChannels->tsConfigVersion = TS_FILE_VERSION;
+	// 120
+	tsOutputChannels->firmwareVersion = getRusEfiVersion();
 
-	tsOutputChannels->coilDutyCycle = getCoilDutyCycle(rpm PASS_ENGINE_PARAMETER_SUFFIX);
-#endif // EFI_ENGINE_CONTROL
+#if EFI_PROD_CODE
+#if EFI_INTERNAL_FLASH
+	tsOutputChannels->needBurn = getNeedToWriteConfiguration();
+#endif /* EFI_INTERNAL_FLASH */
+
+#if EFI_FILE_LOGGING
+	tsOutputChannels->hasSdCard = isSdCardAlive();
+#endif /* EFI_FILE_LOGGING */
+#endif /* EFI_PROD_CODE */
+}
+
+static void updateDebugChannels(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+#if EFI_PROD_CODE
+	executorStatistics(tsOutputChannels->getDebugChannels());
+#endif /* EFI_PROD_CODE */
 
 	switch (engineConfiguration->debugMode)	{
 	case DBG_START_STOP:
 		tsOutputChannels->debugIntField1 = engine->startStopStateToggleCounter;
 		break;
 	case DBG_STATUS:
-		tsOutputChannels->debugFloatField1 = timeSeconds;
+		tsOutputChannels->debugFloatField1 = getTimeNowSeconds();
 		tsOutputChannels->debugIntField1 = atoi(VCS_VERSION);
 		break;
 	case DBG_METRICS:
@@ -966,7 +1010,6 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 	case DBG_FSIO_ADC:
 		// todo: implement a proper loop
 		if (engineConfiguration->fsioAdc[0] != EFI_ADC_NONE) {
-			strcpy(buf, "adcX");
 			tsOutputChannels->debugFloatField1 = getVoltage("fsio", engineConfiguration->fsioAdc[0] PASS_ENGINE_PARAMETER_SUFFIX);
 		}
 		break;
@@ -1043,16 +1086,112 @@ void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_
 	}
 }
 
+typedef void (*output_channel_producer_t)(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX);
+
+/**
+ * in output_channel_group_e order
+ */
+static const output_channel_producer_t outputChannelProducers[OCG_COUNT] = {
+	updateFastSensorChannels,
+	updateSlowSensorChannels,
+	updateFuelChannels,
+	updateIgnitionChannels,
+	updateStatusChannels,
+	updateVersionChannels,
+	updateDebugChannels,
+};
+
+static void updateOutputChannels(TunerStudioOutputChannels *tsOutputChannels, output_channel_subscriber_e subscriber DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	uint32_t due = outputChannelGroups.getDueGroups(subscriber, currentTimeMillis());
+	for (int i = 0; i < OCG_COUNT; i++) {
+		if ((due & (1 << i)) == 0) {
+			continue;
+		}
+		uint32_t startNt = getTimeNowLowerNt();
+		outputChannelProducers[i](tsOutputChannels PASS_ENGINE_PARAMETER_SUFFIX);
+		outputChannelGroups.onProduced(subscriber, (output_channel_group_e)i, getTimeNowLowerNt() - startNt);
+	}
+}
+
+void produceOutputChannelGroups(TunerStudioOutputChannels *channels, uint32_t groupMask) {
+	// not counted in 'ochinfo' statistics, those are about real subscribers
+	for (int i = 0; i < OCG_COUNT; i++) {
+		if ((groupMask & (1 << i)) != 0) {
+			outputChannelProducers[i](channels PASS_ENGINE_PARAMETER_SUFFIX);
+		}
+	}
+}
+
+void invalidateOutputChannelGroups(uint32_t groupMask) {
+	outputChannelGroups.invalidate(groupMask);
+}
+
+/**
+ * Only the groups TunerStudio is subscribed to and which are due are actually computed, see 'ochgroups'
+ */
+void updateTunerStudioState(TunerStudioOutputChannels *tsOutputChannels DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	updateOutputChannels(tsOutputChannels, OCS_TUNER_STUDIO PASS_ENGINE_PARAMETER_SUFFIX);
+}
+
 void prepareTunerStudioOutputs(void) {
 	// sensor state for EFI Analytics Tuner Studio
 	updateTunerStudioState(&tsOutputChannels PASS_ENGINE_PARAMETER_SUFFIX);
 }
 
+#if EFI_FILE_LOGGING
+static void prepareLogOutputs(TunerStudioOutputChannels *channels) {
+	updateOutputChannels(channels, OCS_SD_LOG PASS_ENGINE_PARAMETER_SUFFIX);
+}
+#endif /* EFI_FILE_LOGGING */
+
+static void printOutputChannelGroups(void) {
+	for (int s = 0; s < OCS_COUNT; s++) {
+		output_channel_subscriber_e subscriber = (output_channel_subscriber_e)s;
+		scheduleMsg(&logger, "output channel groups %s: %d", getOutputChannelSubscriberName(subscriber),
+				outputChannelGroups.getSubscription(subscriber));
+		for (int i = 0; i < OCG_COUNT; i++) {
+			uint32_t produced = outputChannelGroups.producedCounter[s][i];
+			if (produced == 0 && outputChannelGroups.skippedCounter[s][i] == 0) {
+				continue;
+			}
+			int averageUs = produced == 0 ? 0 : (int)NT2US(outputChannelGroups.totalDurationNt[s][i] / produced);
+			scheduleMsg(&logger, " %d %s: produced=%d skipped=%d avg=%dus max=%dus", i,
+					getOutputChannelGroupName((output_channel_group_e)i), produced,
+					outputChannelGroups.skippedCounter[s][i], averageUs,
+					(int)NT2US(outputChannelGroups.maxDurationNt[s][i]));
+		}
+	}
+	outputChannelGroups.resetStatistics();
+}
+
+/**
+ * For instance a dashboard which only shows gauges does not need status or debug groups
+ */
+static void setTunerStudioOutputChannelGroups(int groupMask) {
+	outputChannelGroups.subscribe(OCS_TUNER_STUDIO, groupMask);
+	printOutputChannelGroups();
+}
+
+static void initOutputChannelGroups(void) {
+	outputChannelGroups.setRefreshPeriod(OCG_SLOW_SENSORS, 200);
+	outputChannelGroups.setRefreshPeriod(OCG_STATUS, 100);
+	outputChannelGroups.setRefreshPeriod(OCG_VERSION, 1000);
+	outputChannelGroups.subscribe(OCS_TUNER_STUDIO, OCG_ALL);
+	outputChannelGroups.subscribe(OCS_SD_LOG, 1 << OCG_DEBUG);
+
+	addConsoleAction("ochinfo", printOutputChannelGroups);
+	addConsoleActionI("ochgroups", setTunerStudioOutputChannelGroups);
+}
+
 #endif /* EFI_TUNER_STUDIO */
 
 void initStatusLoop(void) {
 	addConsoleActionI("warn", setWarningEnabled);
 
+#if EFI_TUNER_STUDIO
+	initOutputChannelGroups();
+#endif /* EFI_TUNER_STUDIO */
+
 #if EFI_ENGINE_CONTROL
 	addConsoleActionFF("fuelinfo2", (VoidFloatFloat) showFuelInfo2);
 	addConsoleAction("fuelinfo", showFuelInfo);
@@ -15,3 +15,18 @@ void startStatusThreads(void);
 void initStatusLoop(void);
 void writeLogLine(void);
 void printOverallStatus(systime_t nowSeconds);
+
+#if EFI_TUNER_STUDIO
+#include "tunerstudio_configuration.h"
+#include "output_channel_groups.h"
+/**
+ * Runs producers of given output channel groups into given buffer regardless of subscriptions and refresh periods,
+ * see output_channel_groups_test.cpp
+ */
+void produceOutputChannelGroups(TunerStudioOutputChannels *channels, uint32_t groupMask);
+/**
+ * Groups would be recomputed on next request of every subscriber, for values which change on events rather than
+ * over time: burn, configuration change, SD card mount. Safe to invoke from any context.
+ */
+void invalidateOutputChannelGroups(uint32_t groupMask);
+#endif /* EFI_TUNER_STUDIO */
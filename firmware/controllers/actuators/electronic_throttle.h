@@ -56,6 +56,7 @@ public:
 
 	// Used to inspect the internal PID controller's state
 	const pid_state_s* getPidState() const { return &m_pid; };
+	const SeqLock* getPidLock() const { return &m_pid.stateLock; };
 
 private:
 	int m_myIndex = 0;
@@ -341,6 +341,8 @@ static percent_t automaticIdleController(float tpsPos DECLARE_ENGINE_PARAMETER_S
 
 	void IdleController::PeriodicTask() {
 		efiAssertVoid(OBD_PCM_Processor_Fault, engineConfiguration != NULL, "engineConfiguration pointer");
+		// idle_state_s fields are written all over this method and the idle controllers it invokes
+		SeqLockWriteScope scope(&engine->engineState.stateLock);
 	/*
 	 * Here we have idle logic thread - actual stepper movement is implemented in a separate
 	 * working thread,
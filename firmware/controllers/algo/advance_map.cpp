@@ -179,7 +179,7 @@ angle_t getAdvanceCorrections(int rpm DECLARE_ENGINE_PARAMETER_SUFFIX) {
 		+ engine->fsioState.fsioTimingAdjustment
 		+ engine->engineState.cltTimingCorrection
 		+ pidTimingCorrection
-		// todo: uncomment once we get usable knock   - engine->knockCount
+		// knock retard is per cylinder, see KnockTracker usage in getCylinderSparkAngle
 		;
 }
 
@@ -7,7 +7,10 @@ CONTROLLERS_ALGO_SRC_CPP = $(PROJECT_DIR)/controllers/algo/advance_map.cpp \
 	$(PROJECT_DIR)/controllers/algo/accel_enrichment.cpp \
 	$(PROJECT_DIR)/controllers/algo/launch_control.cpp \
 	$(PROJECT_DIR)/controllers/algo/engine_configuration.cpp \
+	$(PROJECT_DIR)/controllers/algo/config_dependency.cpp \
 	$(PROJECT_DIR)/controllers/algo/engine.cpp \
+	$(PROJECT_DIR)/controllers/algo/knock_tracker.cpp \
+	$(PROJECT_DIR)/controllers/algo/ve_learner.cpp \
 	$(PROJECT_DIR)/controllers/algo/engine2.cpp \
 	$(PROJECT_DIR)/controllers/gauges/lcd_menu_tree.cpp \
 	$(PROJECT_DIR)/controllers/algo/event_registry.cpp \
@@ -0,0 +1,184 @@
+/*
+ * @file config_dependency.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "config_dependency.h"
+#include "engine_configuration.h"
+
+#include <stddef.h>
+
+ConfigurationChangeTracker configChangeTracker;
+
+static Logging *logger;
+
+typedef struct {
+	uint16_t offset;
+	uint16_t size;
+	uint8_t owners;
+} config_dependency_s;
+
+#define EC_RANGE(field, owners) {offsetof(persistent_config_s, engineConfiguration) + offsetof(engine_configuration_s, field), \
+	sizeof(((engine_configuration_s *)nullptr)->field), owners}
+#define PC_RANGE(field, owners) {offsetof(persistent_config_s, field), sizeof(((persistent_config_s *)nullptr)->field), owners}
+
+/**
+ * Fields which are known to feed only some owners, sorted by offset. Everything else within engine_configuration_s
+ * is assumed to be affecting everything, see DEFAULT_ENGINE_CONFIGURATION_OWNERS. Everything after
+ * engine_configuration_s is a table or a curve which is read directly and is applied online by TunerStudio code.
+ *
+ * Bit fields cannot be listed here so they always fall into the default range - for instance
+ * useOnlyRisingEdgeForTrigger is a bit field.
+ */
+static const config_dependency_s dependencies[] = {
+	EC_RANGE(sparkDwellRpmBins, CO_NONE),
+	EC_RANGE(sparkDwellValues, CO_NONE),
+	EC_RANGE(globalTriggerAngleOffset, CO_TRIGGER),
+	EC_RANGE(ambiguousOperationMode, CO_TRIGGER),
+	EC_RANGE(trigger, CO_TRIGGER),
+	EC_RANGE(camInputs, CO_TRIGGER | CO_HARDWARE),
+	EC_RANGE(triggerSimulatorFrequency, CO_TRIGGER),
+	EC_RANGE(triggerInputPins, CO_TRIGGER | CO_HARDWARE),
+	EC_RANGE(gpioPinModes, CO_FSIO | CO_HARDWARE),
+	EC_RANGE(fsioOutputPins, CO_FSIO | CO_HARDWARE),
+	EC_RANGE(fsioFrequency, CO_FSIO | CO_HARDWARE),
+	EC_RANGE(fsio_setting, CO_FSIO),
+	EC_RANGE(fsioDigitalInputs, CO_FSIO | CO_HARDWARE),
+	EC_RANGE(boostPid, CO_CONTROLLERS),
+	EC_RANGE(fsioInputModes, CO_FSIO | CO_HARDWARE),
+	EC_RANGE(baroCorrPressureBins, CO_NONE),
+	EC_RANGE(baroCorrRpmBins, CO_NONE),
+	EC_RANGE(baroCorrTable, CO_NONE),
+	EC_RANGE(crankingTpsCoef, CO_NONE),
+	EC_RANGE(crankingTpsBins, CO_NONE),
+	EC_RANGE(alternatorControl, CO_CONTROLLERS),
+	EC_RANGE(etb, CO_CONTROLLERS),
+	EC_RANGE(idleRpmPid, CO_CONTROLLERS),
+	EC_RANGE(knockNoise, CO_NONE),
+	EC_RANGE(knockNoiseRpmBins, CO_NONE),
+	EC_RANGE(cltIdleRpmBins, CO_NONE),
+	EC_RANGE(cltIdleRpm, CO_NONE),
+	EC_RANGE(vvtOffset, CO_TRIGGER),
+	EC_RANGE(mapAccelTaperBins, CO_NONE),
+	EC_RANGE(mapAccelTaperMult, CO_NONE),
+	EC_RANGE(fsioAdc, CO_FSIO | CO_HARDWARE),
+	EC_RANGE(narrowToWideOxygenBins, CO_NONE),
+	EC_RANGE(narrowToWideOxygen, CO_NONE),
+	EC_RANGE(vvtMode, CO_TRIGGER),
+	EC_RANGE(cltTimingBins, CO_NONE),
+	EC_RANGE(cltTimingExtra, CO_NONE),
+	EC_RANGE(fuelClosedLoopPid, CO_CONTROLLERS),
+	EC_RANGE(timing_offset_cylinder, CO_NONE),
+	EC_RANGE(auxPid, CO_CONTROLLERS),
+	EC_RANGE(fsioCurve1Bins, CO_NONE),
+	EC_RANGE(fsioCurve1, CO_NONE),
+	EC_RANGE(fsioCurve2Bins, CO_NONE),
+	EC_RANGE(fsioCurve2, CO_NONE),
+	EC_RANGE(fsioCurve3Bins, CO_NONE),
+	EC_RANGE(fsioCurve3, CO_NONE),
+	EC_RANGE(fsioCurve4Bins, CO_NONE),
+	EC_RANGE(fsioCurve4, CO_NONE),
+	EC_RANGE(crankingAdvanceBins, CO_NONE),
+	EC_RANGE(crankingAdvance, CO_NONE),
+	EC_RANGE(iacCoastingBins, CO_NONE),
+	EC_RANGE(iacCoasting, CO_NONE),
+	EC_RANGE(ignitionTpsTable, CO_NONE),
+	EC_RANGE(ignitionTpsBins, CO_NONE),
+	EC_RANGE(etbBiasBins, CO_NONE),
+	EC_RANGE(etbBiasValues, CO_NONE),
+	EC_RANGE(idleTimingPid, CO_CONTROLLERS),
+	EC_RANGE(idleRpmPid2, CO_CONTROLLERS),
+	EC_RANGE(iacPidMultTable, CO_NONE),
+	EC_RANGE(iacPidMultLoadBins, CO_NONE),
+	EC_RANGE(iacPidMultRpmBins, CO_NONE),
+	PC_RANGE(fsioFormulas, CO_FSIO),
+	PC_RANGE(timingMultiplier, CO_FSIO),
+	PC_RANGE(timingAdditive, CO_FSIO),
+};
+
+#define DEFAULT_ENGINE_CONFIGURATION_OWNERS (CO_ALL)
+
+static const char *ownerNames[CONFIG_OWNER_COUNT] = {"hardware", "trigger", "fsio", "controllers"};
+
+static int getDefaultOwners(int from) {
+	return from < (int)sizeof(engine_configuration_s) ? DEFAULT_ENGINE_CONFIGURATION_OWNERS : CO_NONE;
+}
+
+int getConfigurationOwners(int offset, int size) {
+	int owners = CO_NONE;
+	int position = offset;
+	int end = offset + size;
+	for (size_t i = 0; i < efi::size(dependencies) && position < end; i++) {
+		const config_dependency_s *d = &dependencies[i];
+		int rangeEnd = d->offset + d->size;
+		if (rangeEnd <= position) {
+			continue;
+		}
+		if (d->offset >= end) {
+			break;
+		}
+		if (d->offset > position) {
+			owners |= getDefaultOwners(position);
+		}
+		owners |= d->owners;
+		position = rangeEnd;
+	}
+	if (position < end) {
+		owners |= getDefaultOwners(position);
+	}
+	return owners;
+}
+
+void ConfigurationChangeTracker::onWrite(int offset, int size) {
+	writeCounter++;
+	pendingOwners |= getConfigurationOwners(offset, size);
+}
+
+int ConfigurationChangeTracker::takePendingOwners() {
+	int result = pendingOwners;
+	pendingOwners = CO_NONE;
+	return result;
+}
+
+void ConfigurationChangeTracker::recordApply(int owners, uint32_t durationNt) {
+	lastOwners = owners;
+	if (owners == CO_NONE) {
+		skippedCounter++;
+		return;
+	}
+	for (int i = 0; i < CONFIG_OWNER_COUNT; i++) {
+		if (owners & (1 << i)) {
+			applyCounter[i]++;
+		}
+	}
+	lastDurationNt = durationNt;
+	maxDurationNt = maxI(maxDurationNt, durationNt);
+}
+
+static void showConfigurationDependencies(void) {
+	ConfigurationChangeTracker *t = &configChangeTracker;
+	scheduleMsg(logger, "config writes=%d skipped=%d last owners=%x last=%dus max=%dus", t->writeCounter,
+			t->skippedCounter, t->lastOwners, (int)NT2US(t->lastDurationNt), (int)NT2US(t->maxDurationNt));
+	for (int i = 0; i < CONFIG_OWNER_COUNT; i++) {
+		scheduleMsg(logger, "%s: %d", ownerNames[i], t->applyCounter[i]);
+	}
+}
+
+static void showConfigurationOwners(int offset, int size) {
+	scheduleMsg(logger, "offset %d size %d owners %x", offset, size, getConfigurationOwners(offset, size));
+}
+
+void initConfigurationDependencies(Logging *sharedLogger) {
+	logger = sharedLogger;
+	for (size_t i = 1; i < efi::size(dependencies); i++) {
+		if (dependencies[i].offset < dependencies[i - 1].offset + dependencies[i - 1].size) {
+			firmwareError(CUSTOM_ERR_6635, "config dependencies not sorted at %d", i);
+			return;
+		}
+	}
+	addConsoleAction("configdeps", showConfigurationDependencies);
+	addConsoleActionII("configowners", showConfigurationOwners);
+}
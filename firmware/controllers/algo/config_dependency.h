@@ -0,0 +1,72 @@
+/*
+ * @file config_dependency.h
+ *
+ * Map from configuration byte ranges to the subsystems which derive state from them. TunerStudio writes
+ * only mark affected owners as dirty, so that 'Burn' after tuning a table cell does not re-run hardware
+ * setup, trigger shape initialization or FSIO parsing.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+typedef enum {
+	CO_NONE = 0,
+	/**
+	 * applyNewHardwareSettings(), reconfigureSensors()
+	 */
+	CO_HARDWARE = 1,
+	/**
+	 * trigger shape, trigger emulator
+	 */
+	CO_TRIGGER = 2,
+	/**
+	 * FSIO formulas
+	 */
+	CO_FSIO = 4,
+	/**
+	 * PID controllers, Engine::preCalculate() and globalConfigurationVersion listeners
+	 */
+	CO_CONTROLLERS = 8,
+	CO_ALL = CO_HARDWARE | CO_TRIGGER | CO_FSIO | CO_CONTROLLERS,
+} config_owner_e;
+
+#define CONFIG_OWNER_COUNT 4
+
+/**
+ * @return bit mask of config_owner_e which depend on persistent_config_s bytes [offset, offset + size)
+ */
+int getConfigurationOwners(int offset, int size);
+
+class ConfigurationChangeTracker {
+public:
+	/**
+	 * TunerStudio thread, invoked for each working copy write
+	 */
+	void onWrite(int offset, int size);
+	/**
+	 * @return owners accumulated since previous invocation
+	 */
+	int takePendingOwners();
+	void recordApply(int owners, uint32_t durationNt);
+
+	uint32_t writeCounter = 0;
+	/**
+	 * number of changes which did not need any recompute, for instance table cells
+	 */
+	uint32_t skippedCounter = 0;
+	uint32_t applyCounter[CONFIG_OWNER_COUNT] = {0};
+	int lastOwners = CO_NONE;
+	uint32_t lastDurationNt = 0;
+	uint32_t maxDurationNt = 0;
+
+private:
+	int pendingOwners = CO_NONE;
+};
+
+extern ConfigurationChangeTracker configChangeTracker;
+
+void initConfigurationDependencies(Logging *sharedLogger);
@@ -471,6 +471,8 @@ operation_mode_e Engine::getOperationMode(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
  */
 void Engine::periodicFastCallback(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 	ScopePerf pc(PE::EnginePeriodicFastCallback);
+	// sensor timeouts and state timers within this pass all use the same timestamp
+	CachedTimeNowScope timeNow;
 
 #if EFI_MAP_AVERAGING
 	refreshMapAveragingPreCalc(PASS_ENGINE_PARAMETER_SIGNATURE);
@@ -482,6 +484,9 @@ void Engine::periodicFastCallback(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 	int rpm = GET_RPM();
 
 	ENGINE(injectionDuration) = getInjectionDuration(rpm PASS_ENGINE_PARAMETER_SUFFIX);
+
+	// now that all inputs are fresh let's give trigger ISR the angles for the next revolution
+	cyclePlanner.update(PASS_ENGINE_PARAMETER_SIGNATURE);
 #endif
 }
 
@@ -11,11 +11,15 @@
 #include "engine_state.h"
 #include "rpm_calculator.h"
 #include "event_registry.h"
+#include "cycle_plan.h"
 #include "table_helper.h"
 #include "listener_array.h"
 #include "accel_enrichment.h"
 #include "trigger_central.h"
 #include "local_version_holder.h"
+#include "knock_tracker.h"
+#include "misfire_analyzer.h"
+#include "ve_learner.h"
 
 #if EFI_SIGNAL_EXECUTOR_ONE_TIMER
 // PROD real firmware uses this implementation
@@ -24,6 +28,9 @@
 #if EFI_SIGNAL_EXECUTOR_SLEEP
 #include "signal_executor_sleep.h"
 #endif /* EFI_SIGNAL_EXECUTOR_SLEEP */
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+#include "virtual_clock_executor.h"
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
 #if EFI_UNIT_TEST
 #include "global_execution_queue.h"
 #endif /* EFI_UNIT_TEST */
@@ -56,7 +63,7 @@ public:
 
 	IEtbController *etbControllers[ETB_COUNT] = {nullptr};
 
-	cyclic_buffer<int> triggerErrorDetection;
+	static_cyclic_buffer<int, 8, 6> triggerErrorDetection;
 
 #if EFI_SHAFT_POSITION_INPUT
 	void OnTriggerStateDecodingError();
@@ -137,6 +144,9 @@ public:
 #if EFI_SIGNAL_EXECUTOR_SLEEP
 	SleepExecutor executor;
 #endif
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+	VirtualClockExecutor executor;
+#endif
 #if EFI_UNIT_TEST
 	TestExecutor executor;
 #endif
@@ -144,6 +154,7 @@ public:
 #if EFI_ENGINE_CONTROL
 	FuelSchedule injectionEvents;
 	IgnitionEventList ignitionEvents;
+	CyclePlanner cyclePlanner;
 #endif /* EFI_ENGINE_CONTROL */
 
 	WallFuel wallFuel[INJECTION_PIN_COUNT];
@@ -272,6 +283,23 @@ public:
 
 	efitimeus_t timeOfLastKnockEvent = 0;
 
+	/**
+	 * per-cylinder knock statistics and retard, only fed by knock sensing which knows the cylinder
+	 */
+	KnockTracker knockTracker;
+
+	/**
+	 * crank speed based misfire detection, configured together with ignition positions in prepareOutputSignals()
+	 */
+	MisfireAnalyzer misfireAnalyzer;
+
+#if EFI_VE_LEARNING
+	/**
+	 * closed loop VE learning, see 'velearn' console command
+	 */
+	VeLearner veLearner;
+#endif /* EFI_VE_LEARNING */
+
 	/**
 	 * are we running any kind of functional test? this affect
 	 * some areas
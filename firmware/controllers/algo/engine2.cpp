@@ -114,6 +114,7 @@ EngineState::EngineState() {
 }
 
 void EngineState::updateSlowSensors(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
+	SeqLockWriteScope scope(&stateLock);
 	// this feeds rusEfi console Live Data
 	engine->engineState.isCrankingState = ENGINE(rpmCalculator).isCranking(PASS_ENGINE_PARAMETER_SIGNATURE);
 
@@ -132,12 +133,13 @@ void EngineState::updateSlowSensors(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 
 void EngineState::periodicFastCallback(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 	ScopePerf perf(PE::EngineStatePeriodicFastCallback);
+	SeqLockWriteScope scope(&stateLock);
 
 #if EFI_ENGINE_CONTROL
 	if (!engine->slowCallBackWasInvoked) {
 		warning(CUSTOM_SLOW_NOT_INVOKED, "Slow not invoked yet");
 	}
-	efitick_t nowNt = getTimeNowNt();
+	efitick_t nowNt = getTimeNowNtCached();
 	if (ENGINE(rpmCalculator).isCranking(PASS_ENGINE_PARAMETER_SIGNATURE)) {
 		crankingTime = nowNt;
 		timeSinceCranking = 0.0f;
@@ -192,6 +194,11 @@ void EngineState::periodicFastCallback(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 			currentRawVE = interpolate3d<float, float>(tps.value_or(50), CONFIG(ignitionTpsBins), IGN_TPS_COUNT, rpm, config->veRpmBins, FUEL_RPM_COUNT, veMap.pointers);
 		} else {
 			currentRawVE = veMap.getValue(rpm, map);
+#if EFI_VE_LEARNING
+			if (ENGINE(veLearner).isApplying) {
+				currentRawVE *= ENGINE(veLearner).getCorrection(rpm, map);
+			}
+#endif /* EFI_VE_LEARNING */
 		}
 
 		// get VE from the separate table for Idle
@@ -212,7 +219,7 @@ void EngineState::updateTChargeK(int rpm, float tps DECLARE_ENGINE_PARAMETER_SUF
 #if EFI_ENGINE_CONTROL
 	float newTCharge = getTCharge(rpm, tps PASS_ENGINE_PARAMETER_SUFFIX);
 	// convert to microsecs and then to seconds
-	efitick_t curTime = getTimeNowNt();
+	efitick_t curTime = getTimeNowNtCached();
 	float secsPassed = (float)NT2US(curTime - timeSinceLastTChargeK) / 1000000.0f;
 	if (!cisnan(newTCharge)) {
 		// control the rate of change or just fill with the initial value
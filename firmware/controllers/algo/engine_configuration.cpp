@@ -30,6 +30,7 @@
 #include "speed_density.h"
 #include "advance_map.h"
 #include "sensor.h"
+#include "config_dependency.h"
 
 #include "hip9011_lookup.h"
 #if EFI_MEMS
@@ -116,6 +117,7 @@
 
 #if EFI_TUNER_STUDIO
 #include "tunerstudio.h"
+#include "status_loop.h"
 #endif
 
 EXTERN_ENGINE;
@@ -182,44 +184,75 @@ extern LoggingWithStorage sharedLogger;
  * this method is NOT currently invoked on ECU start - actual user input has to happen!
  */
 void incrementGlobalConfigurationVersion(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
+	applyConfigurationChange(CO_ALL PASS_ENGINE_PARAMETER_SUFFIX);
+}
+
+/**
+ * @param owners bit mask of config_owner_e, see getConfigurationOwners()
+ */
+void applyConfigurationChange(int owners DECLARE_ENGINE_PARAMETER_SUFFIX) {
+#if EFI_TUNER_STUDIO
+	invalidateOutputChannelGroups(1 << OCG_VERSION);
+#endif /* EFI_TUNER_STUDIO */
+#ifdef EFI_ACTIVE_CONFIGURATION_IN_FLASH
+	if (isActiveConfigurationVoid) {
+		// nothing to compare with yet
+		owners = CO_ALL;
+	}
+#endif /* EFI_ACTIVE_CONFIGURATION_IN_FLASH */
+	if (owners == CO_NONE) {
+		// tables and curves are read directly, no derived state to update
+		configChangeTracker.recordApply(owners, 0);
+		return;
+	}
+	efitick_t startNt = getTimeNowNt();
 	ENGINE(globalConfigurationVersion++);
 #if EFI_DEFAILED_LOGGING
-	scheduleMsg(&sharedLogger, "set globalConfigurationVersion=%d", globalConfigurationVersion);
+	scheduleMsg(&sharedLogger, "set globalConfigurationVersion=%d owners=%x", globalConfigurationVersion, owners);
 #endif /* EFI_DEFAILED_LOGGING */
 /**
  * All these callbacks could be implemented as listeners, but these days I am saving RAM
  */
 #if EFI_PROD_CODE
-	applyNewHardwareSettings();
-	reconfigureSensors();
+	if (owners & CO_HARDWARE) {
+		applyNewHardwareSettings();
+		reconfigureSensors();
+	}
 #endif /* EFI_PROD_CODE */
-	engine->preCalculate(PASS_ENGINE_PARAMETER_SIGNATURE);
+	if (owners & CO_CONTROLLERS) {
+		engine->preCalculate(PASS_ENGINE_PARAMETER_SIGNATURE);
 #if EFI_ALTERNATOR_CONTROL
-	onConfigurationChangeAlternatorCallback(&activeConfiguration);
+		onConfigurationChangeAlternatorCallback(&activeConfiguration);
 #endif /* EFI_ALTERNATOR_CONTROL */
 
 #if EFI_BOOST_CONTROL
-	onConfigurationChangeBoostCallback(&activeConfiguration);
+		onConfigurationChangeBoostCallback(&activeConfiguration);
 #endif
 #if EFI_ELECTRONIC_THROTTLE_BODY
-	onConfigurationChangeElectronicThrottleCallback(&activeConfiguration);
+		onConfigurationChangeElectronicThrottleCallback(&activeConfiguration);
 #endif /* EFI_ELECTRONIC_THROTTLE_BODY */
 
 #if EFI_IDLE_CONTROL && ! EFI_UNIT_TEST
-	onConfigurationChangeIdleCallback(&activeConfiguration);
+		onConfigurationChangeIdleCallback(&activeConfiguration);
 #endif /* EFI_IDLE_CONTROL */
+	}
 
+	if (owners & CO_TRIGGER) {
 #if EFI_SHAFT_POSITION_INPUT
-	onConfigurationChangeTriggerCallback(PASS_ENGINE_PARAMETER_SIGNATURE);
+		onConfigurationChangeTriggerCallback(PASS_ENGINE_PARAMETER_SIGNATURE);
 #endif /* EFI_SHAFT_POSITION_INPUT */
 #if EFI_EMULATE_POSITION_SENSORS
-	onConfigurationChangeRpmEmulatorCallback(&activeConfiguration);
+		onConfigurationChangeRpmEmulatorCallback(&activeConfiguration);
 #endif /* EFI_EMULATE_POSITION_SENSORS */
+	}
 
 #if EFI_FSIO
-	onConfigurationChangeFsioCallback(&activeConfiguration PASS_ENGINE_PARAMETER_SUFFIX);
+	if (owners & CO_FSIO) {
+		onConfigurationChangeFsioCallback(&activeConfiguration PASS_ENGINE_PARAMETER_SUFFIX);
+	}
 #endif /* EFI_FSIO */
 	rememberCurrentConfiguration(PASS_ENGINE_PARAMETER_SIGNATURE);
+	configChangeTracker.recordApply(owners, getTimeNowNt() - startNt);
 }
 
 /**
@@ -48,6 +48,7 @@ void setDefaultSdCardParameters(DECLARE_CONFIG_PARAMETER_SIGNATURE);
 
 void rememberCurrentConfiguration(DECLARE_ENGINE_PARAMETER_SIGNATURE);
 void incrementGlobalConfigurationVersion(DECLARE_ENGINE_PARAMETER_SIGNATURE);
+void applyConfigurationChange(int owners DECLARE_ENGINE_PARAMETER_SUFFIX);
 
 void commonFrankensoAnalogInputs(engine_configuration_s *engineConfiguration);
 void setFrankenso0_1_joystick(engine_configuration_s *engineConfiguration);
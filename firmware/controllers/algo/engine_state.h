@@ -12,6 +12,7 @@
 #include "engine_parts.h"
 #include "pid.h"
 #include "engine_state_generated.h"
+#include "seqlock.h"
 
 #define BRAIN_PIN_COUNT (1 << sizeof(brain_pin_e))
 
@@ -89,4 +90,9 @@ public:
 #endif /* EFI_ENABLE_MOCK_ADC */
 
 	multispark_state multispark;
+
+	/**
+	 * guards engine_state2_s, held by periodic callbacks, fuel math and idle controller, see TS_GET_STRUCT
+	 */
+	SeqLock stateLock;
 };
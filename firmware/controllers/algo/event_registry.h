@@ -76,6 +76,11 @@ public:
 	 * Trigger-based scheduler maintains a linked list of all pending tooth-based events.
 	 */
 	AngleBasedEvent *nextToothEvent = nullptr;
+	/**
+	 * lower 32 bits of the timestamp of the trigger tooth which this event was scheduled by time from,
+	 * zero once consumed by latency metrics
+	 */
+	uint32_t triggerEdgeNt = 0;
 };
 
 #define MAX_OUTPUTS_FOR_IGNITION 2
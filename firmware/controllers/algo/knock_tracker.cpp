@@ -0,0 +1,99 @@
+/**
+ * @file	knock_tracker.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "knock_tracker.h"
+#include "efilib.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * statistics only follow this many recent windows so that they could track slow changes like engine warm up
+ */
+#define KNOCK_STATS_WINDOW 1000
+/**
+ * noise floor needs some history before it could be trusted, until then only configured threshold applies
+ */
+#define KNOCK_WARMUP_WINDOWS 16
+#define KNOCK_NOISE_FLOOR_ALPHA 0.05f
+#define KNOCK_THRESHOLD_SIGMA 3
+#define KNOCK_RETARD_STEP_DEG 1.5f
+
+KnockTracker::KnockTracker() {
+	reset();
+}
+
+void KnockTracker::reset() {
+	memset(static_cast<knock_state_s*>(this), 0, sizeof(knock_state_s));
+	memset(noiseCount, 0, sizeof(noiseCount));
+	memset(noiseM2, 0, sizeof(noiseM2));
+	for (int i = 0; i < KNOCK_CYLINDER_COUNT; i++) {
+		retardEndMs[i] = 0;
+	}
+}
+
+bool KnockTracker::onKnockSample(int cylinderIndex, float knockVolts, float thresholdVolts, float maxRetard, efitimems_t nowMs) {
+	if (cylinderIndex < 0 || cylinderIndex >= KNOCK_CYLINDER_COUNT) {
+		return false;
+	}
+	SeqLockWriteScope scope(&stateLock);
+	angle_t retardNow = getRetard(cylinderIndex, nowMs);
+	bool isKnock = knockVolts > getThreshold(cylinderIndex, thresholdVolts);
+
+	knockLevel[cylinderIndex] = knockVolts;
+	sampleCounter[cylinderIndex]++;
+	if (isKnock) {
+		knockCounter[cylinderIndex]++;
+		retardNow = minF(retardNow + KNOCK_RETARD_STEP_DEG, maxRetard);
+	}
+	/**
+	 * Once noise floor is known knock itself should not raise the bar for detecting knock. Until then everything
+	 * is taken, otherwise a cylinder which is noisy above configured threshold would never get a noise floor.
+	 */
+	if (!isKnock || noiseCount[cylinderIndex] < KNOCK_WARMUP_WINDOWS) {
+		updateNoise(cylinderIndex, knockVolts);
+	}
+	retard[cylinderIndex] = retardNow;
+	// single aligned store, trigger ISR sees either previous or this retard
+	retardEndMs[cylinderIndex] = nowMs + (efitimems_t)(retardNow * (1000 / KNOCK_RETARD_DECAY_DEG_PER_SECOND));
+	return isKnock;
+}
+
+void KnockTracker::updateNoise(int cylinderIndex, float knockVolts) {
+	int count = noiseCount[cylinderIndex];
+	float m2 = noiseM2[cylinderIndex];
+	if (count < KNOCK_STATS_WINDOW) {
+		count++;
+	} else {
+		// oldest windows fade out instead of being removed one by one
+		m2 -= m2 / count;
+	}
+	float delta = knockVolts - noiseMean[cylinderIndex];
+	noiseMean[cylinderIndex] += delta / count;
+	m2 += delta * (knockVolts - noiseMean[cylinderIndex]);
+
+	noiseCount[cylinderIndex] = count;
+	noiseM2[cylinderIndex] = m2;
+	noiseVariance[cylinderIndex] = count > 1 ? m2 / (count - 1) : 0;
+	noiseFloor[cylinderIndex] = count == 1 ? knockVolts :
+			noiseFloor[cylinderIndex] + KNOCK_NOISE_FLOOR_ALPHA * (knockVolts - noiseFloor[cylinderIndex]);
+}
+
+float KnockTracker::getThreshold(int cylinderIndex, float thresholdVolts) const {
+	if (noiseCount[cylinderIndex] < KNOCK_WARMUP_WINDOWS) {
+		return thresholdVolts;
+	}
+	float noiseThreshold = noiseFloor[cylinderIndex] + KNOCK_THRESHOLD_SIGMA * sqrtf(noiseVariance[cylinderIndex]);
+	return maxF(thresholdVolts, noiseThreshold);
+}
+
+angle_t KnockTracker::getRetard(int cylinderIndex, efitimems_t nowMs) const {
+	if (cylinderIndex < 0 || cylinderIndex >= KNOCK_CYLINDER_COUNT) {
+		return 0;
+	}
+	int remainingMs = (int32_t)(retardEndMs[cylinderIndex] - nowMs);
+	return remainingMs <= 0 ? 0 : remainingMs * (KNOCK_RETARD_DECAY_DEG_PER_SECOND / 1000);
+}
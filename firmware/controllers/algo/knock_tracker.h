@@ -0,0 +1,63 @@
+/**
+ * @file	knock_tracker.h
+ * @brief	Per-cylinder knock statistics and timing retard
+ *
+ * Every knock window of every cylinder updates background noise statistics of that cylinder without storing any
+ * samples: Welford running mean and variance plus an exponential moving average noise floor. A window is knock if it
+ * is above both the configured threshold and noise floor plus a few standard deviations, so that one noisy cylinder
+ * does not retard the others. Knock adds retard to that cylinder only and the retard decays with time.
+ *
+ * Everything is O(1) per window with no allocation. Retard of each cylinder is published to the trigger path as
+ * a single word, the time at which it would have decayed to zero, so getRetard() never sees retard of one update
+ * together with the timestamp of another.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "rusefi_types.h"
+#include "knock_state_generated.h"
+#include "seqlock.h"
+
+#define KNOCK_RETARD_DECAY_DEG_PER_SECOND 0.5f
+
+class KnockTracker : public knock_state_s {
+public:
+	KnockTracker();
+	void reset();
+	/**
+	 * @param thresholdVolts knock is never reported below this level
+	 * @param maxRetard retard of one cylinder does not grow beyond this, deg
+	 * @return true if this window is knock
+	 */
+	bool onKnockSample(int cylinderIndex, float knockVolts, float thresholdVolts, float maxRetard, efitimems_t nowMs);
+	/**
+	 * @return current knock threshold of given cylinder, V
+	 */
+	float getThreshold(int cylinderIndex, float thresholdVolts) const;
+	/**
+	 * @return retard of given cylinder decayed up to given time, deg
+	 */
+	angle_t getRetard(int cylinderIndex, efitimems_t nowMs) const;
+
+	/**
+	 * guards knock_state_s, see TS_GET_STRUCT
+	 */
+	SeqLock stateLock;
+private:
+	void updateNoise(int cylinderIndex, float knockVolts);
+	/**
+	 * non-knock windows taken into account so far, capped at KNOCK_STATS_WINDOW
+	 */
+	int noiseCount[KNOCK_CYLINDER_COUNT];
+	/**
+	 * Welford sum of squared differences from the mean
+	 */
+	float noiseM2[KNOCK_CYLINDER_COUNT];
+	/**
+	 * time at which retard of each cylinder decays to zero, the only field getRetard() reads
+	 */
+	volatile efitimems_t retardEndMs[KNOCK_CYLINDER_COUNT];
+};
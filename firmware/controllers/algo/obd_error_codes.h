@@ -63,6 +63,19 @@ typedef enum {
 	// error codes and so on
 	// Figure out who/change the ones that can fit in as a actual relevant user-fault code
 
+	OBD_Random_Multiple_Cylinder_Misfire = 300,
+	OBD_Cylinder_1_Misfire = 301,
+	OBD_Cylinder_2_Misfire = 302,
+	OBD_Cylinder_3_Misfire = 303,
+	OBD_Cylinder_4_Misfire = 304,
+	OBD_Cylinder_5_Misfire = 305,
+	OBD_Cylinder_6_Misfire = 306,
+	OBD_Cylinder_7_Misfire = 307,
+	OBD_Cylinder_8_Misfire = 308,
+	OBD_Cylinder_9_Misfire = 309,
+	OBD_Cylinder_10_Misfire = 310,
+	OBD_Cylinder_11_Misfire = 311,
+	OBD_Cylinder_12_Misfire = 312,
 	OBD_Barometric_Press_Circ = 2226,
 	OBD_Barometric_Press_Circ_Range_Perf = 2227,
 	CUSTOM_UNEXPECTED_TDC_ANGLE = 6546, // assertAngleRange(tdcPosition, "tdcPos#a1" (Trigger_structure)
@@ -0,0 +1,251 @@
+/**
+ * @file	ve_learner.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "ve_learner.h"
+#include "interpolation.h"
+#include "efilib.h"
+#include <string.h>
+
+#if EFI_VE_LEARNING
+
+/**
+ * lambda lags fueling by a few cycles, while load or rpm move faster than this per sample the ratio is not
+ * about current operating point
+ */
+#define VE_LEARN_MAX_CHANGE 0.05f
+/**
+ * anything further off is a sensor issue rather than VE error
+ */
+#define VE_LEARN_MIN_RATIO 0.5f
+#define VE_LEARN_MAX_RATIO 1.5f
+/**
+ * cells which are this far from current point do not learn anything
+ */
+#define VE_LEARN_MIN_CELL_WEIGHT 0.01f
+
+VeLearner::VeLearner() {
+	// too early for locking
+	for (int l = 0; l < FUEL_LOAD_COUNT; l++) {
+		for (int r = 0; r < FUEL_RPM_COUNT; r++) {
+			clearCell(&cells[l][r]);
+		}
+	}
+}
+
+void VeLearner::init(const float *loadBins, const float *rpmBins) {
+	this->loadBins = loadBins;
+	this->rpmBins = rpmBins;
+	reset();
+}
+
+void VeLearner::clearCell(ve_learn_cell_s *cell) {
+	cell->weight = 0;
+	cell->mean = 1;
+	cell->m2 = 0;
+	cell->sampleCount = 0;
+}
+
+void VeLearner::reset() {
+	for (int l = 0; l < FUEL_LOAD_COUNT; l++) {
+		for (int r = 0; r < FUEL_RPM_COUNT; r++) {
+			// one cell at a time so that trigger ISR is not delayed by the whole table
+			bool alreadyLocked = lockAnyContext();
+			clearCell(&cells[l][r]);
+			if (!alreadyLocked) {
+				unlockAnyContext();
+			}
+		}
+	}
+	sampleCounter = 0;
+	transientCounter = 0;
+	previousRpm = 0;
+	previousLoad = 0;
+}
+
+void VeLearner::locate(float value, const float *bins, int size, int *index, float *fraction) const {
+	int i = findIndexMsg("veLearn", bins, size, value);
+	if (i < 0) {
+		*index = 0;
+		*fraction = 0;
+	} else if (i >= size - 1) {
+		*index = size - 2;
+		*fraction = 1;
+	} else {
+		*index = i;
+		*fraction = clampF(0, (value - bins[i]) / (bins[i + 1] - bins[i]), 1);
+	}
+}
+
+bool VeLearner::addSample(float rpm, float load, float measuredAfr, float targetAfr) {
+	if (!isLearning || loadBins == nullptr || cisnan(rpm) || cisnan(load) || targetAfr <= 0) {
+		return false;
+	}
+	bool isTransient = absF(rpm - previousRpm) > VE_LEARN_MAX_CHANGE * rpm
+			|| absF(load - previousLoad) > VE_LEARN_MAX_CHANGE * load;
+	previousRpm = rpm;
+	previousLoad = load;
+	if (isTransient) {
+		transientCounter++;
+		return false;
+	}
+	float ratio = measuredAfr / targetAfr;
+	if (cisnan(ratio) || ratio < VE_LEARN_MIN_RATIO || ratio > VE_LEARN_MAX_RATIO) {
+		return false;
+	}
+	if (isApplying) {
+		// VE we have actually used already had current correction multiplied in
+		ratio *= getCorrection(rpm, load);
+	}
+
+	int l, r;
+	float loadFraction, rpmFraction;
+	locate(load, loadBins, FUEL_LOAD_COUNT, &l, &loadFraction);
+	locate(rpm, rpmBins, FUEL_RPM_COUNT, &r, &rpmFraction);
+	addToCell(l, r, (1 - loadFraction) * (1 - rpmFraction), ratio);
+	addToCell(l, r + 1, (1 - loadFraction) * rpmFraction, ratio);
+	addToCell(l + 1, r, loadFraction * (1 - rpmFraction), ratio);
+	addToCell(l + 1, r + 1, loadFraction * rpmFraction, ratio);
+	sampleCounter++;
+	return true;
+}
+
+void VeLearner::addToCell(int loadIndex, int rpmIndex, float weight, float ratio) {
+	if (weight < VE_LEARN_MIN_CELL_WEIGHT) {
+		return;
+	}
+	ve_learn_cell_s *cell = &cells[loadIndex][rpmIndex];
+	float total = cell->weight + weight;
+	if (total > VE_LEARN_MAX_WEIGHT) {
+		// older samples are forgotten proportionally to make room for the new one
+		cell->m2 *= (VE_LEARN_MAX_WEIGHT - weight) / cell->weight;
+		total = VE_LEARN_MAX_WEIGHT;
+	}
+	// West's weighted incremental mean and variance
+	float delta = ratio - cell->mean;
+	cell->mean += delta * weight / total;
+	cell->m2 += weight * delta * (ratio - cell->mean);
+	cell->weight = total;
+	cell->sampleCount++;
+}
+
+float VeLearner::getCellCorrection(int loadIndex, int rpmIndex) const {
+	const ve_learn_cell_s *cell = &cells[loadIndex][rpmIndex];
+	float confidence = minF(1, cell->weight / VE_LEARN_CONFIDENT_WEIGHT);
+	return 1 + (cell->mean - 1) * confidence;
+}
+
+const ve_learn_cell_s *VeLearner::getCell(int loadIndex, int rpmIndex) const {
+	return &cells[loadIndex][rpmIndex];
+}
+
+float VeLearner::getCorrection(float rpm, float load) const {
+	if (loadBins == nullptr || cisnan(rpm) || cisnan(load)) {
+		return 1;
+	}
+	int l, r;
+	float loadFraction, rpmFraction;
+	locate(load, loadBins, FUEL_LOAD_COUNT, &l, &loadFraction);
+	locate(rpm, rpmBins, FUEL_RPM_COUNT, &r, &rpmFraction);
+	float low = getCellCorrection(l, r) * (1 - rpmFraction) + getCellCorrection(l, r + 1) * rpmFraction;
+	float high = getCellCorrection(l + 1, r) * (1 - rpmFraction) + getCellCorrection(l + 1, r + 1) * rpmFraction;
+	return low * (1 - loadFraction) + high * loadFraction;
+}
+
+int VeLearner::commit(fuel_table_t veTable) {
+	int changedCount = 0;
+	for (int l = 0; l < FUEL_LOAD_COUNT; l++) {
+		for (int r = 0; r < FUEL_RPM_COUNT; r++) {
+			// table cell and learned cell change together, otherwise VE would have the correction twice or not at all
+			bool alreadyLocked = lockAnyContext();
+			float correction = getCellCorrection(l, r);
+			if (correction != 1) {
+				veTable[l][r] *= correction;
+				changedCount++;
+			}
+			// table now has the correction, this cell continues learning from scratch
+			clearCell(&cells[l][r]);
+			if (!alreadyLocked) {
+				unlockAnyContext();
+			}
+		}
+	}
+	sampleCounter = 0;
+	transientCounter = 0;
+	return changedCount;
+}
+
+#if EFI_ENGINE_CONTROL
+
+#include "engine.h"
+#include "engine_configuration.h"
+#include "config_dependency.h"
+#include <stddef.h>
+#if EFI_TUNER_STUDIO
+#include "tunerstudio.h"
+#endif /* EFI_TUNER_STUDIO */
+
+EXTERN_ENGINE;
+
+static Logging *logger;
+
+static void printVeLearnerInfo(void) {
+	VeLearner *learner = &ENGINE(veLearner);
+	scheduleMsg(logger, "VE learning %s, applying %s, samples=%d transient=%d", boolToString(learner->isLearning),
+			boolToString(learner->isApplying), learner->sampleCounter, learner->transientCounter);
+	for (int l = FUEL_LOAD_COUNT - 1; l >= 0; l--) {
+		int c[FUEL_RPM_COUNT];
+		for (int r = 0; r < FUEL_RPM_COUNT; r++) {
+			// percent change, rounded
+			c[r] = (int)efiRound((learner->getCellCorrection(l, r) - 1) * 100, 1);
+		}
+		scheduleMsg(logger, "%.1f: %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d", config->veLoadBins[l],
+				c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8], c[9], c[10], c[11], c[12], c[13], c[14], c[15]);
+	}
+}
+
+static void veLearnerAction(const char *value) {
+	VeLearner *learner = &ENGINE(veLearner);
+	if (strEqualCaseInsensitive(value, "start")) {
+		learner->isLearning = true;
+	} else if (strEqualCaseInsensitive(value, "stop")) {
+		learner->isLearning = false;
+	} else if (strEqualCaseInsensitive(value, "apply")) {
+		learner->isApplying = true;
+	} else if (strEqualCaseInsensitive(value, "noapply")) {
+		learner->isApplying = false;
+	} else if (strEqualCaseInsensitive(value, "reset")) {
+		learner->reset();
+	} else if (strEqualCaseInsensitive(value, "commit")) {
+		int changedCount = learner->commit(config->veTable);
+#if EFI_TUNER_STUDIO
+		// table was changed behind TunerStudio working copy, otherwise next page write or burn would undo the commit
+		syncTunerStudioCopy();
+#endif /* EFI_TUNER_STUDIO */
+		// VE table is read directly, same as a TunerStudio table edit there is nothing to recompute
+		applyConfigurationChange(getConfigurationOwners(offsetof(persistent_config_s, veTable), sizeof(config->veTable))
+				PASS_ENGINE_PARAMETER_SUFFIX);
+		scheduleMsg(logger, "VE: %d cells updated, burn to keep", changedCount);
+		return;
+	} else if (!strEqualCaseInsensitive(value, "info")) {
+		scheduleMsg(logger, "velearn start/stop/apply/noapply/commit/reset/info");
+		return;
+	}
+	printVeLearnerInfo();
+}
+
+void initVeLearner(Logging *sharedLogger DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	logger = sharedLogger;
+	ENGINE(veLearner).init(config->veLoadBins, config->veRpmBins);
+#if ! EFI_UNIT_TEST
+	addConsoleActionS("velearn", veLearnerAction);
+#endif /* ! EFI_UNIT_TEST */
+}
+
+#endif /* EFI_ENGINE_CONTROL */
+
+#endif /* EFI_VE_LEARNING */
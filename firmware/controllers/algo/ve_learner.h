@@ -0,0 +1,103 @@
+/**
+ * @file	ve_learner.h
+ * @brief	Closed loop VE table learning
+ *
+ * Every engine cycle measured AFR is compared to the target AFR, the ratio between the two is how much the VE at
+ * current operating point is off. Since fuel VE is interpolated from the four surrounding cells, the ratio is
+ * credited to those four cells with the same bilinear weights.
+ *
+ * Each cell keeps weighted running mean and variance of its ratio without storing samples. Total weight is capped so
+ * that old samples are gradually forgotten, and the weight also acts as confidence: a cell with few samples only
+ * corrects VE by a fraction of what it has learned so far.
+ *
+ * Learned corrections live in the learner only, they are multiplied into VE while applying is enabled and are only
+ * written into veTable once the user commits them. Sample and lookup are O(1), all state is static.
+ *
+ * Samples are taken from trigger ISR while reset and commit come from console thread, these two change one cell at a
+ * time with interrupts locked so that VE lookup and sampling never see a cell which is half way through.
+ *
+ * Cells take FUEL_LOAD_COUNT * FUEL_RPM_COUNT * 16 bytes of RAM, see EFI_VE_LEARNING
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+/**
+ * correction is only trusted in full once a cell has collected this much weight
+ */
+#define VE_LEARN_CONFIDENT_WEIGHT 20
+/**
+ * weight of a cell never grows beyond this, so roughly last VE_LEARN_MAX_WEIGHT samples define the correction
+ */
+#define VE_LEARN_MAX_WEIGHT 100
+
+typedef struct {
+	/**
+	 * sum of bilinear weights of all samples, capped at VE_LEARN_MAX_WEIGHT
+	 */
+	float weight;
+	/**
+	 * weighted mean of measured to target AFR ratio, 1 means VE is right
+	 */
+	float mean;
+	/**
+	 * weighted sum of squared differences from the mean
+	 */
+	float m2;
+	uint32_t sampleCount;
+} ve_learn_cell_s;
+
+class VeLearner {
+public:
+	VeLearner();
+	void init(const float *loadBins, const float *rpmBins);
+	/**
+	 * forgets everything learned so far, safe while sampling is running
+	 */
+	void reset();
+	/**
+	 * @return false if sample was not taken into account
+	 */
+	bool addSample(float rpm, float load, float measuredAfr, float targetAfr);
+	/**
+	 * @return VE multiplier at given operating point, 1 if nothing was learned
+	 */
+	float getCorrection(float rpm, float load) const;
+	float getCellCorrection(int loadIndex, int rpmIndex) const;
+	const ve_learn_cell_s *getCell(int loadIndex, int rpmIndex) const;
+	/**
+	 * Multiplies learned corrections into given table and starts learning from scratch. Each cell is moved from the
+	 * learner into the table atomically, so that VE with correction applied stays the same meanwhile.
+	 * @return number of cells changed
+	 */
+	int commit(fuel_table_t veTable);
+
+	/**
+	 * samples are only collected while this is set
+	 */
+	bool isLearning = false;
+	/**
+	 * learned corrections are only multiplied into VE while this is set
+	 */
+	bool isApplying = false;
+	uint32_t sampleCounter = 0;
+	/**
+	 * samples ignored because operating point was moving too fast for lambda to follow
+	 */
+	uint32_t transientCounter = 0;
+private:
+	void locate(float value, const float *bins, int size, int *index, float *fraction) const;
+	void addToCell(int loadIndex, int rpmIndex, float weight, float ratio);
+	void clearCell(ve_learn_cell_s *cell);
+	const float *loadBins = nullptr;
+	const float *rpmBins = nullptr;
+	float previousRpm = 0;
+	float previousLoad = 0;
+	ve_learn_cell_s cells[FUEL_LOAD_COUNT][FUEL_RPM_COUNT];
+};
+
+void initVeLearner(Logging *sharedLogger DECLARE_ENGINE_PARAMETER_SUFFIX);
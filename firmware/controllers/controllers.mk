@@ -23,6 +23,7 @@ CONTROLLERS_SRC_CPP = \
 	$(CONTROLLERS_DIR)/gauges/lcd_controller.cpp \
 	$(CONTROLLERS_DIR)/system/timer/signal_executor_sleep.cpp \
 	$(CONTROLLERS_DIR)/system/timer/single_timer_executor.cpp \
+	$(CONTROLLERS_DIR)/system/timer/virtual_clock_executor.cpp \
 	$(CONTROLLERS_DIR)/system/timer/pwm_generator_logic.cpp \
 	$(CONTROLLERS_DIR)/system/timer/event_queue.cpp \
 	$(CONTROLLERS_DIR)/settings.cpp \
@@ -30,6 +31,7 @@ CONTROLLERS_SRC_CPP = \
 	$(CONTROLLERS_DIR)/engine_cycle/map_averaging.cpp \
 	$(CONTROLLERS_DIR)/engine_cycle/rpm_calculator.cpp \
 	$(CONTROLLERS_DIR)/engine_cycle/spark_logic.cpp \
+	$(CONTROLLERS_DIR)/engine_cycle/cycle_plan.cpp \
 	$(CONTROLLERS_DIR)/engine_cycle/main_trigger_callback.cpp \
 	$(CONTROLLERS_DIR)/engine_cycle/aux_valves.cpp \
 	$(CONTROLLERS_DIR)/flash_main.cpp \
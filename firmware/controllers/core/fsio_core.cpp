@@ -448,4 +448,141 @@ LEElement *LEElementPool::parseExpression(const char * line) {
 	return first;
 }
 
+static uint32_t hashExpression(const char *line) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	while (*line != 0) {
+		hash ^= (uint8_t)*line++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @return number of space-separated tokens, which is the number of elements parseExpression would use
+ */
+static int countTokens(const char *line) {
+	int result = 0;
+	bool isInToken = false;
+	while (*line != 0) {
+		bool isSpace = *line++ == ' ';
+		if (!isSpace && !isInToken) {
+			result++;
+		}
+		isInToken = !isSpace;
+	}
+	return result;
+}
+
+LEExpressionCache::LEExpressionCache(LEElement *pool, int size) {
+	this->pool = pool;
+	this->size = size;
+	clear();
+}
+
+void LEExpressionCache::clear() {
+	used = 0;
+	memset(slices, 0, sizeof(slices));
+}
+
+LEElement *LEExpressionCache::get(int index) const {
+	efiAssert(CUSTOM_ERR_ASSERT, index >= 0 && index < LE_EXPRESSION_CACHE_SIZE, "expression index", NULL);
+	return slices[index].first;
+}
+
+int LEExpressionCache::getLiveSize() const {
+	int result = 0;
+	for (int i = 0; i < LE_EXPRESSION_CACHE_SIZE; i++) {
+		result += slices[i].count;
+	}
+	return result;
+}
+
+int LEExpressionCache::getPoolSize() const {
+	return size;
+}
+
+/**
+ * Copies slice elements to new position and re-links them. Destination is expected to be at or before current position.
+ */
+void LEExpressionCache::moveSlice(int index, int destination) {
+	int count = slices[index].count;
+	int source = slices[index].start;
+	for (int i = 0; i < count; i++) {
+		pool[destination + i] = pool[source + i];
+		pool[destination + i].next = i + 1 < count ? &pool[destination + i + 1] : nullptr;
+	}
+	slices[index].start = destination;
+	slices[index].first = count == 0 ? nullptr : &pool[destination];
+}
+
+/**
+ * Removes garbage left by changed expressions by moving all slices to the beginning of the pool
+ */
+void LEExpressionCache::compact() {
+	compactCounter++;
+	int position = 0;
+	while (true) {
+		// slices are not sorted by position, so we move them in the order of their current start
+		int next = -1;
+		for (int i = 0; i < LE_EXPRESSION_CACHE_SIZE; i++) {
+			if (slices[i].count > 0 && slices[i].start >= position && (next == -1 || slices[i].start < slices[next].start)) {
+				next = i;
+			}
+		}
+		if (next == -1) {
+			break;
+		}
+		moveSlice(next, position);
+		position += slices[next].count;
+	}
+	used = position;
+}
+
+LEElement *LEExpressionCache::update(int index, const char *line) {
+	efiAssert(CUSTOM_ERR_ASSERT, index >= 0 && index < LE_EXPRESSION_CACHE_SIZE, "expression index", NULL);
+	uint32_t hash = hashExpression(line);
+	if (slices[index].isParsed && slices[index].hash == hash) {
+		skippedCounter++;
+		return slices[index].first;
+	}
+
+	uint32_t startNt = getTimeNowLowerNt();
+	parseCounter++;
+
+	int tokenCount = countTokens(line);
+	if (tokenCount > size - used) {
+		// previous form of this expression is about to be replaced, no need to keep it
+		slices[index].first = nullptr;
+		slices[index].count = 0;
+		compact();
+	}
+
+	// new form is parsed into the free tail of the pool
+	LEElementPool tail(pool + used, size - used);
+	LEElement *first = tail.parseExpression(line);
+	int count = first == nullptr ? 0 : tail.getSize();
+
+	slices[index].hash = hash;
+	slices[index].isParsed = true;
+	if (count <= slices[index].count) {
+		// new form fits into the previous slice
+		int oldStart = slices[index].start;
+		slices[index].start = used;
+		slices[index].count = count;
+		moveSlice(index, oldStart);
+	} else {
+		slices[index].start = used;
+		slices[index].count = count;
+		slices[index].first = first;
+		used += count;
+	}
+
+	lastParseDurationNt = getTimeNowLowerNt() - startNt;
+	if (lastParseDurationNt > maxParseDurationNt) {
+		maxParseDurationNt = lastParseDurationNt;
+	}
+	return slices[index].first;
+}
+
 #endif /* EFI_FSIO */
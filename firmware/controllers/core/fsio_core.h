@@ -91,6 +91,54 @@ private:
 	int size;
 };
 
+#define LE_EXPRESSION_CACHE_SIZE FSIO_COMMAND_COUNT
+
+/**
+ * Keeps parsed form of a fixed set of expressions, each expression in its own contiguous slice of one element pool.
+ * Expression text is hashed so that only expressions which were actually changed are parsed again, without
+ * any dynamic allocation.
+ */
+class LEExpressionCache {
+public:
+	LEExpressionCache(LEElement *pool, int size);
+	/**
+	 * @return parsed expression, NULL if expression is empty or could not be parsed
+	 */
+	LEElement *update(int index, const char *line);
+	LEElement *get(int index) const;
+	void clear();
+	/**
+	 * @return number of elements used by currently parsed expressions
+	 */
+	int getLiveSize() const;
+	int getPoolSize() const;
+
+	int parseCounter = 0;
+	int skippedCounter = 0;
+	int compactCounter = 0;
+	/**
+	 * duration of most recent update() which had to parse, in NT
+	 */
+	uint32_t lastParseDurationNt = 0;
+	uint32_t maxParseDurationNt = 0;
+private:
+	void compact();
+	void moveSlice(int index, int destination);
+	LEElement *pool;
+	int size;
+	/**
+	 * pool elements in [0, used) belong to slices or are garbage left by changed expressions
+	 */
+	int used;
+	struct {
+		LEElement *first;
+		int start;
+		int count;
+		uint32_t hash;
+		bool isParsed;
+	} slices[LE_EXPRESSION_CACHE_SIZE];
+};
+
 
 #define MAX_STACK_DEPTH 32
 
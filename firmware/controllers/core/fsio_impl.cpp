@@ -85,18 +85,10 @@ static LEElement sysElements[SYS_ELEMENT_POOL_SIZE] CCM_OPTIONAL;
 LEElementPool sysPool(sysElements, SYS_ELEMENT_POOL_SIZE);
 
 static LEElement userElements[UD_ELEMENT_POOL_SIZE] CCM_OPTIONAL;
-LEElementPool userPool(userElements, UD_ELEMENT_POOL_SIZE);
-
-class FsioPointers {
-public:
-	FsioPointers();
-	LEElement * fsioLogics[FSIO_COMMAND_COUNT];
-};
-
-FsioPointers::FsioPointers() : fsioLogics() {
-}
-
-static FsioPointers state;
+/**
+ * user-defined formulas are only parsed again once their text is changed
+ */
+static LEExpressionCache userExpressions(userElements, UD_ELEMENT_POOL_SIZE);
 
 static LEElement * acRelayLogic;
 static LEElement * fuelPumpLogic;
@@ -257,16 +249,13 @@ void setFsio(int index, brain_pin_e pin, const char * exp DECLARE_CONFIG_PARAMET
 }
 
 void applyFsioConfiguration(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
-	userPool.reset();
 	for (int i = 0; i < FSIO_COMMAND_COUNT; i++) {
 		const char *formula = config->fsioFormulas[i];
-		LEElement *logic = userPool.parseExpression(formula);
+		LEElement *logic = userExpressions.update(i, formula);
 		brain_pin_e brainPin = CONFIG(fsioOutputPins)[i];
 		if (brainPin != GPIO_UNASSIGNED && logic == NULL) {
 			warning(CUSTOM_FSIO_PARSING, "parsing [%s]", formula);
 		}
-
-		state.fsioLogics[i] = logic;
 	}
 }
 
@@ -321,11 +310,11 @@ static const char *getGpioPinName(int index) {
 }
 
 float getFsioOutputValue(int index DECLARE_ENGINE_PARAMETER_SUFFIX) {
-	if (state.fsioLogics[index] == NULL) {
+	if (userExpressions.get(index) == NULL) {
 		warning(CUSTOM_NO_FSIO, "no FSIO for #%d %s", index + 1, hwPortname(CONFIG(fsioOutputPins)[index]));
 		return NAN;
 	} else {
-		return calc.getValue2(engine->fsioState.fsioLastValue[index], state.fsioLogics[index] PASS_ENGINE_PARAMETER_SUFFIX);
+		return calc.getValue2(engine->fsioState.fsioLastValue[index], userExpressions.get(index) PASS_ENGINE_PARAMETER_SUFFIX);
 	}
 }
 
@@ -425,7 +414,7 @@ static void setFsioFrequency(int index, int frequency) {
  * @return 'true' if value has changed
  */
 static bool updateValueOrWarning(int fsioIndex, const char *msg, float *value DECLARE_ENGINE_PARAMETER_SUFFIX) {
-	LEElement * element = state.fsioLogics[fsioIndex];
+	LEElement * element = userExpressions.get(fsioIndex);
 	if (element == NULL) {
 		warning(CUSTOM_FSIO_INVALID_EXPRESSION, "invalid expression for %s", msg);
 		return false;
@@ -549,7 +538,10 @@ static void showFsio(const char *msg, LEElement *element) {
 
 static void showFsioInfo(void) {
 #if EFI_PROD_CODE || EFI_SIMULATOR
-	scheduleMsg(logger, "sys used %d/user used %d", sysPool.getSize(), userPool.getSize());
+	scheduleMsg(logger, "sys used %d/user used %d of %d", sysPool.getSize(), userExpressions.getLiveSize(), userExpressions.getPoolSize());
+	scheduleMsg(logger, "user parsed %d/skipped %d/compacted %d last %dus max %dus", userExpressions.parseCounter,
+			userExpressions.skippedCounter, userExpressions.compactCounter,
+			(int)NT2US(userExpressions.lastParseDurationNt), (int)NT2US(userExpressions.maxParseDurationNt));
 	showFsio("a/c", acRelayLogic);
 	showFsio("fuel", fuelPumpLogic);
 	showFsio("fan", radiatorFanLogic);
@@ -580,7 +572,7 @@ static void showFsioInfo(void) {
 					freq, modeMessage,
 					engine->fsioState.fsioLastValue[i]);
 //			scheduleMsg(logger, "user-defined #%d value=%.2f", i, engine->engineConfigurationPtr2->fsioLastValue[i]);
-			showFsio(NULL, state.fsioLogics[i]);
+			showFsio(NULL, userExpressions.get(i));
 		}
 	}
 	for (int i = 0; i < FSIO_COMMAND_COUNT; i++) {
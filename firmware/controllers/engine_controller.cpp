@@ -57,6 +57,7 @@
 #include "gp_pwm.h"
 #include "launch_control.h"
 #include "tachometer.h"
+#include "config_dependency.h"
 
 #if EFI_SENSOR_CHART
 #include "sensor_chart.h"
@@ -421,14 +422,14 @@ static void getByte(int offset) {
 	scheduleMsg(&logger, "byte%s%d is %d", CONSOLE_DATA_PROTOCOL_TAG, offset, value);
 }
 
-static void onConfigurationChanged() {
+static void onConfigurationChanged(int offset, int size) {
 #if EFI_TUNER_STUDIO
 	// on start-up rusEfi would read from working copy of TS while
 	// we have a lot of console commands which write into real copy of configuration directly
 	// we have a bit of a mess here
 	syncTunerStudioCopy();
 #endif /* EFI_TUNER_STUDIO */
-	incrementGlobalConfigurationVersion(PASS_ENGINE_PARAMETER_SIGNATURE);
+	applyConfigurationChange(getConfigurationOwners(offset, size) PASS_ENGINE_PARAMETER_SUFFIX);
 }
 
 static void setBit(const char *offsetStr, const char *bitStr, const char *valueStr) {
@@ -456,7 +457,7 @@ static void setBit(const char *offsetStr, const char *bitStr, const char *valueS
 	 * this response is part of rusEfi console API
 	 */
 	scheduleMsg(&logger, "bit%s%d/%d is %d", CONSOLE_DATA_PROTOCOL_TAG, offset, bit, value);
-	onConfigurationChanged();
+	onConfigurationChanged(offset, sizeof(int));
 }
 
 static void setShort(const int offset, const int value) {
@@ -465,7 +466,7 @@ static void setShort(const int offset, const int value) {
 	uint16_t *ptr = (uint16_t *) (&((char *) engineConfiguration)[offset]);
 	*ptr = (uint16_t) value;
 	getShort(offset);
-	onConfigurationChanged();
+	onConfigurationChanged(offset, sizeof(uint16_t));
 }
 
 static void setByte(const int offset, const int value) {
@@ -474,7 +475,7 @@ static void setByte(const int offset, const int value) {
 	uint8_t *ptr = (uint8_t *) (&((char *) engineConfiguration)[offset]);
 	*ptr = (uint8_t) value;
 	getByte(offset);
-	onConfigurationChanged();
+	onConfigurationChanged(offset, sizeof(uint8_t));
 }
 
 static void getBit(int offset, int bit) {
@@ -505,7 +506,7 @@ static void setInt(const int offset, const int value) {
 	int *ptr = (int *) (&((char *) engineConfiguration)[offset]);
 	*ptr = value;
 	getInt(offset);
-	onConfigurationChanged();
+	onConfigurationChanged(offset, sizeof(int));
 }
 
 static void getFloat(int offset) {
@@ -535,7 +536,7 @@ static void setFloat(const char *offsetStr, const char *valueStr) {
 	float *ptr = (float *) (&((char *) engineConfiguration)[offset]);
 	*ptr = value;
 	getFloat(offset);
-	onConfigurationChanged();
+	onConfigurationChanged(offset, sizeof(float));
 }
 
 static void initConfigActions(void) {
@@ -571,6 +572,7 @@ void commonInitEngineController(Logging *sharedLogger DECLARE_ENGINE_PARAMETER_S
 
 #if !EFI_UNIT_TEST
 	initConfigActions();
+	initConfigurationDependencies(sharedLogger);
 #endif /* EFI_UNIT_TEST */
 
 #if EFI_ENGINE_CONTROL
@@ -615,6 +617,10 @@ void commonInitEngineController(Logging *sharedLogger DECLARE_ENGINE_PARAMETER_S
 
 	initAccelEnrichment(sharedLogger PASS_ENGINE_PARAMETER_SUFFIX);
 
+#if EFI_ENGINE_CONTROL && EFI_VE_LEARNING
+	initVeLearner(sharedLogger PASS_ENGINE_PARAMETER_SUFFIX);
+#endif /* EFI_ENGINE_CONTROL && EFI_VE_LEARNING */
+
 #if EFI_FSIO
 	initFsioImpl(sharedLogger PASS_ENGINE_PARAMETER_SUFFIX);
 #endif /* EFI_FSIO */
@@ -657,6 +663,7 @@ void commonInitEngineController(Logging *sharedLogger DECLARE_ENGINE_PARAMETER_S
 		 * This method adds trigger listener which actually schedules ignition
 		 */
 		initSparkLogic(sharedLogger);
+		initCyclePlanner(sharedLogger);
 		initMainEventListener(sharedLogger PASS_ENGINE_PARAMETER_SUFFIX);
 	}
 #endif /* EFI_ENGINE_CONTROL */
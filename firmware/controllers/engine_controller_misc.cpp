@@ -66,7 +66,7 @@ void setMockVBattVoltage(float voltage DECLARE_ENGINE_PARAMETER_SUFFIX) {
 #endif /* EFI_ENABLE_MOCK_ADC */
 
 #if EFI_PROD_CODE
-static Overflow64Counter halTime;
+LockFreeCounter64 halTime;
 
 /**
  * 64-bit result would not overflow, but that's complex stuff for our 32-bit MCU
@@ -77,71 +77,22 @@ efitimeus_t getTimeNowUs(void) {
 	return getTimeNowNt() / (CORE_CLOCK / 1000000);
 }
 
-//todo: macro to save method invocation
+/**
+ * Lock-free and safe from any context, see LockFreeCounter64
+ */
 efitick_t getTimeNowNt(void) {
-#if EFI_PROD_CODE
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
-	efitime_t localH = halTime.state.highBits;
-	uint32_t localLow = halTime.state.lowBits;
-
-	uint32_t value = getTimeNowLowerNt();
-
-	if (value < localLow) {
-		// new value less than previous value means there was an overflow in that 32 bit counter
-		localH += 0x100000000LL;
-	}
-
-	efitime_t result = localH + value;
-
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
-	return result;
-#else /* EFI_PROD_CODE */
-// todo: why is this implementation not used?
-	/**
-	 * this method is lock-free and thread-safe, that's because the 'update' method
-	 * is atomic with a critical zone requirement.
-	 *
-	 * http://stackoverflow.com/questions/5162673/how-to-read-two-32bit-counters-as-a-64bit-integer-without-race-condition
-	 */
-	efitime_t localH;
-	efitime_t localH2;
-	uint32_t localLow;
-	int counter = 0;
-	do {
-		localH = halTime.state.highBits;
-		localLow = halTime.state.lowBits;
-		localH2 = halTime.state.highBits;
-#if EFI_PROD_CODE
-		if (counter++ == 10000)
-			chDbgPanic("lock-free frozen");
-#endif /* EFI_PROD_CODE */
-	} while (localH != localH2);
-	/**
-	 * We need to take current counter after making a local 64 bit snapshot
-	 */
-	uint32_t value = getTimeNowLowerNt();
-
-	if (value < localLow) {
-		// new value less than previous value means there was an overflow in that 32 bit counter
-		localH += 0x100000000LL;
-	}
-
-	return localH + value;
-#endif /* EFI_PROD_CODE */
-
+	counter64_slot_s snapshot;
+	halTime.snapshot(&snapshot);
+	// hardware counter has to be read after the snapshot: older reading would be mistaken for an overflow
+	return LockFreeCounter64::extend(&snapshot, getTimeNowLowerNt());
 }
 
 void touchTimeCounter() {
 	/**
-	 * We need to push current value into the 64 bit counter often enough so that we do not miss an overflow
+	 * We need to push current value into the 64 bit counter often enough so that we do not miss an overflow.
+	 * Slow callback is the only writer so no lock is needed.
 	 */
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
-	updateAndSet(&halTime.state, getTimeNowLowerNt());
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
+	halTime.update(getTimeNowLowerNt());
 }
 
 static void onStartStopButtonToggle(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
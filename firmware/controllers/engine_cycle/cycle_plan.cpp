@@ -0,0 +1,143 @@
+/*
+ * @file cycle_plan.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "engine.h"
+#include "cycle_plan.h"
+#include "engine_math.h"
+#include "spark_logic.h"
+#include "os_util.h"
+
+EXTERN_ENGINE;
+
+static Logging *logger;
+
+#if EFI_ENGINE_CONTROL
+
+void CyclePlanner::update(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
+#if ! EFI_UNIT_TEST
+	if (isIsrContext()) {
+		/**
+		 * While spinning up trigger ISR invokes fast callback on its own and it could have preempted the thread
+		 * which is filling plans[nextIndex]. Inputs have just changed anyway so trigger path goes inline until
+		 * next thread update.
+		 */
+		invalidate();
+		return;
+	}
+#endif /* EFI_UNIT_TEST */
+	uint32_t startGeneration = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+	// this one is not visible to trigger ISR, see get()
+	CyclePlan *plan = &plans[nextIndex];
+
+	int cylindersCount = CONFIG(specs.cylindersCount);
+	plan->cylindersCount = cylindersCount;
+	plan->dwellAngle = ENGINE(engineState.dwellAngle);
+	plan->sparkDwell = ENGINE(engineState.sparkDwell);
+
+	bool isReady = cylindersCount > 0 && cylindersCount <= IGNITION_PIN_COUNT && TRIGGER_WAVEFORM(getSize()) > 0;
+
+	plan->isIgnitionReady = isReady && !cisnan(ENGINE(engineState.timingAdvance)) && !cisnan(plan->dwellAngle)
+			&& !cisnan(plan->sparkDwell);
+	for (int i = 0; plan->isIgnitionReady && i < cylindersCount; i++) {
+		angle_t sparkAngle = getCylinderSparkAngle(i PASS_ENGINE_PARAMETER_SUFFIX);
+		if (cisnan(sparkAngle)) {
+			plan->isIgnitionReady = false;
+			break;
+		}
+		plan->sparkAngle[i] = sparkAngle;
+		plan->dwellPosition[i].setAngle(sparkAngle - plan->dwellAngle PASS_ENGINE_PARAMETER_SUFFIX);
+	}
+
+	plan->isFuelReady = isReady;
+	for (int i = 0; plan->isFuelReady && i < cylindersCount; i++) {
+		angle_t angle;
+		if (!getInjectionStartAngle(i, &angle PASS_ENGINE_PARAMETER_SUFFIX)) {
+			plan->isFuelReady = false;
+			break;
+		}
+		plan->injectionStart[i].setAngle(angle PASS_ENGINE_PARAMETER_SUFFIX);
+	}
+
+	/**
+	 * generation check and publication have to be one step: invalidate() which lands in between would
+	 * otherwise be overwritten by a plan based on old trigger shape
+	 */
+	bool alreadyLocked = lockAnyContext();
+	// if trigger shape has changed while we were busy this plan is based on old shape, current stays invalidated
+	bool isPublished = generation == startGeneration;
+	if (isPublished) {
+		__atomic_store_n(&current, plan, __ATOMIC_RELEASE);
+	}
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
+	if (isPublished) {
+		nextIndex = 1 - nextIndex;
+	}
+	updateCounter++;
+}
+
+const CyclePlan *CyclePlanner::get() const {
+	return __atomic_load_n(&current, __ATOMIC_ACQUIRE);
+}
+
+void CyclePlanner::invalidate() {
+	bool alreadyLocked = lockAnyContext();
+	generation++;
+	__atomic_store_n(&current, (CyclePlan *)nullptr, __ATOMIC_RELEASE);
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
+}
+
+void CyclePlanner::checkPosition(const event_trigger_position_s *planned, const event_trigger_position_s *actual) {
+	// plan could be one fast callback behind, RPM based math moves by a fraction of a degree
+	if (planned->triggerEventIndex != actual->triggerEventIndex
+			|| absF(planned->angleOffsetFromTriggerEvent - actual->angleOffsetFromTriggerEvent) > 1) {
+		mismatchCounter++;
+	}
+}
+
+void CyclePlanner::recordDuration(bool fromPlan, uint32_t durationNt) {
+	if (fromPlan) {
+		planDurationNt = durationNt;
+		maxPlanDurationNt = maxI(maxPlanDurationNt, durationNt);
+	} else {
+		inlineDurationNt = durationNt;
+		maxInlineDurationNt = maxI(maxInlineDurationNt, durationNt);
+	}
+}
+
+static void showCyclePlanInfo(void) {
+	CyclePlanner *planner = &engine->cyclePlanner;
+	const CyclePlan *plan = planner->get();
+	scheduleMsg(logger, "cycle plan: %s updates=%d check=%s mismatches=%d", plan == nullptr ? "none" : "ready",
+			planner->updateCounter, boolToString(planner->isConsistencyCheckEnabled), planner->mismatchCounter);
+	scheduleMsg(logger, "from plan: %d events last=%dnt max=%dnt", planner->planCounter,
+			planner->planDurationNt, planner->maxPlanDurationNt);
+	scheduleMsg(logger, "inline: %d events last=%dnt max=%dnt", planner->inlineCounter,
+			planner->inlineDurationNt, planner->maxInlineDurationNt);
+}
+
+static void setCyclePlanCheck(int value) {
+	engine->cyclePlanner.isConsistencyCheckEnabled = value;
+	engine->cyclePlanner.mismatchCounter = 0;
+	engine->cyclePlanner.maxPlanDurationNt = 0;
+	engine->cyclePlanner.maxInlineDurationNt = 0;
+	showCyclePlanInfo();
+}
+
+#endif /* EFI_ENGINE_CONTROL */
+
+void initCyclePlanner(Logging *sharedLogger) {
+	logger = sharedLogger;
+#if EFI_ENGINE_CONTROL
+	addConsoleAction("cycleplan", showCyclePlanInfo);
+	addConsoleActionI("cycleplancheck", setCyclePlanCheck);
+#endif /* EFI_ENGINE_CONTROL */
+}
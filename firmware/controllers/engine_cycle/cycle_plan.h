@@ -0,0 +1,81 @@
+/*
+ * @file cycle_plan.h
+ *
+ * Ignition and fuel angles are a function of values which change at fast callback rate, not at trigger
+ * tooth rate. CyclePlanner calculates per-cylinder trigger positions from the fast callback thread so
+ * that trigger ISR only has to copy them.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+#include "globalaccess.h"
+#include "trigger_structure.h"
+
+class CyclePlan {
+public:
+	angle_t sparkAngle[IGNITION_PIN_COUNT];
+	event_trigger_position_s dwellPosition[IGNITION_PIN_COUNT];
+	event_trigger_position_s injectionStart[INJECTION_PIN_COUNT];
+	angle_t dwellAngle;
+	floatms_t sparkDwell;
+	int cylindersCount;
+	bool isIgnitionReady;
+	bool isFuelReady;
+};
+
+/**
+ * Two CyclePlan instances: one is published for trigger ISR, the other one is being filled by
+ * periodicFastCallback thread. Publishing is a single pointer store under the same lock as invalidate().
+ */
+class CyclePlanner {
+public:
+	/**
+	 * fills the plan from fast callback thread, from ISR context this only invalidates current plan
+	 */
+	void update(DECLARE_ENGINE_PARAMETER_SIGNATURE);
+	/**
+	 * @return current plan, nullptr if there is none or it was invalidated
+	 */
+	const CyclePlan *get() const;
+	/**
+	 * for instance trigger shape has changed
+	 */
+	void invalidate();
+
+	/**
+	 * if true trigger path also does the inline math and counts mismatches, see checkPosition()
+	 */
+	bool isConsistencyCheckEnabled = false;
+	uint32_t updateCounter = 0;
+	uint32_t mismatchCounter = 0;
+	/**
+	 * number of per-cylinder events which were taken from the plan or calculated inline
+	 */
+	uint32_t planCounter = 0;
+	uint32_t inlineCounter = 0;
+	/**
+	 * trigger path time of per-cylinder preparation, NT, last and max
+	 */
+	uint32_t planDurationNt = 0;
+	uint32_t maxPlanDurationNt = 0;
+	uint32_t inlineDurationNt = 0;
+	uint32_t maxInlineDurationNt = 0;
+
+	void checkPosition(const event_trigger_position_s *planned, const event_trigger_position_s *actual);
+	void recordDuration(bool fromPlan, uint32_t durationNt);
+
+private:
+	CyclePlan plans[2];
+	CyclePlan *current = nullptr;
+	int nextIndex = 0;
+	/**
+	 * incremented by invalidate() so that plan which was being prepared at that moment is not published
+	 */
+	uint32_t generation = 0;
+};
+
+void initCyclePlanner(Logging *sharedLogger);
@@ -73,16 +73,25 @@ static Pid fuelPid(&persistentState.persistentConfiguration.engineConfiguration.
 //#define RAM_METHOD_PREFIX
 //#endif
 
-void startSimultaniousInjection(Engine *engine) {
+/**
+ * all injectors change state at the same time, one register write per GPIO port
+ */
+static void fillSimultaniousInjectionGroup(Engine *engine, OutputPinGroup *group) {
 	for (int i = 0; i < engine->engineConfigurationPtr->specs.cylindersCount; i++) {
-		enginePins.injectors[i].setHigh();
+		group->add(&enginePins.injectors[i]);
 	}
 }
 
+void startSimultaniousInjection(Engine *engine) {
+	OutputPinGroup group;
+	fillSimultaniousInjectionGroup(engine, &group);
+	group.setHigh();
+}
+
 static void endSimultaniousInjectionOnlyTogglePins(Engine *engine) {
-	for (int i = 0; i < engine->engineConfigurationPtr->specs.cylindersCount; i++) {
-		enginePins.injectors[i].setLow();
-	}
+	OutputPinGroup group;
+	fillSimultaniousInjectionGroup(engine, &group);
+	group.setLow();
 }
 
 void endSimultaniousInjection(InjectionEvent *event) {
@@ -278,7 +287,13 @@ static ALWAYS_INLINE void handleFuelInjectionEvent(int injEventIndex, InjectionE
 
 static void fuelClosedLoopCorrection(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 #if ! EFI_UNIT_TEST
-	if (GET_RPM_VALUE < CONFIG(fuelClosedLoopRpmThreshold) ||
+#if EFI_VE_LEARNING
+	// VE learner has to see AFR error of the VE table itself
+	bool isVeLearning = ENGINE(veLearner).isLearning;
+#else
+	bool isVeLearning = false;
+#endif /* EFI_VE_LEARNING */
+	if (isVeLearning || GET_RPM_VALUE < CONFIG(fuelClosedLoopRpmThreshold) ||
 			Sensor::get(SensorType::Clt).value_or(0) < CONFIG(fuelClosedLoopCltThreshold) ||
 			Sensor::get(SensorType::Tps1).value_or(100) > CONFIG(fuelClosedLoopTpsThreshold) ||
 			ENGINE(sensors.currentAfr) < CONFIG(fuelClosedLoopAfrLowThreshold) ||
@@ -299,6 +314,25 @@ static void fuelClosedLoopCorrection(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 #endif
 }
 
+#if EFI_VE_LEARNING
+/**
+ * once per engine cycle, same conditions as closed loop fuel correction. Closed loop correction pulls measured AFR
+ * towards target and hides VE error from the learner, so it is held at zero while learning.
+ */
+static void veLearnerSample(int rpm DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	if (!ENGINE(veLearner).isLearning || CONFIG(fuelAlgorithm) != LM_SPEED_DENSITY || CONFIG(useTPSBasedVeTable)) {
+		return;
+	}
+	if (rpm < CONFIG(fuelClosedLoopRpmThreshold) ||
+			Sensor::get(SensorType::Clt).value_or(0) < CONFIG(fuelClosedLoopCltThreshold) ||
+			ENGINE(sensors.currentAfr) < CONFIG(fuelClosedLoopAfrLowThreshold) ||
+			ENGINE(sensors.currentAfr) > CONFIG(fuelClosedLoopAfrHighThreshold)) {
+		return;
+	}
+	ENGINE(veLearner).addSample(rpm, getMap(PASS_ENGINE_PARAMETER_SIGNATURE), ENGINE(sensors.currentAfr),
+			ENGINE(engineState.targetAFR));
+}
+#endif /* EFI_VE_LEARNING */
 
 static ALWAYS_INLINE void handleFuel(const bool limitedFuel, uint32_t trgEventIndex, int rpm, efitick_t nowNt DECLARE_ENGINE_PARAMETER_SUFFIX) {
 	ScopePerf perf(PE::HandleFuel);
@@ -431,6 +465,7 @@ static void mainTriggerCallback(trigger_event_e ckpSignalType, uint32_t trgEvent
 		if (checkIfTriggerConfigChanged(PASS_ENGINE_PARAMETER_SIGNATURE)) {
 			engine->ignitionEvents.isReady = false; // we need to rebuild complete ignition schedule
 			engine->injectionEvents.isReady = false;
+			engine->cyclePlanner.invalidate();
 			// moved 'triggerIndexByAngle' into trigger initialization (why was it invoked from here if it's only about trigger shape & optimization?)
 			// see initializeTriggerWaveform() -> prepareOutputSignals(PASS_ENGINE_PARAMETER_SIGNATURE)
 
@@ -441,6 +476,10 @@ static void mainTriggerCallback(trigger_event_e ckpSignalType, uint32_t trgEvent
 		if (CONFIG(fuelClosedLoopCorrectionEnabled)) {
 			fuelClosedLoopCorrection(PASS_ENGINE_PARAMETER_SIGNATURE);
 		}
+
+#if EFI_VE_LEARNING
+		veLearnerSample(rpm PASS_ENGINE_PARAMETER_SUFFIX);
+#endif /* EFI_VE_LEARNING */
 	}
 
 	efiAssertVoid(CUSTOM_IGN_MATH_STATE, !CONFIG(useOnlyRisingEdgeForTrigger) || CONFIG(ignMathCalculateAtIndex) % 2 == 0, "invalid ignMathCalculateAtIndex");
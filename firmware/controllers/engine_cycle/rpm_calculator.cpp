@@ -44,6 +44,46 @@ extern WaveChart waveChart;
 #define NO_RPM_EVENTS_TIMEOUT_SECS 2
 #endif /* NO_RPM_EVENTS_TIMEOUT_SECS */
 
+void AnglePredictor::reset() {
+	count = 0;
+}
+
+void AnglePredictor::onEngineCycle(efitick_t nowNt, angle_t engineCycle) {
+	if (count > 0) {
+		efitick_t periodNt = nowNt - cycleStartNt;
+		if (periodNt <= 0) {
+			reset();
+			return;
+		}
+		speed[0] = speed[1];
+		middleNt[0] = middleNt[1];
+		speed[1] = engineCycle / periodNt;
+		middleNt[1] = cycleStartNt + periodNt / 2;
+	}
+	if (count < 3) {
+		count++;
+	}
+	cycleStartNt = nowNt;
+}
+
+float AnglePredictor::getDelayNt(efitick_t edgeNt, angle_t angle) const {
+	if (count < 3) {
+		return -1;
+	}
+	float acceleration = (speed[1] - speed[0]) / (middleNt[1] - middleNt[0]);
+	float edgeSpeed = speed[1] + acceleration * (edgeNt - middleNt[1]);
+	if (edgeSpeed <= 0) {
+		return -1;
+	}
+	float discriminant = edgeSpeed * edgeSpeed + 2 * acceleration * angle;
+	if (discriminant <= 0) {
+		// decelerating so hard that we would never get there, let's hope for constant speed
+		return angle / edgeSpeed;
+	}
+	// root of angle = speed * t + acceleration * t * t / 2 which is also stable for zero acceleration
+	return 2 * angle / (edgeSpeed + sqrtf(discriminant));
+}
+
 float RpmCalculator::getRpmAcceleration() const {
 	return 1.0 * previousRpmValue / rpmValue;
 }
@@ -186,6 +226,7 @@ uint32_t RpmCalculator::getRevolutionCounterM(void) const {
 
 void RpmCalculator::setStopped(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 	revolutionCounterSinceStart = 0;
+	anglePredictor.reset();
 	if (rpmValue != 0) {
 		assignRpmValue(0 PASS_ENGINE_PARAMETER_SUFFIX);
 		scheduleMsg(logger, "engine stopped");
@@ -250,6 +291,8 @@ void rpmShaftPositionCallback(trigger_event_e ckpSignalType,
 				rpmState->setRpmValue(rpm > UNREALISTIC_RPM ? NOISY_RPM : rpm PASS_ENGINE_PARAMETER_SUFFIX);
 			}
 		}
+		rpmState->anglePredictor.onEngineCycle(nowNt,
+				getEngineCycle(engine->getOperationMode(PASS_ENGINE_PARAMETER_SIGNATURE)));
 		rpmState->onNewEngineCycle();
 		rpmState->lastRpmEventTimeNt = nowNt;
 	}
@@ -345,6 +388,13 @@ float getCrankshaftAngleNt(efitick_t timeNt DECLARE_ENGINE_PARAMETER_SUFFIX) {
 	return rpm == 0 ? NAN : timeSinceZeroAngleNt / getOneDegreeTimeNt(rpm);
 }
 
+#if ! EFI_UNIT_TEST
+static void setAnglePredictor(int value) {
+	engine->rpmCalculator.isAnglePredictorEnabled = value;
+	scheduleMsg(logger, "angle predictor %s", boolToString(value));
+}
+#endif /* EFI_UNIT_TEST */
+
 void initRpmCalculator(Logging *sharedLogger DECLARE_ENGINE_PARAMETER_SUFFIX) {
 	logger = sharedLogger;
 	if (hasFirmwareError()) {
@@ -354,6 +404,10 @@ void initRpmCalculator(Logging *sharedLogger DECLARE_ENGINE_PARAMETER_SUFFIX) {
 	addTriggerEventListener(tdcMarkCallback, "chart TDC mark", engine);
 
 	addTriggerEventListener(rpmShaftPositionCallback, "rpm reporter", engine);
+
+#if ! EFI_UNIT_TEST
+	addConsoleActionI("anglepredictor", setAnglePredictor);
+#endif /* EFI_UNIT_TEST */
 }
 
 /**
@@ -366,6 +420,17 @@ efitick_t scheduleByAngle(scheduling_s *timer, efitick_t edgeTimestamp, angle_t
 	float delayUs = ENGINE(rpmCalculator.oneDegreeUs) * angle;
 
 	efitime_t delayNt = US2NT(delayUs);
+	/**
+	 * average RPM lags behind during hard acceleration, for short angles we prefer the projection
+	 * based on two recent engine cycles
+	 */
+	if (ENGINE(rpmCalculator.isAnglePredictorEnabled) && angle > 0 && angle <= ANGLE_PREDICTOR_HORIZON) {
+		float predictedNt = ENGINE(rpmCalculator.anglePredictor).getDelayNt(edgeTimestamp, angle);
+		// sanity limit against trigger noise
+		if (predictedNt > delayNt / 2 && predictedNt < delayNt * 2) {
+			delayNt = predictedNt;
+		}
+	}
 	efitime_t delayedTime = edgeTimestamp + delayNt;
 
 	ENGINE(executor.scheduleByTimestampNt(timer, delayedTime, action));
@@ -40,6 +40,35 @@ typedef enum {
 	RUNNING,
 } spinning_state_e;
 
+/**
+ * Beyond this angle we do not trust acceleration extrapolation, it assumes acceleration is constant
+ */
+#define ANGLE_PREDICTOR_HORIZON 30
+
+/**
+ * Projects the moment crankshaft would reach given angle assuming constant angular acceleration.
+ * Speed and acceleration come from averages over whole engine cycles and not from individual tooth periods:
+ * such average does not see tooth spacing error or firing pulse ripple, and with constant acceleration it equals
+ * instant speed in the middle of the cycle.
+ */
+class AnglePredictor {
+public:
+	void reset();
+	void onEngineCycle(efitick_t nowNt, angle_t engineCycle);
+	/**
+	 * @return time from edgeNt to the moment crankshaft turns given angle past its position at edgeNt,
+	 * negative if there is not enough data
+	 */
+	float getDelayNt(efitick_t edgeNt, angle_t angle) const;
+private:
+	int count = 0;
+	efitick_t cycleStartNt = 0;
+	// average speed over two most recent engine cycles, degrees per NT, [1] is the latest
+	float speed[2];
+	// middle of each of these cycles
+	efitick_t middleNt[2];
+};
+
 class RpmCalculator {
 public:
 #if !EFI_PROD_CODE
@@ -115,6 +144,11 @@ public:
 	 * NaN while engine is not spinning
 	 */
 	volatile floatus_t oneDegreeUs = NAN;
+	AnglePredictor anglePredictor;
+	/**
+	 * see scheduleByAngle and 'perftest' angle predictor sweep
+	 */
+	bool isAnglePredictorEnabled = true;
 	volatile efitick_t lastRpmEventTimeNt = 0;
 private:
 	/**
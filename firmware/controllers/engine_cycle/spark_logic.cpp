@@ -12,6 +12,7 @@
 #include "utlist.h"
 #include "event_queue.h"
 #include "perf_trace.h"
+#include "latency_histogram.h"
 
 #if EFI_ENGINE_CONTROL
 
@@ -24,21 +25,26 @@ EXTERN_ENGINE;
 extern bool verboseMode;
 #endif /* EFI_UNIT_TEST */
 
-static cyclic_buffer<int> ignitionErrorDetection;
+static static_cyclic_buffer<int, 8, 6> ignitionErrorDetection;
 static Logging *logger;
 
 static const char *prevSparkName = nullptr;
 
+/**
+ * time from the trigger tooth which spark was scheduled from to the actual spark, in NT
+ */
+LatencyHistogram triggerToSparkLatency;
+
 int isInjectionEnabled(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 	// todo: is this worth a method? should this be inlined?
 	return CONFIG(isInjectionEnabled);
 }
 
 int isIgnitionTimingError(void) {
-	return ignitionErrorDetection.sum(6) > 4;
+	return ignitionErrorDetection.getSum() > 4;
 }
 
-static void fireSparkBySettingPinLow(IgnitionEvent *event, IgnitionOutputPin *output) {
+static void fireSparkBySettingPinLow(IgnitionEvent *event, IgnitionOutputPin *output, OutputPinGroup *group) {
 #if EFI_UNIT_TEST
 	Engine *engine = event->engine;
 #endif /* EFI_UNIT_TEST */
@@ -62,12 +68,7 @@ static void fireSparkBySettingPinLow(IgnitionEvent *event, IgnitionOutputPin *ou
 		output->outOfOrder = true;
 	}
 
-	output->setLow();
-#if EFI_PROD_CODE
-	if (CONFIG(dizzySparkOutputPin) != GPIO_UNASSIGNED) {
-		enginePins.dizzyOutput.setLow();
-	}
-#endif /* EFI_PROD_CODE */
+	group->add(output);
 }
 
 // todo: make this a class method?
@@ -77,18 +78,39 @@ static void fireSparkBySettingPinLow(IgnitionEvent *event, IgnitionOutputPin *ou
 		} \
 }
 
+/**
+ * @return spark angle within engine cycle for given cylinder
+ */
+angle_t getCylinderSparkAngle(int cylinderIndex DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	// change of sign here from 'before TDC' to 'after TDC'
+	angle_t ignitionPositionWithinEngineCycle = ENGINE(ignitionPositionWithinEngineCycle[cylinderIndex]);
+	assertAngleRange(ignitionPositionWithinEngineCycle, "aPWEC", CUSTOM_ERR_6566);
+	// this correction is usually zero (not used)
+	cfg_float_t_1f perCylinderCorrection = CONFIG(timing_offset_cylinder[cylinderIndex]);
+	angle_t knockRetard = ENGINE(knockTracker).getRetard(cylinderIndex, currentTimeMillis());
+	return -ENGINE(engineState.timingAdvance) + ignitionPositionWithinEngineCycle + perCylinderCorrection + knockRetard;
+}
+
 static void prepareCylinderIgnitionSchedule(angle_t dwellAngleDuration, floatms_t sparkDwell, IgnitionEvent *event DECLARE_ENGINE_PARAMETER_SUFFIX) {
 	// todo: clean up this implementation? does not look too nice as is.
+	uint32_t startNt = getTimeNowLowerNt();
+
+	/**
+	 * angles are normally taken from the plan prepared by fast callback thread, see CyclePlanner
+	 */
+	CyclePlanner *planner = &ENGINE(cyclePlanner);
+	const CyclePlan *plan = planner->get();
+	bool isPlanned = plan != nullptr && plan->isIgnitionReady && plan->cylindersCount == CONFIG(specs.cylindersCount);
+	if (isPlanned) {
+		dwellAngleDuration = plan->dwellAngle;
+		sparkDwell = plan->sparkDwell;
+	}
 
 	// let's save planned duration so that we can later compare it with reality
 	event->sparkDwell = sparkDwell;
 
-	// change of sign here from 'before TDC' to 'after TDC'
-	angle_t ignitionPositionWithinEngineCycle = ENGINE(ignitionPositionWithinEngineCycle[event->cylinderIndex]);
-	assertAngleRange(ignitionPositionWithinEngineCycle, "aPWEC", CUSTOM_ERR_6566);
-	// this correction is usually zero (not used)
-	cfg_float_t_1f perCylinderCorrection = CONFIG(timing_offset_cylinder[event->cylinderIndex]);
-	const angle_t sparkAngle = -ENGINE(engineState.timingAdvance) + ignitionPositionWithinEngineCycle + perCylinderCorrection;
+	const angle_t sparkAngle = isPlanned ? plan->sparkAngle[event->cylinderIndex] :
+			getCylinderSparkAngle(event->cylinderIndex PASS_ENGINE_PARAMETER_SUFFIX);
 	efiAssertVoid(CUSTOM_SPARK_ANGLE_9, !cisnan(sparkAngle), "findAngle#9");
 
 	efiAssertVoid(CUSTOM_SPARK_ANGLE_1, !cisnan(sparkAngle), "sparkAngle#1");
@@ -112,10 +134,25 @@ static void prepareCylinderIgnitionSchedule(angle_t dwellAngleDuration, floatms_
 	event->outputs[1] = secondOutput;
 	event->sparkAngle = sparkAngle;
 
-	angle_t dwellStartAngle = sparkAngle - dwellAngleDuration;
-	efiAssertVoid(CUSTOM_ERR_6590, !cisnan(dwellStartAngle), "findAngle#5");
-	assertAngleRange(dwellStartAngle, "findAngle#a6", CUSTOM_ERR_6550);
-	event->dwellPosition.setAngle(dwellStartAngle PASS_ENGINE_PARAMETER_SUFFIX);
+	if (isPlanned) {
+		event->dwellPosition = plan->dwellPosition[event->cylinderIndex];
+		planner->planCounter++;
+		planner->recordDuration(true, getTimeNowLowerNt() - startNt);
+
+		if (planner->isConsistencyCheckEnabled) {
+			event_trigger_position_s inlinePosition;
+			angle_t inlineSparkAngle = getCylinderSparkAngle(event->cylinderIndex PASS_ENGINE_PARAMETER_SUFFIX);
+			inlinePosition.setAngle(inlineSparkAngle - ENGINE(engineState.dwellAngle) PASS_ENGINE_PARAMETER_SUFFIX);
+			planner->checkPosition(&event->dwellPosition, &inlinePosition);
+		}
+	} else {
+		angle_t dwellStartAngle = sparkAngle - dwellAngleDuration;
+		efiAssertVoid(CUSTOM_ERR_6590, !cisnan(dwellStartAngle), "findAngle#5");
+		assertAngleRange(dwellStartAngle, "findAngle#a6", CUSTOM_ERR_6550);
+		event->dwellPosition.setAngle(dwellStartAngle PASS_ENGINE_PARAMETER_SUFFIX);
+		planner->inlineCounter++;
+		planner->recordDuration(false, getTimeNowLowerNt() - startNt);
+	}
 
 #if FUEL_MATH_EXTREME_LOGGING
 	printf("addIgnitionEvent %s ind=%d\n", output->name, event->dwellPosition.triggerEventIndex);
@@ -124,13 +161,30 @@ static void prepareCylinderIgnitionSchedule(angle_t dwellAngleDuration, floatms_
 }
 
 void fireSparkAndPrepareNextSchedule(IgnitionEvent *event) {
+	uint32_t triggerEdgeNt = event->sparkEvent.triggerEdgeNt;
+	if (triggerEdgeNt != 0) {
+		// multispark sparks are not scheduled from trigger, only the first one is measured
+		triggerToSparkLatency.add(getTimeNowLowerNt() - triggerEdgeNt);
+		event->sparkEvent.triggerEdgeNt = 0;
+	}
+
+	/**
+	 * wasted spark and dizzy outputs fall at the same moment, see OutputPinGroup
+	 */
+	OutputPinGroup group;
 	for (int i = 0; i< MAX_OUTPUTS_FOR_IGNITION;i++) {
 		IgnitionOutputPin *output = event->outputs[i];
 
 		if (output) {
-			fireSparkBySettingPinLow(event, output);
+			fireSparkBySettingPinLow(event, output, &group);
 		}
 	}
+#if EFI_PROD_CODE
+	if (CONFIG(dizzySparkOutputPin) != GPIO_UNASSIGNED) {
+		group.add(&enginePins.dizzyOutput);
+	}
+#endif /* EFI_PROD_CODE */
+	group.setLow();
 #if !EFI_UNIT_TEST
 if (engineConfiguration->debugMode == DBG_DWELL_METRIC) {
 #if EFI_TUNER_STUDIO
@@ -193,7 +247,7 @@ if (engineConfiguration->debugMode == DBG_DWELL_METRIC) {
 	}
 }
 
-static void startDwellByTurningSparkPinHigh(IgnitionEvent *event, IgnitionOutputPin *output) {
+static void startDwellByTurningSparkPinHigh(IgnitionEvent *event, IgnitionOutputPin *output, OutputPinGroup *group) {
 #if EFI_UNIT_TEST
 	Engine *engine = event->engine;
 	EXPAND_Engine;
@@ -225,22 +279,24 @@ static void startDwellByTurningSparkPinHigh(IgnitionEvent *event, IgnitionOutput
 		}
 	}
 
-	output->setHigh();
-#if EFI_PROD_CODE
-	if (CONFIG(dizzySparkOutputPin) != GPIO_UNASSIGNED) {
-		enginePins.dizzyOutput.setHigh();
-	}
-#endif /* EFI_PROD_CODE */
+	group->add(output);
 }
 
 void turnSparkPinHigh(IgnitionEvent *event) {
 	event->actualStartOfDwellNt = getTimeNowLowerNt();
+	OutputPinGroup group;
 	for (int i = 0; i< MAX_OUTPUTS_FOR_IGNITION;i++) {
 		IgnitionOutputPin *output = event->outputs[i];
 		if (output != NULL) {
-			startDwellByTurningSparkPinHigh(event, output);
+			startDwellByTurningSparkPinHigh(event, output, &group);
 		}
 	}
+#if EFI_PROD_CODE
+	if (CONFIG(dizzySparkOutputPin) != GPIO_UNASSIGNED) {
+		group.add(&enginePins.dizzyOutput);
+	}
+#endif /* EFI_PROD_CODE */
+	group.setHigh();
 }
 
 static bool assertNotInIgnitionList(AngleBasedEvent *head, AngleBasedEvent *element) {
@@ -270,6 +326,7 @@ bool scheduleOrQueue(AngleBasedEvent *event,
 		 * Spark should be fired before the next trigger event - time-based delay is best precision possible
 		 */
 		scheduling_s * sDown = &event->scheduling;
+		event->triggerEdgeNt = (uint32_t)edgeTimestamp;
 
 		scheduleByAngle(
 			sDown,
@@ -439,6 +496,7 @@ static void scheduleAllSparkEventsUntilNextTriggerTooth(uint32_t trgEventIndex,
 			LL_DELETE2(ENGINE(angleBasedEventsHead), current, nextToothEvent);
 
 			scheduling_s * sDown = &current->scheduling;
+			current->triggerEdgeNt = (uint32_t)edgeTimestamp;
 
 #if SPARK_EXTREME_LOGGING
 	scheduleMsg(logger, "time to invoke ind=%d %d %d", trgEventIndex, getRevolutionCounter(), (int)getTimeNowUs());
@@ -8,6 +8,9 @@
 #pragma once
 
 #include "engine.h"
+#include "latency_histogram.h"
+
+extern LatencyHistogram triggerToSparkLatency;
 
 int isInjectionEnabled(DECLARE_ENGINE_PARAMETER_SIGNATURE);
 void onTriggerEventSparkLogic(bool limitedSpark, uint32_t trgEventIndex, int rpm, efitick_t edgeTimestamp DECLARE_ENGINE_PARAMETER_SUFFIX);
@@ -17,6 +20,7 @@ void fireSparkAndPrepareNextSchedule(IgnitionEvent *event);
 int getNumberOfSparks(ignition_mode_e mode DECLARE_ENGINE_PARAMETER_SUFFIX);
 percent_t getCoilDutyCycle(int rpm DECLARE_ENGINE_PARAMETER_SUFFIX);
 void initializeIgnitionActions(DECLARE_ENGINE_PARAMETER_SIGNATURE);
+angle_t getCylinderSparkAngle(int cylinderIndex DECLARE_ENGINE_PARAMETER_SUFFIX);
 
 int isIgnitionTimingError(void);
 
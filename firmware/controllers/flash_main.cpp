@@ -21,6 +21,7 @@
 
 #if EFI_TUNER_STUDIO
 #include "tunerstudio.h"
+#include "status_loop.h"
 #endif
 
 
@@ -63,6 +64,10 @@ void writeToFlashIfPending() {
 	needToWriteConfiguration = false;
 	scheduleMsg(logger, "Writing pending configuration");
 	writeToFlashNow();
+#if EFI_TUNER_STUDIO
+	// 'needBurn' is cleared
+	invalidateOutputChannelGroups(1 << OCG_VERSION);
+#endif /* EFI_TUNER_STUDIO */
 }
 
 // Erase and write a copy of the configuration at the specified address
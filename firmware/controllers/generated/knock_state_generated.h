@@ -0,0 +1,47 @@
+// written by hand to match integration/knock_state.txt, keep both in sync until this file is produced
+// by ConfigDefinition.jar together with the other state structures
+#ifndef CONTROLLERS_GENERATED_KNOCK_STATE_GENERATED_H
+#define CONTROLLERS_GENERATED_KNOCK_STATE_GENERATED_H
+#include "rusefi_types.h"
+#define KNOCK_CYLINDER_COUNT 12
+// start of knock_state_s
+struct knock_state_s {
+	/**
+	 * Last knock sensor intensity of each cylinder, V
+	 * offset 0
+	 */
+	float knockLevel[KNOCK_CYLINDER_COUNT];
+	/**
+	 * Exponential moving average of intensity while not knocking, V
+	 * offset 48
+	 */
+	float noiseFloor[KNOCK_CYLINDER_COUNT];
+	/**
+	 * Running mean of intensity while not knocking, V
+	 * offset 96
+	 */
+	float noiseMean[KNOCK_CYLINDER_COUNT];
+	/**
+	 * Running variance of intensity while not knocking
+	 * offset 144
+	 */
+	float noiseVariance[KNOCK_CYLINDER_COUNT];
+	/**
+	 * Timing retard of each cylinder as of last knock window, deg
+	 * offset 192
+	 */
+	float retard[KNOCK_CYLINDER_COUNT];
+	/**
+	 * offset 240
+	 */
+	int knockCounter[KNOCK_CYLINDER_COUNT];
+	/**
+	 * offset 288
+	 */
+	int sampleCounter[KNOCK_CYLINDER_COUNT];
+	/** total size 336*/
+};
+
+typedef struct knock_state_s knock_state_s;
+
+#endif
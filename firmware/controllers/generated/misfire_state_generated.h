@@ -0,0 +1,49 @@
+// written by hand to match integration/misfire_state.txt, keep both in sync until this file is produced
+// by ConfigDefinition.jar together with the other state structures
+#ifndef CONTROLLERS_GENERATED_MISFIRE_STATE_GENERATED_H
+#define CONTROLLERS_GENERATED_MISFIRE_STATE_GENERATED_H
+#include "rusefi_types.h"
+#define MISFIRE_CYLINDER_COUNT 12
+// start of misfire_state_s
+struct misfire_state_s {
+	/**
+	 * Crank acceleration over last power stroke of each cylinder, normalized by load, rpm^2/1000
+	 * offset 0
+	 */
+	float acceleration[MISFIRE_CYLINDER_COUNT];
+	/**
+	 * Moving average of normalized acceleration relative to the middle of the engine cycle, negative for a weak cylinder
+	 * offset 48
+	 */
+	float contribution[MISFIRE_CYLINDER_COUNT];
+	/**
+	 * Misfires since start
+	 * offset 96
+	 */
+	int misfireCounter[MISFIRE_CYLINDER_COUNT];
+	/**
+	 * Misfires within last completed evaluation window
+	 * offset 144
+	 */
+	int windowMisfireCounter[MISFIRE_CYLINDER_COUNT];
+	/**
+	 * Typical normalized acceleration deviation of a healthy power stroke
+	 * offset 192
+	 */
+	float noiseLevel = (float)0;
+	/**
+	 * Analyzed engine cycles
+	 * offset 196
+	 */
+	int cycleCounter = (int)0;
+	/**
+	 * Error code reported after last evaluation window, zero if none
+	 * offset 200
+	 */
+	int lastMisfireCode = (int)0;
+	/** total size 204*/
+};
+
+typedef struct misfire_state_s misfire_state_s;
+
+#endif
@@ -114,11 +114,10 @@ void FuelSchedule::clear() {
 }
 
 /**
- * @returns false in case of error, true if success
+ * @param angle angle within engine cycle where injection for given cylinder should start
+ * @returns false if we are not ready to schedule fuel
  */
-bool FuelSchedule::addFuelEventsForCylinder(int i  DECLARE_ENGINE_PARAMETER_SUFFIX) {
-	efiAssert(CUSTOM_ERR_ASSERT, engine!=NULL, "engine is NULL", false);
-
+bool getInjectionStartAngle(int i, angle_t *angle DECLARE_ENGINE_PARAMETER_SUFFIX) {
 	floatus_t oneDegreeUs = ENGINE(rpmCalculator.oneDegreeUs); // local copy
 	if (cisnan(oneDegreeUs)) {
 		// in order to have fuel schedule we need to have current RPM
@@ -147,6 +146,44 @@ bool FuelSchedule::addFuelEventsForCylinder(int i  DECLARE_ENGINE_PARAMETER_SUFF
 	efiAssert(CUSTOM_ERR_ASSERT, !cisnan(baseAngle), "NaN baseAngle", false);
 	assertAngleRange(baseAngle, "baseAngle_r", CUSTOM_ERR_6554);
 
+	assertAngleRange(baseAngle, "addFbaseAngle", CUSTOM_ADD_BASE);
+
+	int cylindersCount = CONFIG(specs.cylindersCount);
+	if (cylindersCount < 1) {
+		warning(CUSTOM_OBD_ZERO_CYLINDER_COUNT, "temp cylindersCount %d", cylindersCount);
+		return false;
+	}
+
+	float result = baseAngle
+			+ i * ENGINE(engineCycle) / cylindersCount;
+	fixAngle(result, "addFuel#1", CUSTOM_ERR_6554);
+	*angle = result;
+	return true;
+}
+
+/**
+ * @returns false in case of error, true if success
+ */
+bool FuelSchedule::addFuelEventsForCylinder(int i  DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	efiAssert(CUSTOM_ERR_ASSERT, engine!=NULL, "engine is NULL", false);
+	uint32_t startNt = getTimeNowLowerNt();
+
+	if (cisnan(ENGINE(rpmCalculator.oneDegreeUs))) {
+		// in order to have fuel schedule we need to have current RPM
+		return false;
+	}
+
+	/**
+	 * start angle is normally taken from the plan prepared by fast callback thread, see CyclePlanner
+	 */
+	CyclePlanner *planner = &ENGINE(cyclePlanner);
+	const CyclePlan *plan = planner->get();
+	bool isPlanned = plan != nullptr && plan->isFuelReady && plan->cylindersCount == CONFIG(specs.cylindersCount);
+	angle_t angle = 0;
+	if (!isPlanned && !getInjectionStartAngle(i, &angle PASS_ENGINE_PARAMETER_SUFFIX)) {
+		return false;
+	}
+
 	int injectorIndex;
 
 	injection_mode_e mode = engine->getCurrentInjectionMode(PASS_ENGINE_PARAMETER_SIGNATURE);
@@ -165,17 +202,6 @@ bool FuelSchedule::addFuelEventsForCylinder(int i  DECLARE_ENGINE_PARAMETER_SUFF
 
 	bool isSimultanious = mode == IM_SIMULTANEOUS;
 
-	assertAngleRange(baseAngle, "addFbaseAngle", CUSTOM_ADD_BASE);
-
-	int cylindersCount = CONFIG(specs.cylindersCount);
-	if (cylindersCount < 1) {
-		warning(CUSTOM_OBD_ZERO_CYLINDER_COUNT, "temp cylindersCount %d", cylindersCount);
-		return false;
-	}
-
-	float angle = baseAngle
-			+ i * ENGINE(engineCycle) / cylindersCount;
-
 	InjectorOutputPin *secondOutput;
 	if (mode == IM_BATCH && CONFIG(twoWireBatchInjection)) {
 		/**
@@ -197,7 +223,6 @@ bool FuelSchedule::addFuelEventsForCylinder(int i  DECLARE_ENGINE_PARAMETER_SUFF
 	InjectionEvent *ev = &elements[i];
 	ev->ownIndex = i;
 	INJECT_ENGINE_REFERENCE(ev);
-	fixAngle(angle, "addFuel#1", CUSTOM_ERR_6554);
 
 	ev->outputs[0] = output;
 	ev->outputs[1] = secondOutput;
@@ -209,9 +234,23 @@ bool FuelSchedule::addFuelEventsForCylinder(int i  DECLARE_ENGINE_PARAMETER_SUFF
 		return false;
 	}
 
-	efiAssert(CUSTOM_ERR_ASSERT, !cisnan(angle), "findAngle#3", false);
-	assertAngleRange(angle, "findAngle#a33", CUSTOM_ERR_6544);
-	ev->injectionStart.setAngle(angle PASS_ENGINE_PARAMETER_SUFFIX);
+	if (isPlanned) {
+		ev->injectionStart = plan->injectionStart[i];
+		planner->planCounter++;
+		planner->recordDuration(true, getTimeNowLowerNt() - startNt);
+
+		if (planner->isConsistencyCheckEnabled && getInjectionStartAngle(i, &angle PASS_ENGINE_PARAMETER_SUFFIX)) {
+			event_trigger_position_s inlinePosition;
+			inlinePosition.setAngle(angle PASS_ENGINE_PARAMETER_SUFFIX);
+			planner->checkPosition(&ev->injectionStart, &inlinePosition);
+		}
+	} else {
+		efiAssert(CUSTOM_ERR_ASSERT, !cisnan(angle), "findAngle#3", false);
+		assertAngleRange(angle, "findAngle#a33", CUSTOM_ERR_6544);
+		ev->injectionStart.setAngle(angle PASS_ENGINE_PARAMETER_SUFFIX);
+		planner->inlineCounter++;
+		planner->recordDuration(false, getTimeNowLowerNt() - startNt);
+	}
 #if EFI_UNIT_TEST
 	printf("registerInjectionEvent angle=%.2f trgIndex=%d inj %d\r\n", angle, ev->injectionStart.triggerEventIndex, injectorIndex);
 #endif
@@ -518,6 +557,18 @@ void prepareOutputSignals(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 	prepareIgnitionPinIndices(CONFIG(ignitionMode) PASS_ENGINE_PARAMETER_SUFFIX);
 
 	TRIGGER_WAVEFORM(prepareShape());
+
+	angle_t cylinderTdc[IGNITION_PIN_COUNT];
+	int cylinderIds[IGNITION_PIN_COUNT];
+	for (int i = 0; i < CONFIG(specs.cylindersCount); i++) {
+		// engine cycle position to trigger cycle position conversion
+		angle_t tdc = ENGINE(ignitionPositionWithinEngineCycle[i]) + tdcPosition();
+		fixAngle(tdc, "misfireTdc", CUSTOM_ERR_6648);
+		cylinderTdc[i] = tdc;
+		cylinderIds[i] = getCylinderId(i PASS_ENGINE_PARAMETER_SUFFIX);
+	}
+	ENGINE(misfireAnalyzer).configure(TRIGGER_WAVEFORM(eventAngles), ENGINE(engineCycleEventCount), cylinderTdc,
+			cylinderIds, CONFIG(specs.cylindersCount), ENGINE(engineCycle));
 }
 
 void setFuelRpmBin(float from, float to DECLARE_CONFIG_PARAMETER_SUFFIX) {
@@ -45,6 +45,7 @@ floatms_t getEngineCycleDuration(int rpm DECLARE_ENGINE_PARAMETER_SUFFIX);
 float getEngineLoadT(DECLARE_ENGINE_PARAMETER_SIGNATURE);
 
 floatms_t getSparkDwell(int rpm DECLARE_ENGINE_PARAMETER_SUFFIX);
+bool getInjectionStartAngle(int cylinderIndex, angle_t *angle DECLARE_ENGINE_PARAMETER_SUFFIX);
 
 ignition_mode_e getCurrentIgnitionMode(DECLARE_ENGINE_PARAMETER_SIGNATURE);
 
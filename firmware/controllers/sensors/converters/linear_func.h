@@ -10,6 +10,19 @@ public:
 
 	SensorResult convert(float inputValue) const override;
 
+	const LinearFunc* getLinearFunc() const override {
+		return this;
+	}
+
+	// convert() split into steps so that batched conversion could run each step over many values
+	float apply(float inputValue) const {
+		return m_a * inputValue + m_b;
+	}
+
+	bool isInRange(float outputValue) const {
+		return outputValue <= m_maxOutput && outputValue >= m_minOutput;
+	}
+
 	void showInfo(Logging* logger, float testRawValue) const override;
 
 private:
@@ -3,6 +3,7 @@
 #include "sensor.h"
 
 class Logging;
+class LinearFunc;
 
 struct SensorConverter {
 	// Trying to copy a converter func by value is almost guaranteed to be a bug - disallow it
@@ -11,6 +12,15 @@ struct SensorConverter {
 	SensorConverter() = default;
 
 	virtual SensorResult convert(float raw) const = 0;
+
+	/**
+	 * @return non-null if this converter is a plain linear function which batched conversion could inline,
+	 * see AdcSubscriptionTable::update
+	 */
+	virtual const LinearFunc* getLinearFunc() const {
+		return nullptr;
+	}
+
 	virtual void showInfo(Logging* logger, float testRawValue) const {
 		// Unused base - nothing to print
 		(void)logger;
@@ -7,16 +7,6 @@ void FunctionalSensor::postRawValue(float inputValue, efitick_t timestamp) {
 		return;
 	}
 
-	m_rawValue = inputValue;
-
 	auto r = m_function->convert(inputValue);
-
-	// This has to happen so that we set the valid bit after
-	// the value is stored, to prevent the data race of reading
-	// an old invalid value
-	if (r.Valid) {
-		setValidValue(r.Value, timestamp);
-	} else {
-		invalidate();
-	}
+	postConvertedValue(inputValue, r.Valid, r.Value, timestamp);
 }
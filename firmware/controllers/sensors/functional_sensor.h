@@ -30,10 +30,30 @@ public:
 
 	void postRawValue(float inputValue, efitick_t timestamp);
 
+	/**
+	 * For callers which have already converted the raw value on their own, see AdcSubscription
+	 */
+	void postConvertedValue(float inputValue, bool isValid, float value, efitick_t timestamp) {
+		m_rawValue = inputValue;
+
+		// This has to happen so that we set the valid bit after
+		// the value is stored, to prevent the data race of reading
+		// an old invalid value
+		if (isValid) {
+			setValidValue(value, timestamp);
+		} else {
+			invalidate();
+		}
+	}
+
 	void setFunction(SensorConverter& func) {
 		m_function = &func;
 	}
 
+	const SensorConverter* getFunction() const {
+		return m_function;
+	}
+
 	float getRaw() const override final {
 		return m_rawValue;
 	}
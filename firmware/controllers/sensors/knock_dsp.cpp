@@ -0,0 +1,96 @@
+/**
+ * @file	knock_dsp.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "knock_dsp.h"
+#include <math.h>
+
+/**
+ * Bessel function zeros of a vibrating cylinder relative to first circumferential mode
+ */
+static const float modeRatios[KNOCK_DSP_BAND_COUNT] = {1.0f, 1.66f, 2.08f};
+
+#define KNOCK_DSP_WINDOW_SIZE 64
+/**
+ * window is Q15 but we only shift 11 bits away so that small amplitudes keep 4 extra bits
+ */
+#define KNOCK_DSP_WINDOW_SHIFT 11
+
+/**
+ * Hann window in Q15, looked up by relative sample position
+ */
+static const int16_t hannWindow[KNOCK_DSP_WINDOW_SIZE] = {
+	20, 177, 491, 958, 1573, 2331, 3224, 4244,
+	5381, 6624, 7961, 9379, 10864, 12403, 13980, 15580,
+	17187, 18787, 20364, 21903, 23388, 24806, 26143, 27386,
+	28523, 29543, 30436, 31194, 31809, 32276, 32590, 32747,
+	32747, 32590, 32276, 31809, 31194, 30436, 29543, 28523,
+	27386, 26143, 24806, 23388, 21903, 20364, 18787, 17187,
+	15580, 13980, 12403, 10864, 9379, 7961, 6624, 5381,
+	4244, 3224, 2331, 1573, 958, 491, 177, 20,
+};
+
+int KnockDsp::configure(float sampleRateHz, float baseFrequencyHz) {
+	bandCount = 0;
+	for (int i = 0; i < KNOCK_DSP_BAND_COUNT; i++) {
+		float frequency = baseFrequencyHz * modeRatios[i];
+		if (frequency <= 0 || frequency >= sampleRateHz / 2) {
+			// higher modes are simply not visible at this sample rate
+			break;
+		}
+		float w = 2 * M_PI * frequency / sampleRateHz;
+		bandFrequencyHz[bandCount] = frequency;
+		coeff[bandCount] = (int32_t)(2 * cosf(w) * (1 << KNOCK_DSP_COEFF_SHIFT));
+		bandAmplitude[bandCount] = 0;
+		bandCount++;
+	}
+	return bandCount;
+}
+
+float KnockDsp::process(const uint16_t *samples, int count) {
+	if (count > KNOCK_DSP_MAX_SAMPLES) {
+		count = KNOCK_DSP_MAX_SAMPLES;
+	}
+	if (count < 2 || bandCount == 0) {
+		return 0;
+	}
+
+	int32_t sum = 0;
+	for (int i = 0; i < count; i++) {
+		sum += samples[i];
+	}
+	int32_t mean = sum / count;
+
+	int32_t s1[KNOCK_DSP_BAND_COUNT] = {};
+	int32_t s2[KNOCK_DSP_BAND_COUNT] = {};
+	int32_t windowSum = 0;
+	for (int i = 0; i < count; i++) {
+		int32_t weight = hannWindow[i * KNOCK_DSP_WINDOW_SIZE / count];
+		windowSum += weight;
+		int32_t x = ((samples[i] - mean) * weight) >> KNOCK_DSP_WINDOW_SHIFT;
+		for (int b = 0; b < bandCount; b++) {
+			int32_t s0 = x + (int32_t)(((int64_t)coeff[b] * s1[b]) >> KNOCK_DSP_COEFF_SHIFT) - s2[b];
+			s2[b] = s1[b];
+			s1[b] = s0;
+		}
+	}
+
+	float result = 0;
+	for (int b = 0; b < bandCount; b++) {
+		int64_t power = (int64_t)s1[b] * s1[b] + (int64_t)s2[b] * s2[b]
+				- (((int64_t)coeff[b] * s1[b]) >> KNOCK_DSP_COEFF_SHIFT) * s2[b];
+		/**
+		 * sine of amplitude A gives |X| = A / 2 * sum(window), window sum is Q15 while samples were only
+		 * scaled by 2^(15 - KNOCK_DSP_WINDOW_SHIFT)
+		 */
+		float magnitude = sqrtf((float)(power > 0 ? power : 0));
+		bandAmplitude[b] = magnitude * (2 << KNOCK_DSP_WINDOW_SHIFT) / windowSum;
+		if (bandAmplitude[b] > result) {
+			result = bandAmplitude[b];
+		}
+	}
+	return result;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file	knock_dsp.h
+ * @brief Software knock detection: Goertzel filter bank over raw knock sensor samples
+ *
+ * Instead of an external HIP9011/TPIC8101 integrator the raw knock sensor signal is sampled by the ADC over the
+ * knock detection window and the energy is measured at the few frequencies where cylinder resonance shows up.
+ * Goertzel is one complex frequency bin per band, for three bands that is much cheaper than a full FFT.
+ *
+ * Fixed point: samples are 12 bit, coefficients are Q14, filter state is 32 bit with 64 bit products.
+ *
+ * No dependency on ChibiOS or engine configuration so that host tests and benchmark use the same code.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * first circumferential, second circumferential and first radial cylinder resonance modes
+ */
+#define KNOCK_DSP_BAND_COUNT 3
+/**
+ * longest window we process, anything beyond is ignored
+ */
+#define KNOCK_DSP_MAX_SAMPLES 512
+#define KNOCK_DSP_COEFF_SHIFT 14
+/**
+ * 21MHz ADC clock over 480 + 12 cycles per conversion, see software_knock.cpp
+ */
+#define KNOCK_SAMPLE_RATE_HZ 42683
+
+class KnockDsp {
+public:
+	/**
+	 * @param baseFrequencyHz first resonance mode, same bore based frequency HIP9011 band is tuned to, see getHIP9011Band()
+	 * @return number of bands below Nyquist frequency which would actually be measured
+	 */
+	int configure(float sampleRateHz, float baseFrequencyHz);
+	/**
+	 * @return knock intensity as the strongest band amplitude, in ADC counts
+	 */
+	float process(const uint16_t *samples, int count);
+
+	int bandCount = 0;
+	float bandFrequencyHz[KNOCK_DSP_BAND_COUNT] = {};
+	/**
+	 * amplitude of each band as measured by last process() invocation, in ADC counts
+	 */
+	float bandAmplitude[KNOCK_DSP_BAND_COUNT] = {};
+private:
+	/**
+	 * 2 * cos(w) in Q14
+	 */
+	int32_t coeff[KNOCK_DSP_BAND_COUNT] = {};
+};
@@ -10,6 +10,7 @@ CONTROLLERS_SENSORS_SRC_CPP = 	$(PROJECT_DIR)/controllers/sensors/thermistors.cp
 	$(PROJECT_DIR)/controllers/sensors/ego.cpp \
 	$(PROJECT_DIR)/controllers/sensors/maf2map.cpp \
 	$(PROJECT_DIR)/controllers/sensors/hip9011_lookup.cpp \
+	$(PROJECT_DIR)/controllers/sensors/knock_dsp.cpp \
 	$(PROJECT_DIR)/controllers/sensors/sensor.cpp \
 	$(PROJECT_DIR)/controllers/sensors/sensor_info_printing.cpp \
 	$(PROJECT_DIR)/controllers/sensors/functional_sensor.cpp \
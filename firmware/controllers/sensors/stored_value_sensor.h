@@ -37,7 +37,7 @@ public:
 			return unexpected;
 		}
 
-		if (getTimeNowNt() - m_timeoutPeriod > m_lastUpdate) {
+		if (getTimeNowNtCached() - m_timeoutPeriod > m_lastUpdate) {
 			return unexpected;
 		}
 
@@ -360,10 +360,125 @@ void OutputPin::setValue(int logicValue) {
 #endif /* EFI_PROD_CODE */
 }
 
+uint32_t outputPinGroupEdgeCounter = 0;
+uint32_t outputPinGroupWriteCounter = 0;
+
+void OutputPinGroup::add(NamedOutputPin *output) {
+	efiAssertVoid(CUSTOM_ERR_6634, size < OUTPUT_PIN_GROUP_SIZE, "pin group overflow");
+	pins[size++] = output;
+}
+
+int OutputPinGroup::getSize() const {
+	return size;
+}
+
+void OutputPinGroup::setHigh() {
+	setValue(true);
+#if EFI_ENGINE_SNIFFER
+	// one sniffer record per member so that console keeps showing individual channels
+	for (int i = 0; i < size; i++) {
+		addEngineSnifferEvent(pins[i]->getShortName(), PROTOCOL_ES_UP);
+	}
+#endif /* EFI_ENGINE_SNIFFER */
+}
+
+void OutputPinGroup::setLow() {
+	setValue(false);
+#if EFI_ENGINE_SNIFFER
+	for (int i = 0; i < size; i++) {
+		addEngineSnifferEvent(pins[i]->getShortName(), PROTOCOL_ES_DOWN);
+	}
+#endif /* EFI_ENGINE_SNIFFER */
+}
+
+void OutputPinGroup::setValue(int logicValue) {
+	ScopePerf perf(PE::OutputPinSetValue);
+
+#if EFI_PROD_CODE
+#if (BOARD_EXT_GPIOCHIPS > 0)
+	// smart chip outputs of this group share one register update
+	struct gpiochip_batch batch;
+	gpiochips_batchBegin(&batch);
+#endif /* (BOARD_EXT_GPIOCHIPS > 0) */
+	ioportid_t ports[OUTPUT_PIN_GROUP_MAX_PORTS];
+	ioportmask_t setMasks[OUTPUT_PIN_GROUP_MAX_PORTS];
+	ioportmask_t clearMasks[OUTPUT_PIN_GROUP_MAX_PORTS];
+	int portCount = 0;
+
+	for (int i = 0; i < size; i++) {
+		NamedOutputPin *output = pins[i];
+		if (output->currentLogicValue == logicValue) {
+			continue;
+		}
+		outputPinGroupEdgeCounter++;
+	#if (BOARD_EXT_GPIOCHIPS > 0)
+		if (output->ext) {
+			// deferred until batch end, see gpiochips_getBatchStats()
+			gpiochips_batchWritePad(&batch, output->brainPin, logicValue);
+			/* TODO: check return value */
+			output->currentLogicValue = logicValue;
+			continue;
+		}
+	#endif /* (BOARD_EXT_GPIOCHIPS > 0) */
+		if (output->port == GPIO_NULL) {
+			continue;
+		}
+		int portIndex = 0;
+		while (portIndex < portCount && ports[portIndex] != output->port) {
+			portIndex++;
+		}
+		if (portIndex == OUTPUT_PIN_GROUP_MAX_PORTS) {
+			// too many different ports, this one goes on its own
+			output->setValue(logicValue);
+			outputPinGroupWriteCounter++;
+			continue;
+		}
+		if (portIndex == portCount) {
+			ports[portIndex] = output->port;
+			setMasks[portIndex] = 0;
+			clearMasks[portIndex] = 0;
+			portCount++;
+		}
+		if (getElectricalValue(logicValue, output->getMode())) {
+			setMasks[portIndex] |= PAL_PORT_BIT(output->pin);
+		} else {
+			clearMasks[portIndex] |= PAL_PORT_BIT(output->pin);
+		}
+		output->currentLogicValue = logicValue;
+	}
+
+	for (int i = 0; i < portCount; i++) {
+		if (setMasks[i] != 0) {
+			palSetPort(ports[i], setMasks[i]);
+			outputPinGroupWriteCounter++;
+		}
+		if (clearMasks[i] != 0) {
+			palClearPort(ports[i], clearMasks[i]);
+			outputPinGroupWriteCounter++;
+		}
+	}
+#if (BOARD_EXT_GPIOCHIPS > 0)
+	gpiochips_batchEnd(&batch);
+#endif /* (BOARD_EXT_GPIOCHIPS > 0) */
+#else /* EFI_PROD_CODE */
+	for (int i = 0; i < size; i++) {
+		if (pins[i]->currentLogicValue != logicValue) {
+			outputPinGroupEdgeCounter++;
+			pins[i]->setValue(logicValue);
+			outputPinGroupWriteCounter++;
+		}
+	}
+#endif /* EFI_PROD_CODE */
+}
+
 bool OutputPin::getLogicValue() const {
 	return currentLogicValue;
 }
 
+pin_output_mode_e OutputPin::getMode() const {
+	return *modePtr;
+}
+
 void OutputPin::setDefaultPinState(const pin_output_mode_e *outputMode) {
 	pin_output_mode_e mode = *outputMode;
 	/* may be*/UNUSED(mode);
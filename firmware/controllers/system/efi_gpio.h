@@ -50,7 +50,7 @@ public:
 	void setValue(int logicValue);
 	void toggle();
 	bool getLogicValue() const;
-
+	pin_output_mode_e getMode() const;
 
 #if EFI_GPIO_HARDWARE
 	ioportid_t port = 0;
@@ -112,6 +112,33 @@ public:
 	bool outOfOrder; // https://sourceforge.net/p/rusefi/tickets/319/
 };
 
+#define OUTPUT_PIN_GROUP_SIZE INJECTION_PIN_COUNT
+#define OUTPUT_PIN_GROUP_MAX_PORTS 4
+
+/**
+ * @brief   Set of outputs which change state at the same moment
+ *
+ * Simultaneous injection or wasted spark would toggle all member pins with one set/clear register
+ * write per GPIO port instead of one palWritePad() per pin.
+ */
+class OutputPinGroup {
+public:
+	void add(NamedOutputPin *output);
+	void setHigh();
+	void setLow();
+	void setValue(int logicValue);
+	int getSize() const;
+private:
+	NamedOutputPin *pins[OUTPUT_PIN_GROUP_SIZE];
+	int size = 0;
+};
+
+/**
+ * number of pin edges applied by all groups and number of GPIO register writes it took
+ */
+extern uint32_t outputPinGroupEdgeCounter;
+extern uint32_t outputPinGroupWriteCounter;
+
 class EnginePins {
 public:
 	EnginePins();
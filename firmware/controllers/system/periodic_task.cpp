@@ -9,6 +9,12 @@
 #include "os_util.h"
 #include "perf_trace.h"
 
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+#include "engine.h"
+
+EXTERN_ENGINE;
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
+
 void runAndScheduleNext(PeriodicTimerController *controller) {
 #if !EFI_UNIT_TEST
 	{
@@ -16,6 +22,11 @@ void runAndScheduleNext(PeriodicTimerController *controller) {
 		controller->PeriodicTask();
 	}
 
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+	engine->executor.scheduleForLater(&controller->scheduling, MS2US(controller->getPeriodMs()),
+			{ &runAndScheduleNext, controller });
+#else
 	chVTSetAny(&controller->timer, TIME_MS2I(controller->getPeriodMs()), (vtfunc_t) &runAndScheduleNext, controller);
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
 #endif /* EFI_UNIT_TEST */
 }
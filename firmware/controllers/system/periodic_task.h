@@ -8,6 +8,9 @@
 #pragma once
 
 #include "global.h"
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+#include "scheduler.h"
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
 
 class PeriodicTimerController;
 
@@ -21,7 +24,10 @@ void runAndScheduleNext(PeriodicTimerController *controller);
 class PeriodicTimerController {
 
 public:
-#if !EFI_UNIT_TEST
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+	// periodic tasks are events on virtual clock
+	scheduling_s scheduling;
+#elif !EFI_UNIT_TEST
 	virtual_timer_t timer;
 #endif /* EFI_UNIT_TEST */
 
@@ -24,9 +24,15 @@ extern bool verboseMode;
 
 uint32_t maxSchedulingPrecisionLoss = 0;
 
+/**
+ * how late, in NT, events are invoked compared to their scheduled time
+ */
+LatencyHistogram eventQueueLateness;
+
 EventQueue::EventQueue() {
 	head = nullptr;
 	setLateDelay(100);
+	lateness = &eventQueueLateness;
 }
 
 bool EventQueue::checkIfPending(scheduling_s *scheduling) {
@@ -108,6 +114,26 @@ efitime_t EventQueue::getNextEventTime(efitime_t nowX) const {
 	return EMPTY_QUEUE;
 }
 
+/**
+ * Coalescing delays the soonest event by at most coalescingWindowX, never more
+ */
+efitime_t EventQueue::getNextEventTime(efitime_t nowX, efitime_t coalescingWindowX) const {
+	efitime_t result = getNextEventTime(nowX);
+	if (result == EMPTY_QUEUE || coalescingWindowX <= 0) {
+		return result;
+	}
+	// window is counted from head moment, not from the coalesced one, otherwise a long train of close events
+	// would keep pushing the callback further
+	efitime_t limit = (head->momentX > nowX ? head->momentX : nowX) + coalescingWindowX;
+	for (scheduling_s *current = head->nextScheduling_s; current != nullptr && current->momentX <= limit;
+			current = current->nextScheduling_s) {
+		if (current->momentX > result) {
+			result = current->momentX;
+		}
+	}
+	return result;
+}
+
 /**
  * See also maxPrecisionCallbackDuration for total hw callback time
  */
@@ -144,6 +170,9 @@ int EventQueue::executeAll(efitime_t now) {
 		}
 
 		executionCounter++;
+		if (lateness != nullptr) {
+			lateness->add((uint32_t)(now - current->momentX));
+		}
 
 		// step the head forward, unlink this element, clear scheduled flag
 		head = current->nextScheduling_s;
@@ -188,6 +217,10 @@ void EventQueue::setLateDelay(int value) {
 	lateDelay = value;
 }
 
+void EventQueue::setLatenessHistogram(LatencyHistogram *histogram) {
+	lateness = histogram;
+}
+
 scheduling_s * EventQueue::getHead() {
 	return head;
 }
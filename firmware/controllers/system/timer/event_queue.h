@@ -7,6 +7,7 @@
 
 #include "scheduler.h"
 #include "utlist.h"
+#include "latency_histogram.h"
 
 #pragma once
 
@@ -17,6 +18,8 @@
 
 #define QUEUE_LENGTH_LIMIT 1000
 
+extern LatencyHistogram eventQueueLateness;
+
 // templates do not accept field names so we use a macro here
 #define assertNotInListMethodBody(T, head, element, field)                  \
 	/* this code is just to validate state, no functional load*/            \
@@ -55,10 +58,19 @@ public:
 	int executeAll(efitime_t now);
 
 	efitime_t getNextEventTime(efitime_t nowUs) const;
+	/**
+	 * Same as getNextEventTime() but if more events are due within coalescingWindow after the soonest one, timestamp
+	 * of the last of them is returned so that all of them are executed by one timer callback
+	 */
+	efitime_t getNextEventTime(efitime_t nowX, efitime_t coalescingWindowX) const;
 	void clear(void);
 	int size(void) const;
 	scheduling_s *getElementAtIndexForUnitText(int index);
 	void setLateDelay(int value);
+	/**
+	 * where executeAll() records lateness, nullptr for none. eventQueueLateness by default
+	 */
+	void setLatenessHistogram(LatencyHistogram *histogram);
 	scheduling_s * getHead();
 	void assertListIsSorted() const;
 private:
@@ -68,5 +80,6 @@ private:
 	 */
 	scheduling_s *head;
 	efitime_t lateDelay;
+	LatencyHistogram *lateness;
 };
 
@@ -43,6 +43,11 @@ static efitime_t nextEventTimeNt = 0;
 uint32_t hwSetTimerDuration;
 uint32_t lastExecutionCount;
 
+/**
+ * how much, in NT, timer callbacks are deferred by coalescing. Total lateness is in eventQueueLateness
+ */
+LatencyHistogram executorCoalescingDelay;
+
 void globalTimerCallback() {
 	efiAssertVoid(CUSTOM_ERR_6624, getCurrentRemainingStack() > EXPECTED_REMAINING_STACK, "lowstck#2y");
 
@@ -51,13 +56,28 @@ void globalTimerCallback() {
 
 SingleTimerExecutor::SingleTimerExecutor() {
 	reentrantFlag = false;
+	isTimerArmed = false;
 	doExecuteCounter = scheduleCounter = timerCallbackCounter = 0;
+	timerReprogramCounter = timerReprogramSkipCounter = coalescedCallbackCounter = 0;
+	setCoalescingWindowUs(EFI_EXECUTOR_COALESCING_WINDOW_US);
 	/**
 	 * todo: a good comment
 	 */
 	queue.setLateDelay(US2NT(100));
 }
 
+bool SingleTimerExecutor::setCoalescingWindowUs(int windowUs) {
+	if (windowUs < 0) {
+		return false;
+	}
+	coalescingWindowNt = US2NT(minI(windowUs, EXECUTOR_MAX_COALESCING_WINDOW_US));
+	return true;
+}
+
+int SingleTimerExecutor::getCoalescingWindowUs() const {
+	return NT2US(coalescingWindowNt);
+}
+
 void SingleTimerExecutor::scheduleForLater(scheduling_s *scheduling, int delayUs, action_s action) {
 	scheduleByTimestamp(scheduling, getTimeNowUs() + delayUs, action);
 }
@@ -109,6 +129,7 @@ void SingleTimerExecutor::scheduleByTimestampNt(scheduling_s* scheduling, efitim
 void SingleTimerExecutor::onTimerCallback() {
 	timerCallbackCounter++;
 	bool alreadyLocked = lockAnyContext();
+	isTimerArmed = false;
 	doExecute();
 	scheduleTimerCallback();
 	if (!alreadyLocked)
@@ -161,29 +182,55 @@ void SingleTimerExecutor::scheduleTimerCallback() {
 	 * Let's grab fresh time value
 	 */
 	efitick_t nowNt = getTimeNowNt();
-	nextEventTimeNt = queue.getNextEventTime(nowNt);
-	efiAssertVoid(CUSTOM_ERR_6625, nextEventTimeNt > nowNt, "setTimer constraint");
-	if (nextEventTimeNt == EMPTY_QUEUE)
+	efitime_t soonestEventTimeNt = queue.getNextEventTime(nowNt);
+	efitime_t callbackTimeNt = queue.getNextEventTime(nowNt, coalescingWindowNt);
+	efiAssertVoid(CUSTOM_ERR_6625, callbackTimeNt > nowNt, "setTimer constraint");
+	if (callbackTimeNt == EMPTY_QUEUE)
 		return; // no pending events in the queue
+	if (isTimerArmed && callbackTimeNt == nextEventTimeNt) {
+		// new head was inserted within the window of already armed callback
+		timerReprogramSkipCounter++;
+		return;
+	}
+	if (callbackTimeNt != soonestEventTimeNt) {
+		coalescedCallbackCounter++;
+		executorCoalescingDelay.add((uint32_t)(callbackTimeNt - soonestEventTimeNt));
+	}
+	nextEventTimeNt = callbackTimeNt;
+	isTimerArmed = true;
+	timerReprogramCounter++;
 	int32_t hwAlarmTime = NT2US((int32_t)nextEventTimeNt - (int32_t)nowNt);
 	uint32_t beforeHwSetTimer = getTimeNowLowerNt();
 	setHardwareUsTimer(hwAlarmTime == 0 ? 1 : hwAlarmTime);
 	hwSetTimerDuration = getTimeNowLowerNt() - beforeHwSetTimer;
 }
 
+static void setExecutorCoalescingWindow(int windowUs) {
+	if (!___engine.executor.setCoalescingWindowUs(windowUs)) {
+		print("coalescing window cannot be negative: %d\r\n", windowUs);
+		return;
+	}
+	print("coalescing window %dus\r\n", ___engine.executor.getCoalescingWindowUs());
+}
+
 void initSingleTimerExecutorHardware(void) {
 	initMicrosecondTimer();
+	addConsoleActionI("set_executor_coalescing", setExecutorCoalescingWindow);
 }
 
-void executorStatistics() {
+#if EFI_TUNER_STUDIO
+void executorStatistics(TsDebugChannels *tsDebugChannels) {
 	if (engineConfiguration->debugMode == DBG_EXECUTOR) {
-#if EFI_TUNER_STUDIO && EFI_SIGNAL_EXECUTOR_ONE_TIMER
-		tsOutputChannels.debugIntField1 = ___engine.executor.timerCallbackCounter;
-		tsOutputChannels.debugIntField2 = ___engine.executor.doExecuteCounter;
-		tsOutputChannels.debugIntField3 = ___engine.executor.scheduleCounter;
-#endif /* EFI_TUNER_STUDIO */
+		tsDebugChannels->debugIntField1 = ___engine.executor.timerCallbackCounter;
+		tsDebugChannels->debugIntField2 = ___engine.executor.doExecuteCounter;
+		tsDebugChannels->debugIntField3 = ___engine.executor.scheduleCounter;
+		tsDebugChannels->debugFloatField1 = ___engine.executor.timerReprogramCounter;
+		tsDebugChannels->debugFloatField2 = ___engine.executor.timerReprogramSkipCounter;
+		tsDebugChannels->debugFloatField3 = ___engine.executor.coalescedCallbackCounter;
+		tsDebugChannels->debugFloatField4 = lastExecutionCount;
 	}
 }
+#endif /* EFI_TUNER_STUDIO */
 
 #endif /* EFI_SIGNAL_EXECUTOR_ONE_TIMER */
 
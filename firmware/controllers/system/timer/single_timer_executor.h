@@ -10,6 +10,24 @@
 #include "scheduler.h"
 #include "event_queue.h"
 
+/**
+ * zero means every event gets its own timer callback
+ */
+#ifndef EFI_EXECUTOR_COALESCING_WINDOW_US
+#define EFI_EXECUTOR_COALESCING_WINDOW_US 0
+#endif
+
+/**
+ * events are late by up to the window, anything above a few tens of microseconds is visible in spark timing
+ */
+#define EXECUTOR_MAX_COALESCING_WINDOW_US 30
+
+#if EFI_EXECUTOR_COALESCING_WINDOW_US < 0 || EFI_EXECUTOR_COALESCING_WINDOW_US > EXECUTOR_MAX_COALESCING_WINDOW_US
+#error "EFI_EXECUTOR_COALESCING_WINDOW_US out of range"
+#endif
+
+extern LatencyHistogram executorCoalescingDelay;
+
 class SingleTimerExecutor : public ExecutorInterface {
 public:
 	SingleTimerExecutor();
@@ -17,16 +35,45 @@ public:
 	void scheduleByTimestampNt(scheduling_s *scheduling, efitime_t timeNt, action_s action) override;
 	void scheduleForLater(scheduling_s *scheduling, int delayUs, action_s action) override;
 	void onTimerCallback();
+	/**
+	 * Events due within this window after the soonest pending one are executed by the same timer callback,
+	 * each of them at most windowUs late. Window is clamped to EXECUTOR_MAX_COALESCING_WINDOW_US.
+	 * @return false and window is not changed if windowUs is negative
+	 */
+	bool setCoalescingWindowUs(int windowUs);
+	int getCoalescingWindowUs() const;
 	int timerCallbackCounter;
 	int scheduleCounter;
 	int doExecuteCounter;
+	/**
+	 * number of hardware timer writes
+	 */
+	int timerReprogramCounter;
+	/**
+	 * number of times new queue head did not require a hardware timer write since the armed callback
+	 * would cover it anyway
+	 */
+	int timerReprogramSkipCounter;
+	/**
+	 * number of timer callbacks which were deferred in order to cover more than one event
+	 */
+	int coalescedCallbackCounter;
 private:
 	EventQueue queue;
 	bool reentrantFlag;
+	bool isTimerArmed;
+	efitick_t coalescingWindowNt;
 	void doExecute();
 	void scheduleTimerCallback();
 };
 
 void initSingleTimerExecutorHardware(void);
-void executorStatistics();
+
+#if EFI_TUNER_STUDIO
+#include "tunerstudio_debug_struct.h"
+/**
+ * fills debug channels of DBG_EXECUTOR, only reads executor counters so that it could run for any copy of channels
+ */
+void executorStatistics(TsDebugChannels *tsDebugChannels);
+#endif /* EFI_TUNER_STUDIO */
 
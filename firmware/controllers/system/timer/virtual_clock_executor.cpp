@@ -0,0 +1,92 @@
+/*
+ * @file virtual_clock_executor.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "virtual_clock_executor.h"
+
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+#include "engine.h"
+
+EXTERN_ENGINE;
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
+
+VirtualClockExecutor::VirtualClockExecutor() {
+	// virtual clock is never late
+	queue.setLateDelay(0);
+	// and its lateness has nothing to do with hardware timer one
+	queue.setLatenessHistogram(nullptr);
+}
+
+void VirtualClockExecutor::scheduleByTimestamp(scheduling_s *scheduling, efitimeus_t timeUs, action_s action) {
+	scheduleByTimestampNt(scheduling, US2NT(timeUs), action);
+}
+
+void VirtualClockExecutor::scheduleByTimestampNt(scheduling_s *scheduling, efitime_t timeNt, action_s action) {
+	scheduleCounter++;
+	queue.insertTask(scheduling, timeNt, action);
+	if (!isRunning) {
+		// same as SingleTimerExecutor: whatever is already due is executed right away
+		isRunning = true;
+		executeCounter += queue.executeAll(nowNt);
+		isRunning = false;
+	}
+}
+
+void VirtualClockExecutor::scheduleForLater(scheduling_s *scheduling, int delayUs, action_s action) {
+	scheduleByTimestampNt(scheduling, nowNt + US2NT(delayUs), action);
+}
+
+int VirtualClockExecutor::runUntil(efitick_t targetNt) {
+	int executed = 0;
+	isRunning = true;
+	while (true) {
+		scheduling_s *head = queue.getHead();
+		if (head == nullptr || head->momentX > targetNt) {
+			break;
+		}
+		if (head->momentX > nowNt) {
+			nowNt = head->momentX;
+		}
+		// this would also execute whatever callbacks schedule at current moment
+		executed += queue.executeAll(nowNt);
+	}
+	isRunning = false;
+	if (targetNt > nowNt) {
+		nowNt = targetNt;
+	}
+	executeCounter += executed;
+	return executed;
+}
+
+efitick_t VirtualClockExecutor::getNowNt() const {
+	return nowNt;
+}
+
+void VirtualClockExecutor::reset() {
+	scheduling_s *current = queue.getHead();
+	while (current != nullptr) {
+		scheduling_s *next = current->nextScheduling_s;
+		current->nextScheduling_s = nullptr;
+		current->isScheduled = false;
+		current = next;
+	}
+	queue.clear();
+	nowNt = 0;
+	scheduleCounter = 0;
+	executeCounter = 0;
+}
+
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+efitick_t getTimeNowNt(void) {
+	return engine->executor.getNowNt();
+}
+
+efitimeus_t getTimeNowUs(void) {
+	return NT2US(getTimeNowNt());
+}
+
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
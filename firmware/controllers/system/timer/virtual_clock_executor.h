@@ -0,0 +1,49 @@
+/*
+ * @file virtual_clock_executor.h
+ *
+ * Discrete-event executor: there is no hardware timer, virtual time jumps from one scheduled event to the
+ * next one. With EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK this is engine executor of a host build and getTimeNowNt()
+ * reads the same virtual clock, which allows to run engine control code as fast as CPU allows, with identical
+ * results on each run. Without that flag standalone instances are still available, see 'virtualclocktest'.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "scheduler.h"
+#include "event_queue.h"
+
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+#if EFI_SIGNAL_EXECUTOR_ONE_TIMER || EFI_SIGNAL_EXECUTOR_SLEEP || EFI_PROD_CODE
+#error "Virtual clock executor is a replacement of other executors, host builds only"
+#endif
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
+
+class VirtualClockExecutor : public ExecutorInterface {
+public:
+	VirtualClockExecutor();
+	void scheduleByTimestamp(scheduling_s *scheduling, efitimeus_t timeUs, action_s action) override;
+	void scheduleByTimestampNt(scheduling_s *scheduling, efitime_t timeNt, action_s action) override;
+	void scheduleForLater(scheduling_s *scheduling, int delayUs, action_s action) override;
+
+	/**
+	 * Executes all events scheduled up to and including given moment in timestamp order. Virtual
+	 * time is advanced to each event timestamp before it is executed and to targetNt in the end.
+	 * @return number of executed events
+	 */
+	int runUntil(efitick_t targetNt);
+	efitick_t getNowNt() const;
+	/**
+	 * drops all pending events and sets virtual time back to zero. Periodic tasks have to be started again.
+	 */
+	void reset();
+
+	uint32_t scheduleCounter = 0;
+	uint32_t executeCounter = 0;
+private:
+	EventQueue queue;
+	efitick_t nowNt = 0;
+	bool isRunning = false;
+};
@@ -0,0 +1,265 @@
+/**
+ * @file	misfire_analyzer.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "misfire_analyzer.h"
+#include "obd_error_codes.h"
+#include "efilib.h"
+#include <string.h>
+#include <math.h>
+
+/**
+ * crank speed at TDC is measured over this angle, longer is less sensitive to tooth jitter but should not reach
+ * into the power stroke of previous cylinder, so it is limited to half the distance between TDCs
+ */
+#define MISFIRE_SPEED_WINDOW_DEG 60
+#define MISFIRE_MIN_LOAD 15
+/**
+ * rpm per second. Faster than this the crank is not driven by combustion: closed throttle overrun or fuel cut
+ */
+#define MISFIRE_MAX_DECELERATION 500
+/**
+ * one misfire is a short dip which the crank recovers from, smoothing keeps it away from deceleration limit
+ */
+#define MISFIRE_DECELERATION_ALPHA 0.2f
+/**
+ * misfire is a stroke slower than MISFIRE_NOISE_SIGMA typical healthy stroke deviations... Cycle median has noise
+ * of its own, on the host model 5 gave false misfires on healthy engine with some noise seeds and 8 never did
+ */
+#define MISFIRE_NOISE_SIGMA 8
+/**
+ * ...and at least this share of squared crank speed at full load, so that a very smooth engine does not report noise
+ */
+#define MISFIRE_MIN_RELATIVE_DROP 0.003f
+/**
+ * noise needs some history before it could be trusted, 1 / MISFIRE_NOISE_ALPHA strokes at least
+ */
+#define MISFIRE_WARMUP_STROKES 128
+#define MISFIRE_NOISE_ALPHA 0.02f
+#define MISFIRE_CONTRIBUTION_ALPHA 0.02f
+/**
+ * a cylinder with more misfires than this within a window gets its own code
+ */
+#define MISFIRE_WINDOW_THRESHOLD (MISFIRE_WINDOW_CYCLES * 2 / 100)
+
+MisfireAnalyzer::MisfireAnalyzer() {
+	memset(tdcPosition, -1, sizeof(tdcPosition));
+	memset(speedWindowPosition, -1, sizeof(speedWindowPosition));
+	reset();
+}
+
+void MisfireAnalyzer::reset() {
+	memset(static_cast<misfire_state_s*>(this), 0, sizeof(misfire_state_s));
+	memset(currentWindowMisfires, 0, sizeof(currentWindowMisfires));
+	speedWindowOwner = -1;
+	lastTdcPosition = -1;
+	lastTdcRpm2 = 0;
+	strokeMask = 0;
+	lastCycleRpm = 0;
+	lastCycleNt = 0;
+	deceleration = 0;
+	evaluatedStrokeCounter = 0;
+	windowCycles = 0;
+}
+
+/**
+ * @return how far we go forward from 'from' to reach 'to'
+ */
+static angle_t getDistance(angle_t from, angle_t to, angle_t engineCycle) {
+	angle_t distance = to - from;
+	return distance < 0 ? distance + engineCycle : distance;
+}
+
+/**
+ * With rising edge only trigger every angle is present twice, either one could be the one we are invoked with,
+ * so all events at given angle are marked
+ */
+static void markEvents(int8_t *table, const angle_t *eventAngles, int eventCount, angle_t angle, int position) {
+	for (int i = 0; i < eventCount; i++) {
+		if (eventAngles[i] == angle) {
+			table[i] = position;
+		}
+	}
+}
+
+void MisfireAnalyzer::configure(const angle_t *eventAngles, int eventCount, const angle_t *cylinderAngles,
+		const int *cylinderIds, int cylinderCount, angle_t engineCycle) {
+	this->eventCount = minI(eventCount, PWM_PHASE_MAX_COUNT);
+	this->cylinderCount = minI(cylinderCount, MISFIRE_CYLINDER_COUNT);
+	memset(tdcPosition, -1, sizeof(tdcPosition));
+	memset(speedWindowPosition, -1, sizeof(speedWindowPosition));
+	angle_t minWindow = minF(MISFIRE_SPEED_WINDOW_DEG, engineCycle / maxI(1, this->cylinderCount) / 2);
+
+	for (int c = 0; c < this->cylinderCount; c++) {
+		cylinderIndex[c] = minI(maxI(0, cylinderIds[c] - 1), MISFIRE_CYLINDER_COUNT - 1);
+		// first event at or after TDC
+		angle_t tdcAngle = 0;
+		angle_t best = engineCycle;
+		for (int i = 0; i < this->eventCount; i++) {
+			angle_t distance = getDistance(cylinderAngles[c], eventAngles[i], engineCycle);
+			if (distance < best) {
+				best = distance;
+				tdcAngle = eventAngles[i];
+			}
+		}
+		// closest event which is at least the speed window before that one
+		angle_t windowAngle = tdcAngle;
+		best = engineCycle;
+		for (int i = 0; i < this->eventCount; i++) {
+			angle_t distance = getDistance(eventAngles[i], tdcAngle, engineCycle);
+			if (distance >= minWindow && distance < best) {
+				best = distance;
+				windowAngle = eventAngles[i];
+			}
+		}
+		speedWindowAngle[c] = best;
+		markEvents(tdcPosition, eventAngles, this->eventCount, tdcAngle, c);
+		markEvents(speedWindowPosition, eventAngles, this->eventCount, windowAngle, c);
+	}
+	reset();
+}
+
+bool MisfireAnalyzer::onTriggerEvent(int eventIndex, efitick_t nowNt, float loadPercent) {
+	if (eventIndex < 0 || eventIndex >= eventCount) {
+		return false;
+	}
+	bool isWindowDone = false;
+	int position = tdcPosition[eventIndex];
+	if (position >= 0 && position != lastTdcPosition) {
+		// only TDC events touch misfire_state_s
+		SeqLockWriteScope scope(&stateLock);
+		onTdc(position, nowNt, loadPercent);
+		if (position == 0) {
+			cycleCounter++;
+			if (++windowCycles == MISFIRE_WINDOW_CYCLES) {
+				evaluateWindow();
+				isWindowDone = true;
+			}
+		}
+	}
+	// same event could end one speed window and start another one on sparse trigger wheels
+	position = speedWindowPosition[eventIndex];
+	if (position >= 0) {
+		speedWindowOwner = position;
+		speedWindowStartNt = (uint32_t)nowNt;
+	}
+	return isWindowDone;
+}
+
+void MisfireAnalyzer::onTdc(int position, efitick_t nowNt, float loadPercent) {
+	int previousPosition = lastTdcPosition;
+	float previousRpm2 = lastTdcRpm2;
+	lastTdcPosition = position;
+	lastTdcRpm2 = 0;
+	if (speedWindowOwner != position) {
+		// we have missed the start of speed window
+		return;
+	}
+	speedWindowOwner = -1;
+	// 32 bit is plenty for a short window
+	uint32_t durationNt = (uint32_t)nowNt - speedWindowStartNt;
+	if (durationNt == 0) {
+		return;
+	}
+	float rpm = (60000000.0f / 360 * US_TO_NT_MULTIPLIER) * speedWindowAngle[position] / durationNt;
+	lastTdcRpm2 = rpm * rpm;
+	if (previousRpm2 != 0 && position == (previousPosition + 1) % cylinderCount) {
+		// energy between previous TDC and this one is what previous cylinder has given
+		onStroke(previousPosition, previousRpm2, loadPercent);
+	}
+	if (position == 0) {
+		onCycle(nowNt);
+	}
+}
+
+/**
+ * Invoked at TDC of first cylinder in firing order, once stroke of the last one is known
+ */
+void MisfireAnalyzer::onCycle(efitick_t nowNt) {
+	float rpm = sqrtf(lastTdcRpm2);
+	if (lastCycleNt != 0) {
+		// same phase of the firing pattern every time, so firing pulsation does not show up here
+		float seconds = (nowNt - lastCycleNt) / (US_PER_SECOND_F * US_TO_NT_MULTIPLIER);
+		deceleration += MISFIRE_DECELERATION_ALPHA * ((lastCycleRpm - rpm) / seconds - deceleration);
+	}
+	lastCycleRpm = rpm;
+	lastCycleNt = nowNt;
+
+	if (strokeMask == (1u << cylinderCount) - 1 && deceleration < MISFIRE_MAX_DECELERATION) {
+		evaluateCycle();
+	}
+	strokeMask = 0;
+}
+
+void MisfireAnalyzer::onStroke(int position, float startRpm2, float loadPercent) {
+	if (loadPercent < MISFIRE_MIN_LOAD) {
+		// whole cycle is skipped
+		strokeMask = 0;
+		return;
+	}
+	float loadFactor = loadPercent / 100;
+	float value = (lastTdcRpm2 - startRpm2) / 1000 / loadFactor;
+	acceleration[cylinderIndex[position]] = value;
+	strokeValue[position] = value;
+	strokeMask |= 1u << position;
+}
+
+void MisfireAnalyzer::evaluateCycle() {
+	// middle of the cycle: unlike the mean it does not follow one misfiring stroke down
+	float sorted[MISFIRE_CYLINDER_COUNT];
+	for (int p = 0; p < cylinderCount; p++) {
+		int i = p;
+		for (; i > 0 && sorted[i - 1] > strokeValue[p]; i--) {
+			sorted[i] = sorted[i - 1];
+		}
+		sorted[i] = strokeValue[p];
+	}
+	float median = (sorted[(cylinderCount - 1) / 2] + sorted[cylinderCount / 2]) / 2;
+	float minDrop = MISFIRE_MIN_RELATIVE_DROP * lastTdcRpm2 / 1000;
+	float threshold = maxF(MISFIRE_NOISE_SIGMA * noiseLevel, minDrop);
+	bool isWarm = evaluatedStrokeCounter >= MISFIRE_WARMUP_STROKES;
+
+	for (int p = 0; p < cylinderCount; p++) {
+		int index = cylinderIndex[p];
+		// whatever the whole crank did over this cycle is in the mean, each cylinder is then compared against
+		// its own typical stroke so that a weak cylinder is not noise for the others
+		float deviation = strokeValue[p] - median - contribution[index];
+		if (isWarm && deviation < -threshold) {
+			misfireCounter[index]++;
+			currentWindowMisfires[index]++;
+		}
+		evaluatedStrokeCounter++;
+		/**
+		 * Baseline keeps adapting on every stroke, once warmed up a misfire only moves it by as much as
+		 * a borderline healthy stroke would. This way a baseline learned before some change in operating conditions cannot keep
+		 * every following stroke reported as a misfire.
+		 */
+		float limited = isWarm ? clampF(-threshold, deviation, threshold) : deviation;
+		// running mean of absolute deviation, cheaper than variance and less sensitive to outliers
+		noiseLevel += MISFIRE_NOISE_ALPHA * (absF(limited) - noiseLevel);
+		contribution[index] += MISFIRE_CONTRIBUTION_ALPHA * limited;
+	}
+}
+
+void MisfireAnalyzer::evaluateWindow() {
+	int code = 0;
+	int misfiringCylinders = 0;
+	// state arrays are by cylinder number
+	for (int c = 0; c < cylinderCount; c++) {
+		windowMisfireCounter[c] = currentWindowMisfires[c];
+		currentWindowMisfires[c] = 0;
+		if (windowMisfireCounter[c] > MISFIRE_WINDOW_THRESHOLD) {
+			misfiringCylinders++;
+			code = OBD_Cylinder_1_Misfire + c;
+		}
+	}
+	if (misfiringCylinders > 1) {
+		code = OBD_Random_Multiple_Cylinder_Misfire;
+	}
+	lastMisfireCode = code;
+	windowCycles = 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file	misfire_analyzer.h
+ * @brief	Crank angle domain misfire detection and cylinder contribution
+ *
+ * Crank speed is sampled over a short angle window right before each cylinder TDC, always at the same phase of the
+ * firing pattern. Difference of squared speeds at consecutive TDCs is proportional to the energy given by the cylinder
+ * which fired in between: a misfire slows the crank down. This is divided by load to be comparable across operating
+ * points. Strokes are evaluated once per engine cycle against the median of that cycle, so that the crank slowing down
+ * or speeding up as a whole does not look like a misfire, and compared against the learned noise of healthy strokes.
+ * Cycles with crank decelerating faster than MISFIRE_MAX_DECELERATION are not evaluated at all: that is closed
+ * throttle overrun or fuel cut, not combustion.
+ *
+ * Misfires are counted per cylinder over evaluation windows of MISFIRE_WINDOW_CYCLES engine cycles, a window with
+ * too many misfires reports an OBD P030x code.
+ *
+ * Per trigger event this is two table lookups, per power stroke a handful of float operations. No dependency on
+ * trigger or engine classes so that synthetic waveforms could be replayed on the host.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "rusefi_types.h"
+#include "misfire_state_generated.h"
+#include "state_sequence.h"
+#include "seqlock.h"
+
+/**
+ * 200 crank revolutions, same as OBD-II window for catalyst damaging misfire
+ */
+#define MISFIRE_WINDOW_CYCLES 100
+
+class MisfireAnalyzer : public misfire_state_s {
+public:
+	MisfireAnalyzer();
+	/**
+	 * Heavy, only invoked on configuration change.
+	 * @param eventAngles angle of each trigger event relative to trigger synchronization point
+	 * @param cylinderAngles TDC of each cylinder in firing order, in the same coordinates as eventAngles
+	 * @param cylinderIds cylinder number of each firing order position, from one. State arrays are by cylinder number.
+	 */
+	void configure(const angle_t *eventAngles, int eventCount, const angle_t *cylinderAngles, const int *cylinderIds,
+			int cylinderCount, angle_t engineCycle);
+	void reset();
+	/**
+	 * @param loadPercent air charge in percent of full load, cycles with strokes below MISFIRE_MIN_LOAD are ignored
+	 * since there is too little combustion torque to tell a misfire
+	 * @return true if an evaluation window was just completed, see lastMisfireCode
+	 */
+	bool onTriggerEvent(int eventIndex, efitick_t nowNt, float loadPercent);
+
+	/**
+	 * guards misfire_state_s, see TS_GET_STRUCT
+	 */
+	SeqLock stateLock;
+private:
+	void onTdc(int position, efitick_t nowNt, float loadPercent);
+	void onStroke(int position, float rpm2, float loadPercent);
+	void onCycle(efitick_t nowNt);
+	void evaluateCycle();
+	void evaluateWindow();
+	int cylinderCount = 0;
+	int eventCount = 0;
+	/**
+	 * firing order position whose TDC is at given trigger event, -1 for most events
+	 */
+	int8_t tdcPosition[PWM_PHASE_MAX_COUNT];
+	/**
+	 * firing order position whose speed window starts at given trigger event, -1 for most events
+	 */
+	int8_t speedWindowPosition[PWM_PHASE_MAX_COUNT];
+	angle_t speedWindowAngle[MISFIRE_CYLINDER_COUNT];
+	/**
+	 * state array index by firing order position
+	 */
+	int cylinderIndex[MISFIRE_CYLINDER_COUNT];
+	int speedWindowOwner = -1;
+	uint32_t speedWindowStartNt = 0;
+	int lastTdcPosition = -1;
+	/**
+	 * squared rpm at last TDC, zero if not known
+	 */
+	float lastTdcRpm2 = 0;
+	/**
+	 * normalized acceleration of current cycle strokes, by firing order position
+	 */
+	float strokeValue[MISFIRE_CYLINDER_COUNT];
+	/**
+	 * bit per firing order position with a usable stroke in current cycle
+	 */
+	uint32_t strokeMask = 0;
+	/**
+	 * rpm at TDC of first cylinder in firing order and when that was, for deceleration rate
+	 */
+	float lastCycleRpm = 0;
+	efitick_t lastCycleNt = 0;
+	/**
+	 * smoothed, rpm per second, positive while slowing down
+	 */
+	float deceleration = 0;
+	int evaluatedStrokeCounter = 0;
+	int windowCycles = 0;
+	int currentWindowMisfires[MISFIRE_CYLINDER_COUNT];
+};
@@ -26,6 +26,10 @@
 #include "rpm_calculator.h"
 #include "tooth_logger.h"
 #include "perf_trace.h"
+#include "spark_logic.h"
+#include "event_queue.h"
+#include "map.h"
+#include "sensor.h"
 
 #if EFI_PROD_CODE
 #include "pin_repository.h"
@@ -564,6 +568,17 @@ extern int icuRisingCallbackCounter;
 extern int icuFallingCallbackCounter;
 #endif /* HAL_USE_ICU */
 
+#if EFI_PROD_CODE
+static void printLatencyHistogram(const char *name, const LatencyHistogram *histogram) {
+	static latency_histogram_s snapshot;
+	latency_percentiles_s p;
+	histogram->snapshot(&snapshot);
+	latencyHistogramGetPercentiles(&snapshot, &p);
+	scheduleMsg(logger, "%s count=%d p50=%dus p90=%dus p99=%dus p99.9=%dus max=%dus", name, p.count,
+			(int)NT2US(p.p50), (int)NT2US(p.p90), (int)NT2US(p.p99), (int)NT2US(p.p999), (int)NT2US(p.max));
+}
+#endif /* EFI_PROD_CODE */
+
 void triggerInfo(void) {
 #if EFI_PROD_CODE || EFI_SIMULATOR
 
@@ -649,6 +664,16 @@ void triggerInfo(void) {
 
 	scheduleMsg(logger, "maxSchedulingPrecisionLoss=%d", maxSchedulingPrecisionLoss);
 
+	printLatencyHistogram("trigger to spark", &triggerToSparkLatency);
+	printLatencyHistogram("event queue lateness", &eventQueueLateness);
+#if EFI_SIGNAL_EXECUTOR_ONE_TIMER
+	printLatencyHistogram("executor coalescing delay", &executorCoalescingDelay);
+	scheduleMsg(logger, "executor window=%dus callbacks=%d reprogram=%d skipped=%d coalesced=%d",
+			engine->executor.getCoalescingWindowUs(), engine->executor.timerCallbackCounter,
+			engine->executor.timerReprogramCounter, engine->executor.timerReprogramSkipCounter,
+			engine->executor.coalescedCallbackCounter);
+#endif /* EFI_SIGNAL_EXECUTOR_ONE_TIMER */
+
 #if EFI_CLOCK_LOCKS
 	scheduleMsg(logger, "maxLockedDuration=%d / maxTriggerReentraint=%d", maxLockedDuration, maxTriggerReentraint);
 
@@ -727,6 +752,32 @@ bool isTriggerConfigChanged(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
 	return engine->isTriggerConfigChanged;
 }
 
+/**
+ * MisfireAnalyzer tables are built from engine cycle event angles, that's the index listeners are given
+ */
+static void misfireTriggerCallback(trigger_event_e signal, uint32_t index, efitick_t edgeTimestamp DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	(void)signal;
+	if (!ENGINE(rpmCalculator).isRunning(PASS_ENGINE_PARAMETER_SIGNATURE)) {
+		return;
+	}
+	// air charge in percent of full load: manifold pressure relative to atmosphere, throttle without MAP sensor.
+	// Closed throttle overrun is still 20-35% here, that one is excluded by the analyzer on deceleration rate
+	float load;
+	if (hasMapSensor(PASS_ENGINE_PARAMETER_SIGNATURE)) {
+		float baro = hasBaroSensor(PASS_ENGINE_PARAMETER_SIGNATURE) ? getBaroPressure(PASS_ENGINE_PARAMETER_SIGNATURE)
+				: PSI2KPA(0) /* standard atmosphere */;
+		load = getMap(PASS_ENGINE_PARAMETER_SIGNATURE) / baro * 100;
+	} else {
+		load = Sensor::get(SensorType::Tps1).value_or(0);
+	}
+	if (ENGINE(misfireAnalyzer).onTriggerEvent(index, edgeTimestamp, load)) {
+		int code = ENGINE(misfireAnalyzer).lastMisfireCode;
+		if (code != 0) {
+			warning((obd_code_e)code, "misfire P0%d", code);
+		}
+	}
+}
+
 void initTriggerCentral(Logging *sharedLogger) {
 	logger = sharedLogger;
 	strcpy((char*) shaft_signal_msg_index, "x_");
@@ -741,6 +792,8 @@ void initTriggerCentral(Logging *sharedLogger) {
 	addConsoleAction("reset_trigger", resetRunningTriggerCounters);
 #endif
 
+	addTriggerEventListener(misfireTriggerCallback, "misfire", engine);
+
 }
 
 #endif
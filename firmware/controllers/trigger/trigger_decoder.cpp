@@ -117,7 +117,7 @@ static Logging * logger = nullptr;
  * @return TRUE is something is wrong with trigger decoding
  */
 bool isTriggerDecoderError(DECLARE_ENGINE_PARAMETER_SIGNATURE) {
-	return engine->triggerErrorDetection.sum(6) > 4;
+	return engine->triggerErrorDetection.getSum() > 4;
 }
 
 void calculateTriggerSynchPoint(TriggerWaveform *shape, TriggerState *state DECLARE_ENGINE_PARAMETER_SUFFIX) {
@@ -126,7 +126,14 @@ void calculateTriggerSynchPoint(TriggerWaveform *shape, TriggerState *state DECL
 #endif
 	trigger_config_s const*triggerConfig = &engineConfiguration->trigger;
 
+	/**
+	 * trigger ISR is the only writer of triggerErrorDetection, it should not run while running sum is reset
+	 */
+	bool alreadyLocked = lockAnyContext();
 	engine->triggerErrorDetection.clear();
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
 	shape->triggerShapeSynchPointIndex = state->findTriggerZeroEventIndex(shape, triggerConfig PASS_CONFIG_PARAMETER_SUFFIX);
 
 	int length = shape->getLength();
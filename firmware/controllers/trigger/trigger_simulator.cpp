@@ -133,3 +133,67 @@ uint32_t TriggerStimulatorHelper::findTriggerSyncPoint(TriggerWaveform * shape,
 	warning(CUSTOM_ERR_TRIGGER_SYNC, "findTriggerZeroEventIndex() failed");
 	return EFI_ERROR_CODE;
 }
+
+VirtualTriggerStimulator::VirtualTriggerStimulator(VirtualClockExecutor *executor, TriggerWaveform *shape,
+		ShaftSignalCallback callback) : executor(executor), shape(shape), callback(callback) {
+}
+
+void VirtualTriggerStimulator::setRpm(float rpm, float rpmMultiplier) {
+	this->rpm = rpm;
+	this->rpmMultiplier = rpmMultiplier;
+	if (rpm > 0 && !isActive) {
+		isActive = true;
+		index = 0;
+		cycleStartNt = executor->getNowNt();
+		cycleDurationNt = getCycleDurationNt();
+		scheduleNext();
+	}
+}
+
+float VirtualTriggerStimulator::getRpm() const {
+	return rpm;
+}
+
+efitick_t VirtualTriggerStimulator::getCycleDurationNt() const {
+	// same math as setTriggerEmulatorRPM()
+	return (efitick_t)(NT_PER_SECOND * 60.0 / (rpm * rpmMultiplier));
+}
+
+void VirtualTriggerStimulator::scheduleNext() {
+	efitick_t nextNt = cycleStartNt + (efitick_t)(cycleDurationNt * shape->wave.getSwitchTime(index));
+	executor->scheduleByTimestampNt(&scheduling, nextNt, { &VirtualTriggerStimulator::onEvent, this });
+}
+
+void VirtualTriggerStimulator::onEvent(VirtualTriggerStimulator *stimulator) {
+	int size = stimulator->shape->getSize();
+	if (size == 0 || stimulator->rpm <= 0) {
+		stimulator->isActive = false;
+		return;
+	}
+	if (stimulator->index >= size) {
+		// trigger shape has changed under us
+		stimulator->index = 0;
+	}
+	efitick_t nowNt = stimulator->executor->getNowNt();
+
+	// todo: code duplication with TriggerEmulatorHelper::handleEmulatorCallback?
+	constexpr trigger_event_e riseEvents[] = { SHAFT_PRIMARY_RISING, SHAFT_SECONDARY_RISING, SHAFT_3RD_RISING };
+	constexpr trigger_event_e fallEvents[] = { SHAFT_PRIMARY_FALLING, SHAFT_SECONDARY_FALLING, SHAFT_3RD_FALLING };
+	MultiChannelStateSequence *wave = &stimulator->shape->wave;
+	for (int i = 0; i < PWM_PHASE_MAX_WAVE_PER_PWM; i++) {
+		if (needEvent(stimulator->index, size, wave, i)) {
+			pin_state_t currentValue = wave->getChannelState(/*phaseIndex*/i, stimulator->index);
+			stimulator->callback((currentValue ? riseEvents : fallEvents)[i], nowNt);
+			stimulator->eventCounter++;
+		}
+	}
+
+	stimulator->index++;
+	if (stimulator->index == size) {
+		stimulator->index = 0;
+		stimulator->cycleCounter++;
+		stimulator->cycleStartNt += stimulator->cycleDurationNt;
+		stimulator->cycleDurationNt = stimulator->getCycleDurationNt();
+	}
+	stimulator->scheduleNext();
+}
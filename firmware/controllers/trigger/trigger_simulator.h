@@ -27,3 +27,41 @@ private:
 };
 
 bool isUsefulSignal(trigger_event_e signal DECLARE_CONFIG_PARAMETER_SUFFIX);
+
+#include "virtual_clock_executor.h"
+
+typedef void (*ShaftSignalCallback)(trigger_event_e signal, efitick_t timestamp);
+
+/**
+ * Same shape walk as TriggerStimulatorHelper but events are scheduled on virtual clock. Host build with
+ * EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK passes hwHandleShaftSignal() so that events go where real hardware events go
+ * and whole engine control is exercised.
+ */
+class VirtualTriggerStimulator {
+public:
+	VirtualTriggerStimulator(VirtualClockExecutor *executor, TriggerWaveform *shape, ShaftSignalCallback callback);
+	/**
+	 * new RPM is applied at the beginning of next trigger cycle, zero stops stimulation
+	 * @param rpmMultiplier see getRpmMultiplier()
+	 */
+	void setRpm(float rpm, float rpmMultiplier);
+	float getRpm() const;
+	uint32_t eventCounter = 0;
+	uint32_t cycleCounter = 0;
+
+private:
+	static void onEvent(VirtualTriggerStimulator *stimulator);
+	void scheduleNext();
+	efitick_t getCycleDurationNt() const;
+
+	VirtualClockExecutor *executor;
+	TriggerWaveform *shape;
+	ShaftSignalCallback callback;
+	scheduling_s scheduling;
+	float rpm = 0;
+	float rpmMultiplier = 1;
+	int index = 0;
+	efitick_t cycleStartNt = 0;
+	efitick_t cycleDurationNt = 0;
+	bool isActive = false;
+};
@@ -0,0 +1,191 @@
+/**
+ * @file	adc_subscription_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "adc_subscription_test.h"
+#include "functional_sensor.h"
+#include "linear_func.h"
+#include "adc_subscription.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+#include <string.h>
+
+#define ADC_TEST_SENSOR_COUNT 16
+#define ADC_TEST_COUNTS 4095
+#define ADC_TEST_VCC 3.3f
+/**
+ * same as divider coefficient with 1.5 ratio
+ */
+#define ADC_TEST_DIVIDER 1.5f
+
+/**
+ * same linear function but not recognized as one, so that subscription takes the SensorConverter::convert path
+ */
+struct AdcTestIndirectFunc : public SensorConverter {
+	SensorResult convert(float raw) const override {
+		return linear->convert(raw);
+	}
+	const LinearFunc *linear = nullptr;
+};
+
+/**
+ * same converter behind both sensors, sensors are not registered so they do not replace real ones
+ */
+struct AdcTestChannel {
+	AdcTestChannel()
+		: subscribedSensor(SensorType::Invalid, MS2NT(100))
+		, referenceSensor(SensorType::Invalid, MS2NT(100)) {
+	}
+	LinearFunc function;
+	AdcTestIndirectFunc indirectFunction;
+	FunctionalSensor subscribedSensor;
+	FunctionalSensor referenceSensor;
+};
+
+static AdcTestChannel channels[ADC_TEST_SENSOR_COUNT];
+/**
+ * test subscriptions, separate from the ones of real sensors
+ */
+static AdcSubscriptionTable table;
+/**
+ * raw samples of EFI_ADC_0 to EFI_ADC_15
+ */
+static uint16_t frame[ADC_TEST_SENSOR_COUNT];
+// keeps the loops from being optimized away
+static volatile float sink;
+
+static uint32_t seed;
+
+static uint32_t nextRandom(void) {
+	// not really random but repeatable
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16;
+}
+
+static void randomFrame(void) {
+	for (int i = 0; i < ADC_TEST_SENSOR_COUNT; i++) {
+		frame[i] = nextRandom() % (ADC_TEST_COUNTS + 1);
+	}
+}
+
+static int getFrameSample(adc_channel_e channel) {
+	return frame[channel];
+}
+
+static void subscribeAll(int oversampling) {
+	table.reset();
+	for (int i = 0; i < ADC_TEST_SENSOR_COUNT; i++) {
+		table.subscribe(channels[i].subscribedSensor, (adc_channel_e)(EFI_ADC_0 + i), ADC_TEST_DIVIDER, oversampling);
+	}
+}
+
+/**
+ * conversion through the virtual converter, the way it was done before
+ */
+static void postReference(int oversampling, const uint32_t *rawSum, efitick_t nowNt) {
+	for (int i = 0; i < ADC_TEST_SENSOR_COUNT; i++) {
+		float adcVolts = ADC_TEST_VCC * rawSum[i] / oversampling / ADC_TEST_COUNTS;
+		channels[i].referenceSensor.postRawValue(adcVolts * ADC_TEST_DIVIDER, nowNt);
+	}
+}
+
+static bool isClose(float a, float b) {
+	return absF(a - b) <= 0.0001f * maxF(1, absF(b));
+}
+
+/**
+ * @return number of mismatching sensor readings
+ */
+static int compare(int frameCount, int oversampling, bool *isDecimated) {
+	subscribeAll(oversampling);
+	int mismatches = 0;
+	uint32_t rawSum[ADC_TEST_SENSOR_COUNT];
+	for (int f = 0; f < frameCount; f++) {
+		memset(rawSum, 0, sizeof(rawSum));
+		float previousRaw = channels[0].subscribedSensor.getRaw();
+		efitick_t nowNt = getTimeNowNt();
+		for (int o = 0; o < oversampling; o++) {
+			randomFrame();
+			for (int i = 0; i < ADC_TEST_SENSOR_COUNT; i++) {
+				rawSum[i] += frame[i];
+			}
+			if (o == oversampling - 1) {
+				break;
+			}
+			table.update(nowNt, ADC_TEST_VCC / ADC_TEST_COUNTS, &getFrameSample);
+			// nothing is posted until the last frame
+			*isDecimated = *isDecimated && channels[0].subscribedSensor.getRaw() == previousRaw;
+		}
+		table.update(nowNt, ADC_TEST_VCC / ADC_TEST_COUNTS, &getFrameSample);
+		postReference(oversampling, rawSum, nowNt);
+		for (int i = 0; i < ADC_TEST_SENSOR_COUNT; i++) {
+			SensorResult a = channels[i].subscribedSensor.get();
+			SensorResult b = channels[i].referenceSensor.get();
+			bool isOk = isClose(channels[i].subscribedSensor.getRaw(), channels[i].referenceSensor.getRaw()) && a.Valid == b.Valid
+					&& (!a.Valid || isClose(a.Value, b.Value));
+			if (!isOk) {
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+void runAdcSubscriptionTest(Logging *logger, int count) {
+	if (count <= 0) {
+		count = 10000;
+	}
+	for (int i = 0; i < ADC_TEST_SENSOR_COUNT; i++) {
+		// different slopes and ranges so that some readings are out of range
+		channels[i].function.configure(0.5f, i, 4.5f, 100 + 10 * i, i + 5, 90 + 10 * i);
+		channels[i].indirectFunction.linear = &channels[i].function;
+		// last one goes through the virtual converter on both sides
+		if (i == ADC_TEST_SENSOR_COUNT - 1) {
+			channels[i].subscribedSensor.setFunction(channels[i].indirectFunction);
+		} else {
+			channels[i].subscribedSensor.setFunction(channels[i].function);
+		}
+		channels[i].referenceSensor.setFunction(channels[i].function);
+	}
+	seed = 1;
+
+	int failed = 0;
+	static const int oversamplings[] = {1, 4};
+	for (size_t o = 0; o < sizeof(oversamplings) / sizeof(oversamplings[0]); o++) {
+		bool isDecimated = true;
+		int mismatches = compare(count / 10, oversamplings[o], &isDecimated);
+		if (mismatches != 0 || !isDecimated) {
+			failed++;
+		}
+		scheduleMsg(logger, " oversampling %d: %d frames, %d mismatches, decimated=%s %s", oversamplings[o],
+				count / 10, mismatches, boolToString(isDecimated), mismatches == 0 && isDecimated ? "ok" : "FAILED");
+	}
+
+	subscribeAll(1);
+	uint32_t rawSum[ADC_TEST_SENSOR_COUNT];
+	randomFrame();
+	for (int i = 0; i < ADC_TEST_SENSOR_COUNT; i++) {
+		rawSum[i] = frame[i];
+	}
+	efitick_t start = getTimeNowNt();
+	for (int f = 0; f < count; f++) {
+		table.update(start, ADC_TEST_VCC / ADC_TEST_COUNTS, &getFrameSample);
+		sink += channels[f % ADC_TEST_SENSOR_COUNT].subscribedSensor.getRaw();
+	}
+	int subscribedNs = (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+	start = getTimeNowNt();
+	for (int f = 0; f < count; f++) {
+		postReference(1, rawSum, start);
+		sink += channels[f % ADC_TEST_SENSOR_COUNT].referenceSensor.getRaw();
+	}
+	int referenceNs = (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+	scheduleMsg(logger, "%d frames of %d sensors: subscription pass %dns, virtual convert %dns per frame, %d failed",
+			count, ADC_TEST_SENSOR_COUNT, subscribedNs, referenceNs, failed);
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
@@ -0,0 +1,17 @@
+/**
+ * @file	adc_subscription_test.h
+ * @brief AdcSubscriptionTable update pass versus FunctionalSensor::postRawValue
+ *
+ * Random raw ADC frames are fed to a subscription table of its own, the same update pass
+ * AdcSubscription::UpdateSubscribers runs on real samples. Same frames are posted to a second set of sensors through
+ * the virtual converter, results have to match, with and without oversampling. Then both paths are timed for 16 sensors.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runAdcSubscriptionTest(Logging *logger, int count);
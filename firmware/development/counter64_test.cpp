@@ -0,0 +1,105 @@
+/**
+ * @file	counter64_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "counter64_test.h"
+#include "self_test.h"
+#include "counter64.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+#define COUNTER64(high, low) ((efitime_t)(((uint64_t)(high) << 32) | (low)))
+
+static LockFreeCounter64 counter;
+
+static void testOverflow(Logging *logger) {
+	counter.set(0);
+	counter.update(0xFFFFFFF0);
+	selfTestCheck(logger, "before overflow", counter.get() == COUNTER64(0, 0xFFFFFFF0));
+	counter.update(0x10);
+	selfTestCheck(logger, "overflow", counter.get() == COUNTER64(1, 0x10));
+	counter.update(0x10);
+	selfTestCheck(logger, "same value is not an overflow", counter.get() == COUNTER64(1, 0x10));
+
+	bool isMonotonic = true;
+	efitime_t previous = counter.get();
+	uint32_t value = 0x10;
+	// three more overflows in steps which are not a divisor of 2^32
+	for (int i = 0; i < 3 * 16; i++) {
+		value += 0x10000001;
+		counter.update(value);
+		efitime_t current = counter.get();
+		isMonotonic = isMonotonic && current > previous;
+		previous = current;
+	}
+	selfTestCheck(logger, "monotonic over overflows", isMonotonic);
+	selfTestCheck(logger, "overflow count", (uint64_t)counter.get() >> 32 == 4);
+
+	counter.set(COUNTER64(0x12345678, 0x9ABCDEF0));
+	selfTestCheck(logger, "set", counter.get() == COUNTER64(0x12345678, 0x9ABCDEF0));
+	counter.update(0x00000001);
+	selfTestCheck(logger, "update after set", counter.get() == COUNTER64(0x12345679, 0x00000001));
+}
+
+static void testExtend(Logging *logger) {
+	counter64_slot_s snapshot;
+	snapshot.highBits = 1;
+	snapshot.lowBits = 0xFFFFFF00;
+	selfTestCheck(logger, "extend without overflow",
+			LockFreeCounter64::extend(&snapshot, 0xFFFFFF10) == COUNTER64(1, 0xFFFFFF10));
+	selfTestCheck(logger, "extend same value",
+			LockFreeCounter64::extend(&snapshot, 0xFFFFFF00) == COUNTER64(1, 0xFFFFFF00));
+	selfTestCheck(logger, "extend over overflow", LockFreeCounter64::extend(&snapshot, 5) == COUNTER64(2, 5));
+
+	counter.set(COUNTER64(7, 0xFFFFFFFF));
+	uint32_t retriesBefore = counter.retryCounter;
+	counter.snapshot(&snapshot);
+	selfTestCheck(logger, "snapshot", snapshot.highBits == 7 && snapshot.lowBits == 0xFFFFFFFF);
+	selfTestCheck(logger, "snapshot without writer does not retry", counter.retryCounter == retriesBefore);
+}
+
+#if !EFI_UNIT_TEST
+static THD_WORKING_AREA(cachedTimeReaderStack, 256);
+static efitick_t readerTimeNt;
+
+static void cachedTimeReader(void *arg) {
+	(void)arg;
+	readerTimeNt = getTimeNowNtCached();
+}
+
+static void testCachedTimeNow(Logging *logger) {
+	{
+		CachedTimeNowScope timeNow;
+		selfTestCheck(logger, "cached inside scope", getTimeNowNtCached() == timeNow.nowNt);
+		{
+			CachedTimeNowScope nested;
+			selfTestCheck(logger, "nested scope", getTimeNowNtCached() == nested.nowNt && nested.nowNt >= timeNow.nowNt);
+		}
+		selfTestCheck(logger, "nested scope restores outer", getTimeNowNtCached() == timeNow.nowNt);
+
+		// higher priority so that it runs while this scope is still open
+		thread_t *reader = chThdCreateStatic(cachedTimeReaderStack, sizeof(cachedTimeReaderStack), NORMALPRIO + 1,
+				(tfunc_t)(void*) cachedTimeReader, NULL);
+		chThdWait(reader);
+		selfTestCheck(logger, "other thread is not cached", readerTimeNt > timeNow.nowNt);
+	}
+	efitick_t before = getTimeNowNt();
+	selfTestCheck(logger, "live after scope", getTimeNowNtCached() >= before);
+}
+#endif /* EFI_UNIT_TEST */
+
+void runCounter64Test(Logging *logger) {
+	selfTestStart();
+	testOverflow(logger);
+	testExtend(logger);
+#if !EFI_UNIT_TEST
+	testCachedTimeNow(logger);
+#endif /* EFI_UNIT_TEST */
+	scheduleMsg(logger, "counter64: %d failed", selfTestFailedCount());
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
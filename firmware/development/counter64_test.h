@@ -0,0 +1,13 @@
+/**
+ * @file	counter64_test.h
+ * @brief LockFreeCounter64 overflow handling and per-thread cached timestamp checks
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runCounter64Test(Logging *logger);
@@ -9,6 +9,35 @@ DEV_SRC_CPP = $(DEVELOPMENT_DIR)/hw_layer/poten.cpp \
 	$(DEVELOPMENT_DIR)/engine_emulator.cpp \
 	$(DEVELOPMENT_DIR)/engine_sniffer.cpp \
 	$(DEVELOPMENT_DIR)/logic_analyzer.cpp \
+	$(DEVELOPMENT_DIR)/self_test.cpp \
+	$(DEVELOPMENT_DIR)/spi_arbiter_model.cpp \
+	$(DEVELOPMENT_DIR)/knock_dsp_test.cpp \
+	$(DEVELOPMENT_DIR)/gpio_batch_test.cpp \
+	$(DEVELOPMENT_DIR)/counter64_test.cpp \
+	$(DEVELOPMENT_DIR)/ts_frame_parser_test.cpp \
+	$(DEVELOPMENT_DIR)/adc_subscription_test.cpp \
+	$(DEVELOPMENT_DIR)/knock_tracker_test.cpp \
+	$(DEVELOPMENT_DIR)/misfire_test.cpp \
+	$(DEVELOPMENT_DIR)/ve_learner_test.cpp \
+	$(DEVELOPMENT_DIR)/output_channel_groups_test.cpp \
+	$(DEVELOPMENT_DIR)/seqlock_test.cpp \
+	$(DEVELOPMENT_DIR)/virtual_clock_test.cpp \
+	$(DEVELOPMENT_DIR)/engine_sweep.cpp \
+	$(DEVELOPMENT_DIR)/engine_sweep_test.cpp \
 	$(DEVELOPMENT_DIR)/development/perf_trace.cpp
 	
-DEV_SIMULATOR_SRC_CPP = $(DEVELOPMENT_DIR)/engine_sniffer.cpp
\ No newline at end of file
+DEV_SIMULATOR_SRC_CPP = $(DEVELOPMENT_DIR)/engine_sniffer.cpp \
+	$(DEVELOPMENT_DIR)/self_test.cpp \
+	$(DEVELOPMENT_DIR)/spi_arbiter_model.cpp \
+	$(DEVELOPMENT_DIR)/knock_dsp_test.cpp \
+	$(DEVELOPMENT_DIR)/counter64_test.cpp \
+	$(DEVELOPMENT_DIR)/ts_frame_parser_test.cpp \
+	$(DEVELOPMENT_DIR)/adc_subscription_test.cpp \
+	$(DEVELOPMENT_DIR)/knock_tracker_test.cpp \
+	$(DEVELOPMENT_DIR)/misfire_test.cpp \
+	$(DEVELOPMENT_DIR)/ve_learner_test.cpp \
+	$(DEVELOPMENT_DIR)/output_channel_groups_test.cpp \
+	$(DEVELOPMENT_DIR)/seqlock_test.cpp \
+	$(DEVELOPMENT_DIR)/virtual_clock_test.cpp \
+	$(DEVELOPMENT_DIR)/engine_sweep.cpp \
+	$(DEVELOPMENT_DIR)/engine_sweep_test.cpp
\ No newline at end of file
@@ -68,14 +68,80 @@ static LoggingWithStorage logger("wave info");
  */
 static uint32_t skipUntilEngineCycle = 0;
 
-#if ! EFI_UNIT_TEST
 extern WaveChart waveChart;
+
+#if ! EFI_UNIT_TEST
 static void resetNow(void) {
 	skipUntilEngineCycle = getRevolutionCounter() + 3;
 	waveChart.reset();
 }
 #endif
 
+bool EngineSnifferRing::add(const char *name, const char *msg, uint32_t timestampNt) {
+	uint32_t index = __atomic_load_n(&writeIndex, __ATOMIC_RELAXED);
+	do {
+		if (index - __atomic_load_n(&readIndex, __ATOMIC_ACQUIRE) >= ENGINE_SNIFFER_RING_SIZE) {
+			__atomic_fetch_add(&droppedCounter, 1, __ATOMIC_RELAXED);
+			return false;
+		}
+	} while (!__atomic_compare_exchange_n(&writeIndex, &index, index + 1, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	// this slot is now reserved for us
+	engine_sniffer_record_s *record = &records[index & (ENGINE_SNIFFER_RING_SIZE - 1)];
+	record->name = name;
+	record->timestampNt = timestampNt;
+	int i = 0;
+	for (; i < ENGINE_SNIFFER_MSG_LENGTH - 1 && msg[i] != 0; i++) {
+		record->msg[i] = msg[i];
+	}
+	record->msg[i] = 0;
+	__atomic_store_n(&record->sequence, (uint16_t)(index + 1), __ATOMIC_RELEASE);
+	return true;
+}
+
+bool EngineSnifferRing::read(engine_sniffer_record_s *result) {
+	uint32_t index = readIndex;
+	if (index == __atomic_load_n(&writeIndex, __ATOMIC_ACQUIRE)) {
+		return false;
+	}
+	const engine_sniffer_record_s *record = &records[index & (ENGINE_SNIFFER_RING_SIZE - 1)];
+	if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != (uint16_t)(index + 1)) {
+		// slot is reserved but producer has not finished writing it yet
+		return false;
+	}
+	*result = *record;
+	__atomic_store_n(&readIndex, index + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+uint32_t EngineSnifferRing::getPendingCount() const {
+	return __atomic_load_n(&writeIndex, __ATOMIC_ACQUIRE) - __atomic_load_n(&readIndex, __ATOMIC_ACQUIRE);
+}
+
+void EngineSnifferRing::clear() {
+	__atomic_store_n(&readIndex, __atomic_load_n(&writeIndex, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+void decodeEngineSnifferRecord(Logging *logging, const engine_sniffer_record_s *record, uint32_t startTimeNt) {
+	/**
+	 * We want smaller times within a chart in order to reduce packet size.
+	 */
+	uint32_t diffNt = record->timestampNt - startTimeNt;
+	uint32_t time100 = NT2US(diffNt / 10);
+
+	if (remainingSize(logging) > 35) {
+		char timeBuffer[_MAX_FILLER + 2];
+		appendFast(logging, record->name);
+		appendChar(logging, CHART_DELIMETER);
+		appendFast(logging, record->msg);
+		appendChar(logging, CHART_DELIMETER);
+		itoa10(timeBuffer, time100);
+		appendFast(logging, timeBuffer);
+		appendChar(logging, CHART_DELIMETER);
+		logging->linePointer[0] = 0;
+	}
+}
+
 WaveChart::WaveChart() {
 }
 
@@ -89,11 +155,17 @@ void WaveChart::reset() {
 #if DEBUG_WAVE
 	scheduleSimpleMsg(&debugLogging, "reset while at ", counter);
 #endif /* DEBUG_WAVE */
+	bool alreadyLocked = lockOutputBuffer();
 	resetLogging(&logging);
+	// ring has a single consumer at a time, see decodePendingEvents()
+	ring.clear();
 	counter = 0;
 	startTimeNt = 0;
 	collectingData = false;
 	appendPrintf(&logging, "%s%s", PROTOCOL_ENGINE_SNIFFER, DELIMETER);
+	if (!alreadyLocked) {
+		unlockOutputBuffer();
+	}
 }
 
 void WaveChart::startDataCollection() {
@@ -118,6 +190,14 @@ bool WaveChart::isFull() const {
 static void printStatus(void) {
 	scheduleMsg(&logger, "engine chart: %s", boolToString(engineConfiguration->isEngineChartEnabled));
 	scheduleMsg(&logger, "engine chart size=%d", engineConfiguration->engineChartSize);
+	scheduleMsg(&logger, "engine chart binary=%s dropped events=%d", boolToString(waveChart.isBinaryMode),
+			waveChart.ring.droppedCounter);
+}
+
+static void setChartBinaryMode(int value) {
+	waveChart.reset();
+	waveChart.isBinaryMode = value;
+	printStatus();
 }
 
 static void setChartActive(int value) {
@@ -136,7 +216,29 @@ void setChartSize(int newSize) {
 	printStatus();
 }
 
+/**
+ * Converts binary events recorded so far into chart text. Only the publishing thread invokes this, output buffer
+ * lock is still taken per record so that producers are never held off longer than by text mode.
+ */
+void WaveChart::decodePendingEvents() {
+	engine_sniffer_record_s record;
+	while (true) {
+		bool alreadyLocked = lockOutputBuffer();
+		bool hasRecord = ring.read(&record);
+		if (hasRecord) {
+			decodeEngineSnifferRecord(&logging, &record, (uint32_t)startTimeNt);
+		}
+		if (!alreadyLocked) {
+			unlockOutputBuffer();
+		}
+		if (!hasRecord) {
+			return;
+		}
+	}
+}
+
 void WaveChart::publishIfFull() {
+	decodePendingEvents();
 	if (isFull() || isStartedTooLongAgo()) {
 		publish();
 		reset();
@@ -155,6 +257,26 @@ void WaveChart::publish() {
 	}
 }
 
+void WaveChart::addTextEvent(const char *name, const char *msg, efitick_t nowNt) {
+	bool alreadyLocked = lockOutputBuffer(); // we have multiple threads writing to the same output buffer
+
+	if (counter == 0) {
+		startTimeNt = nowNt;
+	}
+	counter++;
+
+	engine_sniffer_record_s record;
+	record.name = name;
+	record.timestampNt = (uint32_t)nowNt;
+	strncpy(record.msg, msg, sizeof(record.msg) - 1);
+	record.msg[sizeof(record.msg) - 1] = 0;
+	decodeEngineSnifferRecord(&logging, &record, (uint32_t)startTimeNt);
+
+	if (!alreadyLocked) {
+		unlockOutputBuffer();
+	}
+}
+
 /**
  * @brief	Register an event for digital sniffer
  */
@@ -194,42 +316,18 @@ void WaveChart::addEvent3(const char *name, const char * msg) {
 
 	efitick_t nowNt = getTimeNowNt();
 
-	bool alreadyLocked = lockOutputBuffer(); // we have multiple threads writing to the same output buffer
-
-	if (counter == 0) {
-		startTimeNt = nowNt;
-	}
-	counter++;
-
-	/**
-	 * We want smaller times within a chart in order to reduce packet size.
-	 */
-	/**
-	 * todo: migrate to binary fractions in order to eliminate
-	 * this division? I do not like division
-	 *
-	 * at least that's 32 bit division now
-	 */
-	uint32_t diffNt = nowNt - startTimeNt;
-	uint32_t time100 = NT2US(diffNt / 10);
-
-	if (remainingSize(&logging) > 35) {
-		/**
-		 * printf is a heavy method, append is used here as a performance optimization
-		 */
-		appendFast(&logging, name);
-		appendChar(&logging, CHART_DELIMETER);
-		appendFast(&logging, msg);
-		appendChar(&logging, CHART_DELIMETER);
-//		time100 -= startTime100;
-
-		itoa10(timeBuffer, time100);
-		appendFast(&logging, timeBuffer);
-		appendChar(&logging, CHART_DELIMETER);
-		logging.linePointer[0] = 0;
-	}
-	if (!alreadyLocked) {
-		unlockOutputBuffer();
+	if (isBinaryMode) {
+		if (__atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED) == 0) {
+			startTimeNt = nowNt;
+		}
+		if (!ring.add(name, msg, (uint32_t)nowNt)) {
+			// chart size only counts events which are actually there
+			__atomic_fetch_sub(&counter, 1, __ATOMIC_RELAXED);
+			warning(CUSTOM_ERR_6658, "engine sniffer dropped %d", ring.droppedCounter);
+			return;
+		}
+	} else {
+		addTextEvent(name, msg, nowNt);
 	}
 #endif /* EFI_TEXT_LOGGING */
 }
@@ -252,6 +350,7 @@ void initWaveChart(WaveChart *chart) {
 
 	addConsoleActionI("chartsize", setChartSize);
 	addConsoleActionI("chart", setChartActive);
+	addConsoleActionI("chartbinary", setChartBinaryMode);
 #if ! EFI_UNIT_TEST
 	addConsoleAction(CMD_RESET_ENGINE_SNIFFER, resetNow);
 #endif
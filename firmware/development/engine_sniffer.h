@@ -13,6 +13,70 @@
 #if EFI_ENGINE_SNIFFER
 #include "datalogging.h"
 
+#define ENGINE_SNIFFER_MSG_LENGTH 8
+/**
+ * Records are converted into chart text only by the publishing thread, so the ring has to hold a complete chart:
+ * this is above the largest engineChartSize which TunerStudio offers.
+ * This must be a power of 2!
+ */
+#define ENGINE_SNIFFER_RING_SIZE 512
+
+/**
+ * Binary sniffer event, see EngineSnifferRing
+ */
+typedef struct {
+	/**
+	 * channel id: pointer to the channel short name, these names are static strings
+	 */
+	const char *name;
+	uint32_t timestampNt;
+	/**
+	 * short messages like edge direction or TDC rpm are copied so that record does not depend on caller buffers
+	 */
+	char msg[ENGINE_SNIFFER_MSG_LENGTH];
+	/**
+	 * lower bits of ring position plus one, written last to mark the record as complete
+	 */
+	volatile uint16_t sequence;
+} engine_sniffer_record_s;
+
+/**
+ * Multiple producer, single consumer ring of binary sniffer events. Producers could be ISRs of different
+ * priorities, the only consumer is the thread which publishes the chart.
+ */
+class EngineSnifferRing {
+public:
+	/**
+	 * lock-free, safe from any context
+	 * @return false if ring is full and event was dropped
+	 */
+	bool add(const char *name, const char *msg, uint32_t timestampNt);
+	/**
+	 * consumer side
+	 * @return false if there is no complete record to read
+	 */
+	bool read(engine_sniffer_record_s *record);
+	/**
+	 * consumer side, drops all pending records
+	 */
+	void clear();
+	/**
+	 * number of reserved records not read yet, including the ones still being written
+	 */
+	uint32_t getPendingCount() const;
+	uint32_t droppedCounter = 0;
+private:
+	engine_sniffer_record_s records[ENGINE_SNIFFER_RING_SIZE];
+	uint32_t writeIndex = 0;
+	uint32_t readIndex = 0;
+};
+
+/**
+ * Converts binary record into the 'name!msg!time!' text understood by rusEfi console.
+ * This has no dependencies on firmware state so it could be used by host tools as well.
+ */
+void decodeEngineSnifferRecord(Logging *logging, const engine_sniffer_record_s *record, uint32_t startTimeNt);
+
 /**
  * @brief	rusEfi console sniffer data buffer
  */
@@ -28,10 +92,18 @@ public:
 	bool isFull() const;
 	bool isStartedTooLongAgo() const;
 	efitick_t pauseEngineSnifferUntilNt = 0;
+	/**
+	 * In binary mode events are recorded into a lock-free ring and converted into text in batches by the
+	 * publishing thread, see 'chartbinary' command.
+	 * Text mode formats every event in the caller context while holding output buffer lock.
+	 */
+	bool isBinaryMode = false;
+	EngineSnifferRing ring;
 
 private:
+	void addTextEvent(const char *name, const char *msg, efitick_t nowNt);
+	void decodePendingEvents();
 	Logging logging;
-	char timeBuffer[_MAX_FILLER + 2];
 	uint32_t counter = 0;
 	/**
 	 * We want to avoid visual jitter thus we want the left edge to be aligned
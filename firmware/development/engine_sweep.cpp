@@ -0,0 +1,159 @@
+/*
+ * @file engine_sweep.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "engine_sweep.h"
+
+void SweepJobQueue::start(int jobCount) {
+	this->jobCount = jobCount;
+	__atomic_store_n(&nextJob, 0, __ATOMIC_RELEASE);
+}
+
+int SweepJobQueue::take() {
+	int index = __atomic_fetch_add(&nextJob, 1, __ATOMIC_ACQ_REL);
+	return index < jobCount ? index : -1;
+}
+
+void sweepValueReset(sweep_value_s *value) {
+	value->min = 0;
+	value->max = 0;
+	value->sum = 0;
+	value->count = 0;
+}
+
+void sweepValueAdd(sweep_value_s *value, float sample) {
+	if (value->count == 0) {
+		value->min = value->max = sample;
+	}
+	value->min = minF(value->min, sample);
+	value->max = maxF(value->max, sample);
+	value->sum += sample;
+	value->count++;
+}
+
+float sweepValueAverage(const sweep_value_s *value) {
+	return value->count == 0 ? 0 : value->sum / value->count;
+}
+
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+
+#include "engine_controller.h"
+#include "trigger_simulator.h"
+#include "trigger_central.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+EXTERN_ENGINE;
+
+#define SWEEP_SAMPLE_PERIOD_US 10000
+/**
+ * first second is cranking and trigger synchronization, not interesting for base map validation
+ */
+#define SWEEP_WARMUP_SECONDS 1
+
+static LoggingWithStorage logger("sweep");
+
+static scheduling_s sampleScheduling;
+
+static void onSample(engine_sweep_result_s *result) {
+	sweepValueAdd(&result->timingAdvance, ENGINE(engineState.timingAdvance));
+	sweepValueAdd(&result->targetAfr, ENGINE(engineState.targetAFR));
+	sweepValueAdd(&result->injectionDurationMs, ENGINE(injectionDuration));
+
+	engine->executor.scheduleForLater(&sampleScheduling, SWEEP_SAMPLE_PERIOD_US, { &onSample, result });
+}
+
+void runEngineSweepJob(const engine_sweep_job_s *job, engine_sweep_result_s *result) {
+	memset(result, 0, sizeof(*result));
+	configuration_callback_t tuneCallback = job->tuneCallback == nullptr ? &emptyCallbackWithConfiguration : job->tuneCallback;
+	resetConfigurationExt(&logger, tuneCallback, job->engineType PASS_ENGINE_PARAMETER_SUFFIX);
+
+	engine->executor.reset();
+	initPeriodicEvents(PASS_ENGINE_PARAMETER_SIGNATURE);
+
+	VirtualTriggerStimulator stimulator(&engine->executor, &ENGINE(triggerCentral.triggerShape), &hwHandleShaftSignal);
+	stimulator.setRpm(job->rpm, getRpmMultiplier(engine->getOperationMode(PASS_ENGINE_PARAMETER_SIGNATURE)));
+
+	engine->executor.runUntil(US2NT(SWEEP_WARMUP_SECONDS * 1000000LL));
+	engine->executor.scheduleForLater(&sampleScheduling, 0, { &onSample, result });
+	// one second at a time so that 64 bit NT math stays away from float precision issues
+	for (int second = SWEEP_WARMUP_SECONDS; second < job->durationSeconds; second++) {
+		engine->executor.runUntil(US2NT((second + 1) * 1000000LL));
+	}
+
+	result->rpm = GET_RPM();
+	result->isSynchronized = engine->triggerCentral.triggerState.shaft_is_synchronized;
+	result->triggerErrorCounter = engine->triggerCentral.triggerState.totalTriggerErrorCounter;
+	result->executedEvents = engine->executor.executeCounter;
+	result->isValid = true;
+	// stimulator and sampling are not needed past this point
+	engine->executor.reset();
+}
+
+int runEngineSweep(const engine_sweep_job_s *jobs, int jobCount, engine_sweep_result_s *results, int workerCount) {
+	// child processes write their results straight into shared memory
+	size_t sharedSize = jobCount * sizeof(engine_sweep_result_s);
+	engine_sweep_result_s *shared = (engine_sweep_result_s *)mmap(nullptr, sharedSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED) {
+		return 0;
+	}
+	memset(shared, 0, sharedSize);
+
+	SweepJobQueue queue;
+	queue.start(jobCount);
+	int running = 0;
+	int index = queue.take();
+	while (index != -1 || running > 0) {
+		if (index != -1 && running < workerCount) {
+			pid_t pid = fork();
+			if (pid == 0) {
+				runEngineSweepJob(&jobs[index], &shared[index]);
+				_exit(0);
+			}
+			if (pid > 0) {
+				running++;
+			}
+			index = queue.take();
+			continue;
+		}
+		int status;
+		if (wait(&status) > 0) {
+			running--;
+		} else {
+			break;
+		}
+	}
+
+	int validCount = 0;
+	for (int i = 0; i < jobCount; i++) {
+		results[i] = shared[i];
+		if (results[i].isValid) {
+			validCount++;
+		}
+	}
+	munmap(shared, sharedSize);
+	return validCount;
+}
+
+void printEngineSweepResult(Logging *logger, const engine_sweep_job_s *job, const engine_sweep_result_s *result) {
+	if (!result->isValid) {
+		scheduleMsg(logger, "%s @%d: FAILED", getEngine_type_e(job->engineType), job->rpm);
+		return;
+	}
+	scheduleMsg(logger, "%s @%d: rpm=%d sync=%d errors=%d advance=%.1f/%.1f/%.1f afr=%.2f/%.2f/%.2f inj=%.2f/%.2fms events=%d",
+			getEngine_type_e(job->engineType), job->rpm, result->rpm, result->isSynchronized,
+			result->triggerErrorCounter, result->timingAdvance.min, sweepValueAverage(&result->timingAdvance),
+			result->timingAdvance.max, result->targetAfr.min, sweepValueAverage(&result->targetAfr),
+			result->targetAfr.max, sweepValueAverage(&result->injectionDurationMs),
+			result->injectionDurationMs.max, result->executedEvents);
+}
+
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
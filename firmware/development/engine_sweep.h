@@ -0,0 +1,89 @@
+/*
+ * @file engine_sweep.h
+ *
+ * Parameter sweep: many independent jobs, each one running on its own virtual clock, spread over
+ * a number of workers. Job queue and statistics do not depend on the engine and are available everywhere,
+ * see 'sweeptest'. Firmware has one global Engine instance so engine preset jobs are host-only: each one runs
+ * in a separate process forked from fully initialized simulator.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+/**
+ * Hands out job indexes to workers: whichever worker is done first takes the next job, so slow jobs do not
+ * hold the others. For independent jobs this balances load the same way a work-stealing pool would.
+ */
+class SweepJobQueue {
+public:
+	void start(int jobCount);
+	/**
+	 * safe to invoke from several workers at the same time
+	 * @return next job index, -1 once all jobs are taken
+	 */
+	int take();
+private:
+	int jobCount = 0;
+	int nextJob = 0;
+};
+
+/**
+ * min/average/max of one sampled value over a job
+ */
+typedef struct {
+	float min;
+	float max;
+	float sum;
+	uint32_t count;
+} sweep_value_s;
+
+void sweepValueReset(sweep_value_s *value);
+void sweepValueAdd(sweep_value_s *value, float sample);
+float sweepValueAverage(const sweep_value_s *value);
+
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+#include "engine.h"
+
+typedef struct {
+	engine_type_e engineType;
+	/**
+	 * applied on top of preset configuration, for instance trigger variant. Could be nullptr
+	 */
+	configuration_callback_t tuneCallback;
+	int rpm;
+	/**
+	 * simulated time
+	 */
+	int durationSeconds;
+} engine_sweep_job_s;
+
+typedef struct {
+	/**
+	 * false if job process has crashed or was not executed
+	 */
+	bool isValid;
+	bool isSynchronized;
+	int rpm;
+	uint32_t triggerErrorCounter;
+	sweep_value_s timingAdvance;
+	sweep_value_s targetAfr;
+	sweep_value_s injectionDurationMs;
+	uint32_t executedEvents;
+} engine_sweep_result_s;
+
+/**
+ * runs one job in current process, global engine state is modified
+ */
+void runEngineSweepJob(const engine_sweep_job_s *job, engine_sweep_result_s *result);
+/**
+ * runs all jobs with up to workerCount jobs at a time, each job in a fresh process
+ * @return number of valid results
+ */
+int runEngineSweep(const engine_sweep_job_s *jobs, int jobCount, engine_sweep_result_s *results, int workerCount);
+void printEngineSweepResult(Logging *logger, const engine_sweep_job_s *job, const engine_sweep_result_s *result);
+
+#endif /* EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK */
@@ -0,0 +1,199 @@
+/**
+ * @file	engine_sweep_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "engine_sweep_test.h"
+#include "self_test.h"
+#include "engine_sweep.h"
+#include "virtual_clock_executor.h"
+#include "trigger_simulator.h"
+#include "engine.h"
+
+#if (EFI_PERF_METRICS || ! EFI_PROD_CODE) && ! EFI_UNIT_TEST
+
+#include <string.h>
+
+EXTERN_ENGINE;
+
+#define SWEEP_TEST_JOBS 8
+#define SWEEP_TEST_WORKERS 2
+#define SWEEP_TEST_SAMPLE_MS 100
+/**
+ * virtual clock, trigger stimulator and sampler of a job are on worker stack
+ */
+#define SWEEP_TEST_STACK_SIZE 1024
+
+typedef struct {
+	int rpm;
+	uint32_t signals;
+	uint32_t cycles;
+	/**
+	 * trigger events per sample period
+	 */
+	sweep_value_s eventRate;
+	uint32_t takenCounter;
+} sweep_test_job_s;
+
+static sweep_test_job_s jobs[SWEEP_TEST_JOBS];
+static sweep_test_job_s sequentialJobs[SWEEP_TEST_JOBS];
+static SweepJobQueue queue;
+static int jobSeconds;
+static float jobRpmMultiplier;
+
+static THD_WORKING_AREA(sweepWorkerStack0, SWEEP_TEST_STACK_SIZE);
+static THD_WORKING_AREA(sweepWorkerStack1, SWEEP_TEST_STACK_SIZE);
+
+typedef struct {
+	VirtualClockExecutor *executor;
+	VirtualTriggerStimulator *stimulator;
+	sweep_test_job_s *job;
+	scheduling_s scheduling;
+	uint32_t previousSignals;
+} sweep_test_sampler_s;
+
+static void onSample(sweep_test_sampler_s *sampler) {
+	uint32_t signals = sampler->stimulator->eventCounter;
+	sweepValueAdd(&sampler->job->eventRate, signals - sampler->previousSignals);
+	sampler->previousSignals = signals;
+	sampler->executor->scheduleForLater(&sampler->scheduling, MS2US(SWEEP_TEST_SAMPLE_MS), { &onSample, sampler });
+}
+
+static void onShaftSignal(trigger_event_e signal, efitick_t timestamp) {
+	// stimulator counts events on its own
+	(void)signal;
+	(void)timestamp;
+}
+
+/**
+ * every job has its own virtual clock so jobs of different workers never see each other
+ */
+static void runJob(sweep_test_job_s *job) {
+	VirtualClockExecutor executor;
+	VirtualTriggerStimulator stimulator(&executor, &engine->triggerCentral.triggerShape, &onShaftSignal);
+	sweep_test_sampler_s sampler;
+	sampler.executor = &executor;
+	sampler.stimulator = &stimulator;
+	sampler.job = job;
+	sampler.previousSignals = 0;
+
+	job->takenCounter++;
+	sweepValueReset(&job->eventRate);
+	stimulator.setRpm(job->rpm, jobRpmMultiplier);
+	executor.scheduleForLater(&sampler.scheduling, MS2US(SWEEP_TEST_SAMPLE_MS), { &onSample, &sampler });
+	for (int i = 1; i <= jobSeconds; i++) {
+		executor.runUntil((efitick_t)i * NT_PER_SECOND);
+	}
+	job->signals = stimulator.eventCounter;
+	job->cycles = stimulator.cycleCounter;
+	// stimulator and sampler are on this stack
+	executor.reset();
+}
+
+static void sweepWorker(void *arg) {
+	(void)arg;
+	int index;
+	while ((index = queue.take()) != -1) {
+		runJob(&jobs[index]);
+		// let other workers of the same priority take the next job
+		chThdYield();
+	}
+}
+
+static void resetJobs() {
+	for (int i = 0; i < SWEEP_TEST_JOBS; i++) {
+		memset(&jobs[i], 0, sizeof(jobs[i]));
+		jobs[i].rpm = 500 + 1000 * i;
+	}
+}
+
+static void testSweepValue(Logging *logger) {
+	sweep_value_s value;
+	sweepValueReset(&value);
+	selfTestCheck(logger, "empty average", sweepValueAverage(&value) == 0);
+	sweepValueAdd(&value, 3);
+	sweepValueAdd(&value, 1);
+	sweepValueAdd(&value, 2);
+	selfTestCheck(logger, "min/max", value.min == 1 && value.max == 3);
+	selfTestCheck(logger, "average", sweepValueAverage(&value) == 2 && value.count == 3);
+}
+
+static void testJobQueue(Logging *logger) {
+	SweepJobQueue local;
+	local.start(2);
+	int first = local.take();
+	int second = local.take();
+	selfTestCheck(logger, "jobs in order", first == 0 && second == 1);
+	selfTestCheck(logger, "no more jobs", local.take() == -1 && local.take() == -1);
+	local.start(0);
+	selfTestCheck(logger, "empty queue", local.take() == -1);
+}
+
+static void testWorkers(Logging *logger) {
+	if (TRIGGER_WAVEFORM(getSize()) == 0) {
+		scheduleMsg(logger, "sweep: no trigger shape, workers skipped");
+		return;
+	}
+	jobRpmMultiplier = getRpmMultiplier(engine->getOperationMode(PASS_ENGINE_PARAMETER_SIGNATURE));
+
+	resetJobs();
+	queue.start(SWEEP_TEST_JOBS);
+	time_t start = currentTimeMillis();
+	sweepWorker(NULL);
+	int sequentialMs = currentTimeMillis() - start;
+	memcpy(sequentialJobs, jobs, sizeof(jobs));
+
+	resetJobs();
+	queue.start(SWEEP_TEST_JOBS);
+	start = currentTimeMillis();
+	thread_t *worker0 = chThdCreateStatic(sweepWorkerStack0, sizeof(sweepWorkerStack0), NORMALPRIO + 1,
+			(tfunc_t)(void*) sweepWorker, NULL);
+	thread_t *worker1 = chThdCreateStatic(sweepWorkerStack1, sizeof(sweepWorkerStack1), NORMALPRIO + 1,
+			(tfunc_t)(void*) sweepWorker, NULL);
+	chThdWait(worker0);
+	chThdWait(worker1);
+	int workersMs = currentTimeMillis() - start;
+
+	bool isTakenOnce = true;
+	bool isSame = true;
+	bool isRateConsistent = true;
+	for (int i = 0; i < SWEEP_TEST_JOBS; i++) {
+		const sweep_test_job_s *job = &jobs[i];
+		const sweep_test_job_s *sequential = &sequentialJobs[i];
+		isTakenOnce = isTakenOnce && job->takenCounter == 1;
+		isSame = isSame && job->signals == sequential->signals && job->cycles == sequential->cycles
+				&& job->eventRate.sum == sequential->eventRate.sum && job->eventRate.min == sequential->eventRate.min
+				&& job->eventRate.max == sequential->eventRate.max;
+		isRateConsistent = isRateConsistent
+				&& (int)job->eventRate.count == jobSeconds * 1000 / SWEEP_TEST_SAMPLE_MS
+				&& job->eventRate.min <= sweepValueAverage(&job->eventRate)
+				&& sweepValueAverage(&job->eventRate) <= job->eventRate.max
+				&& job->eventRate.sum <= job->signals;
+	}
+	selfTestCheck(logger, "each job taken once", isTakenOnce);
+	selfTestCheck(logger, "same results with workers", isSame);
+	selfTestCheck(logger, "event rate statistics", isRateConsistent);
+	selfTestCheck(logger, "faster jobs have more events", jobs[SWEEP_TEST_JOBS - 1].signals > jobs[0].signals);
+
+	for (int i = 0; i < SWEEP_TEST_JOBS; i++) {
+		const sweep_test_job_s *job = &jobs[i];
+		scheduleMsg(logger, " %drpm: %d cycles, events per %dms %.0f/%.1f/%.0f", job->rpm, job->cycles,
+				SWEEP_TEST_SAMPLE_MS, job->eventRate.min, sweepValueAverage(&job->eventRate), job->eventRate.max);
+	}
+	scheduleMsg(logger, "sweep: %d jobs of %ds, one worker %dms, %d workers %dms", SWEEP_TEST_JOBS, jobSeconds,
+			sequentialMs, SWEEP_TEST_WORKERS, workersMs);
+}
+
+void runEngineSweepTest(Logging *logger, int seconds) {
+	selfTestStart();
+	jobSeconds = seconds > 0 ? seconds : 2;
+	testSweepValue(logger);
+	testJobQueue(logger);
+	testWorkers(logger);
+	scheduleMsg(logger, "sweep: %d failed", selfTestFailedCount());
+}
+
+#endif /* (EFI_PERF_METRICS || ! EFI_PROD_CODE) && ! EFI_UNIT_TEST */
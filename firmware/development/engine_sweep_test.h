@@ -0,0 +1,19 @@
+/**
+ * @file	engine_sweep_test.h
+ * @brief Sweep job queue and statistics checks
+ *
+ * Configured trigger shape is stimulated at a range of RPM, one virtual clock per job, first by one worker and then
+ * by several worker threads. Every job has to be taken exactly once and results have to match between the two.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+/**
+ * @param seconds simulated time of each job
+ */
+void runEngineSweepTest(Logging *logger, int seconds);
@@ -0,0 +1,105 @@
+/**
+ * @file	gpio_batch_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "gpio_batch_test.h"
+#include "self_test.h"
+#include "drivers/gpio/gpio_ext.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+typedef struct {
+	int writePortCounter;
+	uint32_t lastMask;
+	uint32_t lastValue;
+	/**
+	 * what the outputs of the chip are after all writes so far
+	 */
+	uint32_t outputs;
+	int returnCode;
+} mock_gpiochip_s;
+
+static int mockWritePort(void *data, uint32_t mask, uint32_t value) {
+	mock_gpiochip_s *chip = (mock_gpiochip_s *)data;
+	chip->writePortCounter++;
+	chip->lastMask = mask;
+	chip->lastValue = value;
+	chip->outputs = (chip->outputs & ~mask) | (value & mask);
+	return chip->returnCode;
+}
+
+static struct gpiochip_ops mockOps;
+
+static void resetMock(mock_gpiochip_s *chip, struct gpiochip_pending *pending) {
+	chip->writePortCounter = 0;
+	chip->lastMask = 0;
+	chip->lastValue = 0;
+	chip->outputs = 0;
+	chip->returnCode = 0;
+	pending->mask = 0;
+	pending->value = 0;
+	pending->count = 0;
+}
+
+void runGpioBatchTest(Logging *logger) {
+	mockOps.writePort = mockWritePort;
+	selfTestStart();
+	mock_gpiochip_s chip;
+	struct gpiochip_pending pending;
+
+	resetMock(&chip, &pending);
+	int ret = gpiochip_pending_flush(&pending, &mockOps, &chip);
+	selfTestCheck(logger, "empty batch is not sent", ret == 0 && chip.writePortCounter == 0);
+
+	resetMock(&chip, &pending);
+	gpiochip_pending_add(&pending, 1, 1);
+	gpiochip_pending_add(&pending, 3, 1);
+	gpiochip_pending_add(&pending, 7, 0);
+	selfTestCheck(logger, "nothing sent before flush", chip.writePortCounter == 0);
+	gpiochip_pending_flush(&pending, &mockOps, &chip);
+	selfTestCheck(logger, "three pins in one writePort", chip.writePortCounter == 1 && chip.lastMask == 0x8A
+			&& chip.lastValue == 0x0A);
+	selfTestCheck(logger, "pending cleared by flush", pending.mask == 0 && pending.count == 0);
+
+	resetMock(&chip, &pending);
+	gpiochip_pending_add(&pending, 2, 1);
+	gpiochip_pending_add(&pending, 2, 0);
+	gpiochip_pending_add(&pending, 2, 1);
+	gpiochip_pending_flush(&pending, &mockOps, &chip);
+	selfTestCheck(logger, "last write of a pin wins", chip.lastMask == 0x04 && chip.lastValue == 0x04
+			&& pending.count == 0);
+
+	resetMock(&chip, &pending);
+	chip.outputs = 0xF0;
+	gpiochip_pending_add(&pending, 0, 1);
+	gpiochip_pending_add(&pending, 4, 0);
+	gpiochip_pending_flush(&pending, &mockOps, &chip);
+	selfTestCheck(logger, "pins outside of mask are kept", chip.outputs == 0xE1);
+
+	// thread batch is open while an ISR opens and closes its own one
+	struct gpiochip_pending threadPending;
+	resetMock(&chip, &pending);
+	resetMock(&chip, &threadPending);
+	gpiochip_pending_add(&threadPending, 0, 1);
+	gpiochip_pending_add(&pending, 5, 1);
+	gpiochip_pending_flush(&pending, &mockOps, &chip);
+	selfTestCheck(logger, "ISR batch is not deferred by open thread batch", chip.writePortCounter == 1
+			&& chip.lastMask == 0x20 && chip.outputs == 0x20);
+	gpiochip_pending_flush(&threadPending, &mockOps, &chip);
+	selfTestCheck(logger, "thread batch does not carry ISR pins", chip.writePortCounter == 2 && chip.lastMask == 0x01
+			&& chip.outputs == 0x21);
+
+	resetMock(&chip, &pending);
+	chip.returnCode = -1;
+	gpiochip_pending_add(&pending, 6, 1);
+	ret = gpiochip_pending_flush(&pending, &mockOps, &chip);
+	selfTestCheck(logger, "driver error is returned", ret == -1 && pending.mask == 0);
+
+	scheduleMsg(logger, "gpio batch: %d failed", selfTestFailedCount());
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
@@ -0,0 +1,16 @@
+/**
+ * @file	gpio_batch_test.h
+ * @brief Smart GPIO chip batching against mock gpiochip_ops
+ *
+ * Pin writes are merged into pending pins and flushed through a mock chip which records every writePort call,
+ * including two batches which are open at the same time as if they belonged to a thread and an ISR.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runGpioBatchTest(Logging *logger);
@@ -14,6 +14,7 @@
 #include "engine_configuration.h"
 #include "engine.h"
 #include "hardware.h"
+#include "spi_arbiter.h"
 #include "mpu_util.h"
 
 #if HAL_USE_SPI
@@ -67,14 +68,12 @@ static int getPotStep(int resistanceWA) {
 }
 
 static void sendToPot(Mcp42010Driver *driver, int channel, int value) {
-	lockSpi(SPI_NONE);
-	spiStart(driver->spi, &driver->spiConfig);
+	spiArbiterAcquire(driver->spi, &driver->spiConfig, SPI_PRIORITY_BULK, 0);
 	spiSelect(driver->spi);
 	int word = (17 + channel) * 256 + value;
 	spiSend(driver->spi, 1, &word);
 	spiUnselect(driver->spi);
-	spiStop(driver->spi);
-	unlockSpi();
+	spiArbiterRelease(driver->spi);
 }
 
 void setPotResistance(Mcp42010Driver *driver, int channel, int resistance) {
@@ -0,0 +1,100 @@
+/**
+ * @file	knock_dsp_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "knock_dsp_test.h"
+#include "knock_dsp.h"
+#include "adc_math.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+#include <math.h>
+
+/**
+ * 86mm bore, see getHIP9011Band()
+ */
+#define KNOCK_TEST_FREQUENCY_HZ 6662
+/**
+ * 8 cylinders at 8000 rpm: one 90 degree firing interval every 1.875ms
+ */
+#define KNOCK_TEST_WINDOWS_PER_SECOND (8 * 8000 / 120)
+#define KNOCK_TEST_WINDOW_SAMPLES 80
+
+typedef struct {
+	const char *name;
+	int sampleCount;
+	float frequencyHz;
+	float amplitude;
+	float noise;
+	float expectedMin;
+	float expectedMax;
+} knock_test_vector_s;
+
+static const knock_test_vector_s vectors[] = {
+	{"in band", KNOCK_TEST_WINDOW_SAMPLES, KNOCK_TEST_FREQUENCY_HZ, 100, 0, 95, 105},
+	{"second mode", KNOCK_TEST_WINDOW_SAMPLES, KNOCK_TEST_FREQUENCY_HZ * 1.66f, 100, 0, 95, 105},
+	{"small in band", 200, KNOCK_TEST_FREQUENCY_HZ, 5, 0, 4, 6},
+	{"full scale", KNOCK_DSP_MAX_SAMPLES, KNOCK_TEST_FREQUENCY_HZ, 1500, 0, 1450, 1550},
+	{"off band", KNOCK_TEST_WINDOW_SAMPLES, 1500, 100, 0, 0, 5},
+	{"noise only", KNOCK_TEST_WINDOW_SAMPLES, KNOCK_TEST_FREQUENCY_HZ, 0, 20, 0, 10},
+	{"knock in noise", KNOCK_TEST_WINDOW_SAMPLES, KNOCK_TEST_FREQUENCY_HZ, 50, 20, 40, 60},
+};
+
+#define KNOCK_TEST_VECTOR_COUNT (sizeof(vectors) / sizeof(vectors[0]))
+
+static uint16_t samples[KNOCK_DSP_MAX_SAMPLES];
+static KnockDsp dsp;
+
+static void generateSamples(const knock_test_vector_s *vector) {
+	// not really random but repeatable
+	uint32_t seed = 1;
+	for (int i = 0; i < vector->sampleCount; i++) {
+		seed = seed * 1103515245 + 12345;
+		float noise = vector->noise * ((int)((seed >> 16) % 2001) - 1000) / 1000;
+		float value = ADC_MAX_VALUE / 2 + noise
+				+ vector->amplitude * sinf(2 * M_PI * vector->frequencyHz * i / KNOCK_SAMPLE_RATE_HZ);
+		samples[i] = (uint16_t)clampF(0, value, ADC_MAX_VALUE);
+	}
+}
+
+void runKnockDspTest(Logging *logger, int count) {
+	if (count <= 0) {
+		count = 1000;
+	}
+	int bandCount = dsp.configure(KNOCK_SAMPLE_RATE_HZ, KNOCK_TEST_FREQUENCY_HZ);
+	scheduleMsg(logger, "knock dsp: %d bands at %dHz sample rate", bandCount, KNOCK_SAMPLE_RATE_HZ);
+
+	int failed = 0;
+	for (size_t i = 0; i < KNOCK_TEST_VECTOR_COUNT; i++) {
+		const knock_test_vector_s *vector = &vectors[i];
+		generateSamples(vector);
+		float intensity = dsp.process(samples, vector->sampleCount);
+		bool isOk = intensity >= vector->expectedMin && intensity <= vector->expectedMax;
+		if (!isOk) {
+			failed++;
+		}
+		scheduleMsg(logger, " %s: %d samples intensity=%.2f expected %.0f..%.0f %s", vector->name,
+				vector->sampleCount, intensity, vector->expectedMin, vector->expectedMax, isOk ? "ok" : "FAILED");
+	}
+
+	const knock_test_vector_s *timed = &vectors[0];
+	generateSamples(timed);
+	// keeps the loop from being optimized away
+	volatile float sink = 0;
+	efitick_t start = getTimeNowNt();
+	for (int i = 0; i < count; i++) {
+		sink += dsp.process(samples, timed->sampleCount);
+	}
+	int windowUs10 = (int)(NT2US(getTimeNowNt() - start) * 10 / count);
+	// share of CPU time in 0.01% units
+	int load = windowUs10 * KNOCK_TEST_WINDOWS_PER_SECOND / 1000;
+	scheduleMsg(logger, "%d windows of %d samples: %d.%dus per window, %d.%02d%% CPU for %d windows/s, %d failed",
+			count, timed->sampleCount, windowUs10 / 10, windowUs10 % 10, load / 100, load % 100,
+			KNOCK_TEST_WINDOWS_PER_SECOND, failed);
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
@@ -0,0 +1,16 @@
+/**
+ * @file	knock_dsp_test.h
+ * @brief Synthetic test vectors and timing for software knock DSP
+ *
+ * In-band, higher mode, off-band and noise-only windows are run through KnockDsp and measured amplitudes are
+ * compared with what was generated, then a 90 degree window is timed against the budget of 8 cylinders at 8000 rpm.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runKnockDspTest(Logging *logger, int count);
@@ -0,0 +1,127 @@
+/**
+ * @file	knock_tracker_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "knock_tracker_test.h"
+#include "self_test.h"
+#include "knock_tracker.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+#define KNOCK_TEST_CYLINDERS 4
+#define KNOCK_TEST_DURATION_MS 20000
+/**
+ * 6000 rpm, one window of each cylinder every two revolutions
+ */
+#define KNOCK_TEST_PERIOD_MS 20
+#define KNOCK_TEST_THRESHOLD 0.6f
+#define KNOCK_TEST_MAX_RETARD 8
+
+#define KNOCK_TEST_QUIET 0
+#define KNOCK_TEST_BURST 1
+#define KNOCK_TEST_NOISY 2
+#define KNOCK_TEST_SPIKES 3
+
+#define KNOCK_TEST_BURST_START_MS 8000
+#define KNOCK_TEST_BURST_END_MS 9000
+/**
+ * noisy cylinder statistics are expected to settle by then
+ */
+#define KNOCK_TEST_WARM_UP_MS 2000
+
+static KnockTracker tracker;
+// keeps the loop from being optimized away
+static volatile float sink;
+
+static uint32_t seed;
+
+/**
+ * @return repeatable noise in -1..1 range
+ */
+static float nextNoise(void) {
+	seed = seed * 1103515245 + 12345;
+	return ((int)((seed >> 16) % 2001) - 1000) / 1000.0f;
+}
+
+static float getSampleVolts(int cylinderIndex, int nowMs) {
+	switch (cylinderIndex) {
+	case KNOCK_TEST_BURST:
+		if (nowMs >= KNOCK_TEST_BURST_START_MS && nowMs < KNOCK_TEST_BURST_END_MS && (nowMs / KNOCK_TEST_PERIOD_MS) % 2 == 0) {
+			return 1.5f;
+		}
+		break;
+	case KNOCK_TEST_NOISY:
+		return 0.8f + 0.3f * nextNoise();
+	case KNOCK_TEST_SPIKES:
+		if (nowMs > 0 && nowMs % 5000 == 0) {
+			return 1.2f;
+		}
+		break;
+	}
+	return 0.2f + 0.05f * nextNoise();
+}
+
+void runKnockTrackerTest(Logging *logger, int count) {
+	if (count <= 0) {
+		count = 100000;
+	}
+	selfTestStart();
+	seed = 1;
+	tracker.reset();
+
+	int knocks[KNOCK_TEST_CYLINDERS] = {};
+	int noisyKnocksAfterWarmUp = 0;
+	float maxRetard = 0;
+	float retardAtBurstEnd = 0;
+	bool isRetardConsistent = true;
+	for (int nowMs = 0; nowMs < KNOCK_TEST_DURATION_MS; nowMs += KNOCK_TEST_PERIOD_MS) {
+		for (int c = 0; c < KNOCK_TEST_CYLINDERS; c++) {
+			bool isKnock = tracker.onKnockSample(c, getSampleVolts(c, nowMs), KNOCK_TEST_THRESHOLD,
+					KNOCK_TEST_MAX_RETARD, nowMs);
+			if (isKnock) {
+				knocks[c]++;
+				if (c == KNOCK_TEST_NOISY && nowMs >= KNOCK_TEST_WARM_UP_MS) {
+					noisyKnocksAfterWarmUp++;
+				}
+			}
+			// what the trigger path reads has to match what was just stored
+			if (absF(tracker.getRetard(c, nowMs) - tracker.retard[c]) > 0.01f) {
+				isRetardConsistent = false;
+			}
+		}
+		maxRetard = maxF(maxRetard, tracker.retard[KNOCK_TEST_BURST]);
+		if (nowMs == KNOCK_TEST_BURST_END_MS) {
+			retardAtBurstEnd = tracker.getRetard(KNOCK_TEST_BURST, nowMs);
+		}
+	}
+	int endMs = KNOCK_TEST_DURATION_MS - KNOCK_TEST_PERIOD_MS;
+	float retardAtEnd = tracker.getRetard(KNOCK_TEST_BURST, endMs);
+	float expectedAtEnd = retardAtBurstEnd - (endMs - KNOCK_TEST_BURST_END_MS) * (KNOCK_RETARD_DECAY_DEG_PER_SECOND / 1000);
+
+	selfTestCheck(logger, "quiet cylinder does not knock", knocks[KNOCK_TEST_QUIET] == 0);
+	selfTestCheck(logger, "burst retard reaches limit", maxRetard == KNOCK_TEST_MAX_RETARD);
+	selfTestCheck(logger, "burst retard decays", absF(retardAtEnd - expectedAtEnd) < 0.1f);
+	selfTestCheck(logger, "no retard once decayed", tracker.getRetard(KNOCK_TEST_BURST, endMs + 60000) == 0);
+	selfTestCheck(logger, "noisy cylinder does not knock after warm up", noisyKnocksAfterWarmUp == 0);
+	selfTestCheck(logger, "single spikes are knock", knocks[KNOCK_TEST_SPIKES] == 3);
+	selfTestCheck(logger, "other cylinders are not retarded", tracker.getRetard(KNOCK_TEST_QUIET, endMs) == 0
+			&& tracker.getRetard(KNOCK_TEST_NOISY, endMs) == 0);
+	selfTestCheck(logger, "getRetard matches stored retard", isRetardConsistent);
+	scheduleMsg(logger, " burst: %d knocks, retard %.2f at end of burst, %.2f after %ds", knocks[KNOCK_TEST_BURST],
+			retardAtBurstEnd, retardAtEnd, (endMs - KNOCK_TEST_BURST_END_MS) / 1000);
+
+	efitick_t start = getTimeNowNt();
+	for (int i = 0; i < count; i++) {
+		int c = i % KNOCK_TEST_CYLINDERS;
+		tracker.onKnockSample(c, 0.2f + (i & 7) * 0.01f, KNOCK_TEST_THRESHOLD, KNOCK_TEST_MAX_RETARD, i);
+		sink += tracker.getRetard(c, i);
+	}
+	int ns = (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+	scheduleMsg(logger, "knock tracker: %dns per window, %d failed", ns, selfTestFailedCount());
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
@@ -0,0 +1,17 @@
+/**
+ * @file	knock_tracker_test.h
+ * @brief Replay of a synthetic knock trace through KnockTracker
+ *
+ * Four cylinders at 6000 rpm for 20 seconds: a quiet one, one with a one second knock burst, a mechanically noisy one
+ * and one with single spikes. Knock detection, retard build up and decay are checked, then one window plus
+ * getRetard() is timed.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runKnockTrackerTest(Logging *logger, int count);
@@ -0,0 +1,292 @@
+/**
+ * @file	misfire_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "misfire_test.h"
+#include "self_test.h"
+#include "misfire_analyzer.h"
+#include "obd_error_codes.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+#include <math.h>
+
+#define MISFIRE_TEST_TEETH 120
+#define MISFIRE_TEST_TOOTH_DEG (720 / MISFIRE_TEST_TEETH)
+#define MISFIRE_TEST_CYLINDERS 4
+/**
+ * four evaluation windows
+ */
+#define MISFIRE_TEST_CYCLES (4 * MISFIRE_WINDOW_CYCLES)
+/**
+ * crank inertia, kg*m^2
+ */
+#define MISFIRE_TEST_INERTIA 0.15f
+/**
+ * peak compression torque, N*m
+ */
+#define MISFIRE_TEST_COMPRESSION 40.0f
+#define MISFIRE_TEST_JITTER_US 0.5f
+#define MISFIRE_TEST_NO_CYLINDER -1
+/**
+ * analyzer warm-up, misfires are only injected after that
+ */
+#define MISFIRE_TEST_WARMUP_CYCLES 40
+/**
+ * speed transient of a scenario starts here, one evaluation window in
+ */
+#define MISFIRE_TEST_TRANSIENT_CYCLE MISFIRE_WINDOW_CYCLES
+
+typedef struct {
+	const char *name;
+	float rpm;
+	float loadPercent;
+	/**
+	 * firing order position which misfires with misfireRate, MISFIRE_TEST_NO_CYLINDER for random cylinder
+	 */
+	int misfirePosition;
+	float misfireRate;
+	/**
+	 * firing order position with 80% power, MISFIRE_TEST_NO_CYLINDER if none
+	 */
+	int weakPosition;
+	/**
+	 * crank slows down at this rate, negative for acceleration
+	 */
+	float decelRpmPerSecond;
+} misfire_scenario_s;
+
+typedef struct {
+	int injected[MISFIRE_TEST_CYLINDERS];
+	int windowCounter;
+	int lastCode;
+	bool hasRandomCode;
+} misfire_result_s;
+
+static MisfireAnalyzer analyzer;
+static angle_t eventAngles[MISFIRE_TEST_TEETH];
+static const angle_t cylinderAngles[MISFIRE_TEST_CYLINDERS] = {0, 180, 360, 540};
+static const int cylinderIds[MISFIRE_TEST_CYLINDERS] = {1, 3, 4, 2};
+
+static uint32_t seed;
+
+static uint32_t nextRandom(void) {
+	// not really random but repeatable
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16;
+}
+
+/**
+ * @return repeatable noise in -1..1 range
+ */
+static float nextNoise(void) {
+	return ((int)(nextRandom() % 2001) - 1000) / 1000.0f;
+}
+
+static bool nextChance(float probability) {
+	return (nextRandom() % 10000) < probability * 10000;
+}
+
+/**
+ * @return integral of sin(x) from a to b, radians
+ */
+static float sinIntegral(float a, float b) {
+	return cosf(a) - cosf(b);
+}
+
+/**
+ * work of one cylinder over one tooth: combustion over the power stroke, compression before TDC
+ */
+static float getCylinderWork(float phaseDeg, float combustionTorque) {
+	float from = phaseDeg * (float)M_PI / 180;
+	float to = (phaseDeg + MISFIRE_TEST_TOOTH_DEG) * (float)M_PI / 180;
+	if (phaseDeg < 180) {
+		return combustionTorque * sinIntegral(from, to);
+	} else if (phaseDeg >= 540) {
+		return -MISFIRE_TEST_COMPRESSION * sinIntegral(from - 3 * (float)M_PI, to - 3 * (float)M_PI);
+	}
+	return 0;
+}
+
+static void runScenario(const misfire_scenario_s *s, misfire_result_s *result) {
+	analyzer.configure(eventAngles, MISFIRE_TEST_TEETH, cylinderAngles, cylinderIds, MISFIRE_TEST_CYLINDERS, 720);
+	memset(result, 0, sizeof(*result));
+
+	float peakTorque = MISFIRE_TEST_COMPRESSION + 120 * s->loadPercent / 100;
+	float nominalSpeed = s->rpm * 2 * (float)M_PI / 60;
+	// load which balances a healthy engine at nominal speed
+	float nominalLoadTorque = (peakTorque - MISFIRE_TEST_COMPRESSION) * 2 / (float)M_PI;
+	float toothRad = MISFIRE_TEST_TOOTH_DEG * (float)M_PI / 180;
+	float combustionTorque[MISFIRE_TEST_CYLINDERS] = {};
+
+	float speed = nominalSpeed;
+	// load follows target speed, extra torque makes the crank slow down or speed up at scenario rate
+	float targetSpeed = nominalSpeed;
+	float decelTorque = 0;
+	efitick_t nowNt = 0;
+	efitick_t transientStartNt = 0;
+	// sub-tick part of the time, so that rounding does not accumulate
+	float remainderNt = 0;
+	for (int cycle = 0; cycle < MISFIRE_TEST_CYCLES; cycle++) {
+		if (cycle == MISFIRE_TEST_TRANSIENT_CYCLE) {
+			// transient only starts once the analyzer has learned steady state
+			decelTorque = MISFIRE_TEST_INERTIA * s->decelRpmPerSecond * 2 * (float)M_PI / 60;
+			transientStartNt = nowNt;
+		}
+		for (int tooth = 0; tooth < MISFIRE_TEST_TEETH; tooth++) {
+			angle_t angle = tooth * MISFIRE_TEST_TOOTH_DEG;
+			float work = -(nominalLoadTorque * (speed / targetSpeed) + decelTorque) * toothRad;
+			for (int p = 0; p < MISFIRE_TEST_CYLINDERS; p++) {
+				if (angle == cylinderAngles[p]) {
+					// combustion of this cylinder is decided at its TDC, first cycles are always healthy
+					bool isMisfire = cycle > MISFIRE_TEST_WARMUP_CYCLES && (s->misfirePosition == MISFIRE_TEST_NO_CYLINDER || s->misfirePosition == p)
+							&& nextChance(s->misfireRate);
+					if (isMisfire) {
+						result->injected[p]++;
+					}
+					float strength = p == s->weakPosition ? 0.8f : 1;
+					combustionTorque[p] = isMisfire ? MISFIRE_TEST_COMPRESSION : peakTorque * strength * (1 + 0.03f * nextNoise());
+				}
+				float phase = angle - cylinderAngles[p];
+				work += getCylinderWork(phase < 0 ? phase + 720 : phase, combustionTorque[p]);
+			}
+			float nextSpeed = sqrtf(maxF(1, speed * speed + 2 * work / MISFIRE_TEST_INERTIA));
+			float durationNt = toothRad / ((speed + nextSpeed) / 2) * US_PER_SECOND_F * US_TO_NT_MULTIPLIER + remainderNt;
+			nowNt += (efitick_t)durationNt;
+			remainderNt = durationNt - (efitick_t)durationNt;
+			speed = nextSpeed;
+			if (cycle >= MISFIRE_TEST_TRANSIENT_CYCLE) {
+				float seconds = (nowNt - transientStartNt) / (US_PER_SECOND_F * US_TO_NT_MULTIPLIER);
+				targetSpeed = clampF(nominalSpeed / 4,
+						nominalSpeed - s->decelRpmPerSecond * 2 * (float)M_PI / 60 * seconds, nominalSpeed * 2);
+			}
+
+			efitick_t toothNt = nowNt + (efitick_t)(MISFIRE_TEST_JITTER_US * US_TO_NT_MULTIPLIER * nextNoise());
+			// next tooth is the one which has just passed
+			int index = (tooth + 1) % MISFIRE_TEST_TEETH;
+			if (analyzer.onTriggerEvent(index, toothNt, s->loadPercent)) {
+				result->windowCounter++;
+				result->lastCode = analyzer.lastMisfireCode;
+				if (analyzer.lastMisfireCode == OBD_Random_Multiple_Cylinder_Misfire) {
+					result->hasRandomCode = true;
+				}
+			}
+		}
+	}
+}
+
+static int getTotalMisfires(void) {
+	int result = 0;
+	for (int c = 0; c < MISFIRE_TEST_CYLINDERS; c++) {
+		result += analyzer.misfireCounter[c];
+	}
+	return result;
+}
+
+static float getNextWeakest(int weakIndex) {
+	float result = 0;
+	bool isFirst = true;
+	for (int c = 0; c < MISFIRE_TEST_CYLINDERS; c++) {
+		if (c != weakIndex && (isFirst || analyzer.contribution[c] < result)) {
+			result = analyzer.contribution[c];
+			isFirst = false;
+		}
+	}
+	return result;
+}
+
+/**
+ * state arrays are by cylinder number
+ */
+static int getStateIndex(int position) {
+	return cylinderIds[position] - 1;
+}
+
+void runMisfireTest(Logging *logger, int count) {
+	if (count <= 0) {
+		count = 100000;
+	}
+	for (int i = 0; i < MISFIRE_TEST_TEETH; i++) {
+		eventAngles[i] = i * MISFIRE_TEST_TOOTH_DEG;
+	}
+	selfTestStart();
+	seed = 1;
+	misfire_result_s result;
+
+	static const misfire_scenario_s healthy[] = {
+		{"healthy idle", 800, 30, 0, 0, MISFIRE_TEST_NO_CYLINDER, 0},
+		{"healthy 3000 rpm", 3000, 50, 0, 0, MISFIRE_TEST_NO_CYLINDER, 0},
+		{"healthy 6500 rpm wot", 6500, 100, 0, 0, MISFIRE_TEST_NO_CYLINDER, 0},
+	};
+	for (size_t i = 0; i < sizeof(healthy) / sizeof(healthy[0]); i++) {
+		runScenario(&healthy[i], &result);
+		selfTestCheck(logger, healthy[i].name, getTotalMisfires() == 0 && result.lastCode == 0
+				&& result.windowCounter == MISFIRE_TEST_CYCLES / MISFIRE_WINDOW_CYCLES);
+	}
+
+	static const misfire_scenario_s single = {"5% misfire at 2500 rpm", 2500, 40, 2, 0.05f, MISFIRE_TEST_NO_CYLINDER, 0};
+	runScenario(&single, &result);
+	int misfireIndex = getStateIndex(single.misfirePosition);
+	int detected = analyzer.misfireCounter[misfireIndex];
+	selfTestCheck(logger, single.name, detected >= result.injected[single.misfirePosition] * 9 / 10
+			&& detected <= result.injected[single.misfirePosition] && getTotalMisfires() == detected);
+	scheduleMsg(logger, "  %d of %d detected on cylinder %d", detected, result.injected[single.misfirePosition],
+			misfireIndex + 1);
+
+	static const misfire_scenario_s random = {"random 4% misfire at 3500 rpm", 3500, 60, MISFIRE_TEST_NO_CYLINDER, 0.04f,
+			MISFIRE_TEST_NO_CYLINDER, 0};
+	runScenario(&random, &result);
+	selfTestCheck(logger, random.name, result.hasRandomCode);
+
+	static const misfire_scenario_s weak = {"weak cylinder at 2000 rpm", 2000, 50, 0, 0, 3, 0};
+	runScenario(&weak, &result);
+	int weakIndex = getStateIndex(weak.weakPosition);
+	bool isWeakest = analyzer.contribution[weakIndex] < getNextWeakest(weakIndex);
+	bool isLastWindowClean = true;
+	for (int c = 0; c < MISFIRE_TEST_CYLINDERS; c++) {
+		isLastWindowClean = isLastWindowClean && analyzer.windowMisfireCounter[c] == 0;
+	}
+	// until contribution of the weak cylinder has settled its strokes could still look like a misfire
+	selfTestCheck(logger, weak.name, isWeakest && isLastWindowClean && result.lastCode == 0);
+	scheduleMsg(logger, "  contribution %.1f against %.1f of the next weakest cylinder, %d misfires while learning",
+			analyzer.contribution[weakIndex], getNextWeakest(weakIndex), getTotalMisfires());
+
+	static const misfire_scenario_s transients[] = {
+		{"coast-down 100 rpm/s at 2500 rpm", 2500, 30, 0, 0, MISFIRE_TEST_NO_CYLINDER, 100},
+		{"coast-down 300 rpm/s at 2500 rpm", 2500, 30, 0, 0, MISFIRE_TEST_NO_CYLINDER, 300},
+		// beyond deceleration limit
+		{"coast-down 1000 rpm/s at 2500 rpm", 2500, 30, 0, 0, MISFIRE_TEST_NO_CYLINDER, 1000},
+		{"accelerating 300 rpm/s at 1500 rpm", 1500, 80, 0, 0, MISFIRE_TEST_NO_CYLINDER, -300},
+	};
+	for (size_t i = 0; i < sizeof(transients) / sizeof(transients[0]); i++) {
+		runScenario(&transients[i], &result);
+		selfTestCheck(logger, transients[i].name, getTotalMisfires() == 0 && result.lastCode == 0);
+		scheduleMsg(logger, "  %d false misfires", getTotalMisfires());
+	}
+
+	static const misfire_scenario_s slowing = {"5% misfire while slowing down 300 rpm/s", 3000, 40, 1, 0.05f,
+			MISFIRE_TEST_NO_CYLINDER, 300};
+	runScenario(&slowing, &result);
+	misfireIndex = getStateIndex(slowing.misfirePosition);
+	detected = analyzer.misfireCounter[misfireIndex];
+	selfTestCheck(logger, slowing.name, detected >= result.injected[slowing.misfirePosition] * 9 / 10
+			&& detected <= result.injected[slowing.misfirePosition] && getTotalMisfires() == detected);
+	scheduleMsg(logger, "  %d of %d detected on cylinder %d", detected, result.injected[slowing.misfirePosition],
+			misfireIndex + 1);
+
+	analyzer.configure(eventAngles, MISFIRE_TEST_TEETH, cylinderAngles, cylinderIds, MISFIRE_TEST_CYLINDERS, 720);
+	efitick_t toothNt = 0;
+	efitick_t start = getTimeNowNt();
+	for (int i = 0; i < count; i++) {
+		toothNt += US2NT(100) + (i & 15);
+		analyzer.onTriggerEvent(i % MISFIRE_TEST_TEETH, toothNt, 50);
+	}
+	int ns = (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+	scheduleMsg(logger, "misfire: %dns per tooth, %d failed", ns, selfTestFailedCount());
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
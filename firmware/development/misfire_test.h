@@ -0,0 +1,17 @@
+/**
+ * @file	misfire_test.h
+ * @brief Synthetic crank speed waveforms run through MisfireAnalyzer
+ *
+ * A four cylinder engine with a 120 tooth wheel is simulated in the angle domain: each tooth crank energy changes by
+ * combustion and compression torque of the cylinders and by load, tooth timestamps get some jitter. Healthy engine,
+ * single cylinder misfire, random misfire and a weak cylinder are checked, then the cost of one tooth is timed.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runMisfireTest(Logging *logger, int count);
@@ -0,0 +1,118 @@
+/**
+ * @file	output_channel_groups_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "output_channel_groups_test.h"
+#include "self_test.h"
+#include "output_channel_groups.h"
+#include "status_loop.h"
+
+#if (EFI_PERF_METRICS || ! EFI_PROD_CODE) && EFI_TUNER_STUDIO
+
+/**
+ * TunerStudio default polling rate
+ */
+#define OCH_TEST_REQUEST_PERIOD_MS 50
+
+#define OCH_TEST_DASHBOARD_GROUPS ((1 << OCG_FAST_SENSORS) | (1 << OCG_SLOW_SENSORS) | (1 << OCG_FUEL) | (1 << OCG_IGNITION))
+
+/**
+ * producers write here so that the test does not disturb what TunerStudio reads
+ */
+static TunerStudioOutputChannels scratchChannels;
+
+/**
+ * same periods as initOutputChannelGroups()
+ */
+static void setDefaultPeriods(OutputChannelGroups *groups) {
+	groups->setRefreshPeriod(OCG_SLOW_SENSORS, 200);
+	groups->setRefreshPeriod(OCG_STATUS, 100);
+	groups->setRefreshPeriod(OCG_VERSION, 1000);
+}
+
+static void checkGroups(Logging *logger) {
+	OutputChannelGroups groups;
+	setDefaultPeriods(&groups);
+	groups.subscribe(OCS_TUNER_STUDIO, OCG_ALL);
+	groups.subscribe(OCS_SD_LOG, 1 << OCG_DEBUG);
+
+	bool isOk = groups.getDueGroups(OCS_TUNER_STUDIO, 1000) == OCG_ALL;
+	selfTestCheck(logger, "first request produces everything", isOk);
+
+	uint32_t fastGroups = (1 << OCG_FAST_SENSORS) | (1 << OCG_FUEL) | (1 << OCG_IGNITION) | (1 << OCG_DEBUG);
+	isOk = groups.getDueGroups(OCS_TUNER_STUDIO, 1050) == fastGroups
+			&& groups.getDueGroups(OCS_TUNER_STUDIO, 1100) == (fastGroups | (1 << OCG_STATUS))
+			&& groups.getDueGroups(OCS_TUNER_STUDIO, 1200) == (fastGroups | (1 << OCG_STATUS) | (1 << OCG_SLOW_SENSORS))
+			&& groups.getDueGroups(OCS_TUNER_STUDIO, 2000) == OCG_ALL;
+	selfTestCheck(logger, "refresh periods", isOk);
+
+	// TunerStudio has just produced debug group, log copy still has nothing
+	isOk = groups.getDueGroups(OCS_SD_LOG, 2000) == (1 << OCG_DEBUG);
+	selfTestCheck(logger, "subscribers are independent", isOk);
+
+	groups.invalidate(1 << OCG_VERSION);
+	groups.subscribe(OCS_SD_LOG, (1 << OCG_DEBUG) | (1 << OCG_VERSION));
+	isOk = (groups.getDueGroups(OCS_TUNER_STUDIO, 2010) & (1 << OCG_VERSION)) != 0
+			&& (groups.getDueGroups(OCS_SD_LOG, 2010) & (1 << OCG_VERSION)) != 0
+			&& (groups.getDueGroups(OCS_TUNER_STUDIO, 2020) & (1 << OCG_VERSION)) == 0;
+	selfTestCheck(logger, "invalidate reaches every subscriber", isOk);
+
+	groups.subscribe(OCS_TUNER_STUDIO, 1 << OCG_FAST_SENSORS);
+	groups.getDueGroups(OCS_TUNER_STUDIO, 2030);
+	groups.subscribe(OCS_TUNER_STUDIO, (1 << OCG_FAST_SENSORS) | (1 << OCG_SLOW_SENSORS));
+	isOk = groups.getDueGroups(OCS_TUNER_STUDIO, 2040) == ((1 << OCG_FAST_SENSORS) | (1 << OCG_SLOW_SENSORS));
+	selfTestCheck(logger, "subscribe makes added groups stale", isOk);
+
+	OutputChannelGroups wrapping;
+	setDefaultPeriods(&wrapping);
+	wrapping.subscribe(OCS_TUNER_STUDIO, 1 << OCG_VERSION);
+	efitimems_t nearOverflowMs = (efitimems_t)-500;
+	wrapping.getDueGroups(OCS_TUNER_STUDIO, nearOverflowMs);
+	isOk = wrapping.getDueGroups(OCS_TUNER_STUDIO, nearOverflowMs + 900) == 0
+			&& wrapping.getDueGroups(OCS_TUNER_STUDIO, nearOverflowMs + 1000) == (1 << OCG_VERSION);
+	selfTestCheck(logger, "millisecond counter overflow", isOk);
+}
+
+/**
+ * @param isGrouped false to produce everything on every request, the way it was before groups
+ * @return average nanoseconds per request
+ */
+static int measure(uint32_t groupMask, bool isGrouped, int count) {
+	OutputChannelGroups groups;
+	setDefaultPeriods(&groups);
+	groups.subscribe(OCS_TUNER_STUDIO, groupMask);
+	efitick_t start = getTimeNowNt();
+	for (int i = 0; i < count; i++) {
+		uint32_t due = isGrouped ? groups.getDueGroups(OCS_TUNER_STUDIO, i * OCH_TEST_REQUEST_PERIOD_MS) : OCG_ALL;
+		produceOutputChannelGroups(&scratchChannels, due);
+	}
+	return (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+}
+
+static int getSavedPercent(int ns, int fullNs) {
+	return fullNs == 0 ? 0 : 100 - 100 * ns / fullNs;
+}
+
+void runOutputChannelGroupsTest(Logging *logger, int count) {
+	if (count <= 0) {
+		count = 1000;
+	}
+	selfTestStart();
+	checkGroups(logger);
+
+	int fullNs = measure(OCG_ALL, false, count);
+	int allNs = measure(OCG_ALL, true, count);
+	int dashboardNs = measure(OCH_TEST_DASHBOARD_GROUPS, true, count);
+	int fastNs = measure(1 << OCG_FAST_SENSORS, true, count);
+	scheduleMsg(logger, "%d 'O' requests at %dms: everything %dns", count, OCH_TEST_REQUEST_PERIOD_MS, fullNs);
+	scheduleMsg(logger, " all groups %dns, %d%% saved", allNs, getSavedPercent(allNs, fullNs));
+	scheduleMsg(logger, " gauge dashboard %dns, %d%% saved", dashboardNs, getSavedPercent(dashboardNs, fullNs));
+	scheduleMsg(logger, " fast sensors only %dns, %d%% saved, %d failed", fastNs, getSavedPercent(fastNs, fullNs),
+			selfTestFailedCount());
+}
+
+#endif /* (EFI_PERF_METRICS || ! EFI_PROD_CODE) && EFI_TUNER_STUDIO */
@@ -0,0 +1,17 @@
+/**
+ * @file	output_channel_groups_test.h
+ * @brief Cost of one TunerStudio 'O' request with and without output channel groups
+ *
+ * Refresh periods and per-subscriber state of OutputChannelGroups are checked on a private instance, then real
+ * producers are run into a scratch buffer as if TunerStudio was polling at 20Hz: everything on every request, all
+ * groups with refresh periods, gauge dashboard groups only and fast sensors only.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runOutputChannelGroupsTest(Logging *logger, int count);
@@ -16,10 +16,28 @@
 
 #include "console_io.h"
 #include "engine.h"
+#include "engine_sniffer.h"
+#include "rpm_calculator.h"
+#include "counter64.h"
+#include "spi_arbiter_model.h"
+#include "knock_dsp_test.h"
+#include "gpio_batch_test.h"
+#include "counter64_test.h"
+#include "ts_frame_parser_test.h"
+#include "adc_subscription_test.h"
+#include "knock_tracker_test.h"
+#include "misfire_test.h"
+#include "ve_learner_test.h"
+#include "output_channel_groups_test.h"
+#include "seqlock_test.h"
+#include "virtual_clock_test.h"
+#include "engine_sweep_test.h"
 
 #if EFI_PERF_METRICS
 #include "test.h"
 
+EXTERN_ENGINE;
+
 static Logging* logger;
 
 static void testSystemCalls(const int count) {
@@ -252,14 +270,322 @@ static void testMath(const int count) {
 	}
 }
 
+static int perfTestConsoleValue;
+
+static void perfTestConsoleAction(int value, float value2) {
+	perfTestConsoleValue += value + (int)value2;
+}
+
+static void testConsoleDispatch(const int count) {
+	static bool isActionRegistered = false;
+	if (!isActionRegistered) {
+		addConsoleActionIF("perftest_noop", perfTestConsoleAction);
+		isActionRegistered = true;
+	}
+
+	static const char line[] = "perftest_noop 1 2.5";
+	time_t start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		handleConsoleLineInternal(line, sizeof(line) - 1);
+	}
+	time_t time = currentTimeMillis() - start;
+	if (perfTestConsoleValue != 0) {
+		scheduleMsg(logger, "Finished %d iterations of console command dispatch in %dms", count, time);
+	}
+}
+
+static void testCyclicBuffer(const int count) {
+	static cyclic_buffer<int> buffer;
+	static static_cyclic_buffer<int, 8, 6> staticBuffer;
+	int tempi = 0;
+
+	time_t start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		buffer.add(i & 1);
+		tempi += buffer.sum(6) + buffer.maxValue(6);
+	}
+	time_t time = currentTimeMillis() - start;
+	if (tempi != 0) {
+		scheduleMsg(logger, "Finished %d iterations of cyclic_buffer add/sum/max in %dms", count, time);
+	}
+
+	start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		staticBuffer.add(i & 1);
+		tempi += staticBuffer.getSum() + staticBuffer.getMax();
+	}
+	time = currentTimeMillis() - start;
+	if (tempi != 0) {
+		scheduleMsg(logger, "Finished %d iterations of static_cyclic_buffer add/sum/max in %dms", count, time);
+	}
+}
+
+#define PERF_TEST_VALUES_PER_LINE 20
+
+static void testFloatFormatting(const int count) {
+	static char buffer[400];
+	static Logging lineLogger("perftest line", buffer, sizeof(buffer));
+
+	time_t start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		resetLogging(&lineLogger);
+		for (int j = 0; j < PERF_TEST_VALUES_PER_LINE; j++) {
+			appendPrintf(&lineLogger, "%.2f\t", i * 0.37f + j);
+		}
+	}
+	time_t time = currentTimeMillis() - start;
+	scheduleMsg(logger, "Finished %d lines of %d floats with appendPrintf in %dms", count, PERF_TEST_VALUES_PER_LINE, time);
+
+	start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		resetLogging(&lineLogger);
+		for (int j = 0; j < PERF_TEST_VALUES_PER_LINE; j++) {
+			appendFloat(&lineLogger, i * 0.37f + j, 2);
+			append(&lineLogger, "\t");
+		}
+	}
+	time = currentTimeMillis() - start;
+	scheduleMsg(logger, "Finished %d lines of %d floats with appendFloat in %dms", count, PERF_TEST_VALUES_PER_LINE, time);
+}
+
+#define ANGLE_TEST_TOOTH 6.0
+#define ANGLE_TEST_REVOLUTIONS 20
+/**
+ * integration step of simulated crankshaft motion, degrees
+ */
+#define ANGLE_TEST_STEP 0.1
+
+typedef struct {
+	const char *name;
+	/**
+	 * each tooth edge is off its nominal angle by up to this much, same error every revolution
+	 */
+	double toothError;
+	/**
+	 * trigger ISR latency varies by up to this much, seconds
+	 */
+	double jitter;
+	/**
+	 * speed ripple from firing pulses, fraction of average speed, two pulses per revolution
+	 */
+	double ripple;
+} angle_test_noise_s;
+
+static const angle_test_noise_s angleTestNoise[] = {
+	{"ideal", 0, 0, 0},
+	{"tooth 0.2deg", 0.2, 0, 0},
+	{"jitter 2us", 0, 0.000002, 0},
+	{"ripple 3%", 0, 0, 0.03},
+	{"all", 0.2, 0.000002, 0.03},
+};
+
+static uint32_t angleTestSeed;
+
+/**
+ * not really random but repeatable, -1..1
+ */
+static double angleTestRandom() {
+	angleTestSeed = angleTestSeed * 1103515245 + 12345;
+	return ((int)((angleTestSeed >> 16) % 2001) - 1000) / 1000.0;
+}
+
+/**
+ * crankshaft speed in degrees per second at given angle after start of constant acceleration
+ */
+static double angleTestSpeed(double speed, double acceleration, double ripple, double angle) {
+	double base = sqrt(speed * speed + 2 * acceleration * angle);
+	return base * (1 + ripple * sin(angle * 2 * M_PI / 180));
+}
+
+/**
+ * @return time it takes the crankshaft to turn from 'from' to 'to' degrees
+ */
+static double angleTestDuration(double speed, double acceleration, double ripple, double from, double to) {
+	double duration = 0;
+	while (from < to) {
+		double step = minF(ANGLE_TEST_STEP, to - from);
+		duration += step / angleTestSpeed(speed, acceleration, ripple, from + step / 2);
+		from += step;
+	}
+	return duration;
+}
+
+/**
+ * Sweeps RPM ramps on a 6 degree tooth wheel and reports worst scheduling error in degrees for
+ * previous revolution average speed versus AnglePredictor, see scheduleByAngle.
+ * Same sweep is repeated with tooth spacing error, ISR jitter and firing pulse speed ripple: the predictor
+ * differentiates engine cycle averages and should not amplify any of these.
+ */
+static void testAnglePredictor(void) {
+	static const int rampsRpmPerSecond[] = { 0, 1000, 6000 };
+	static const int angles[] = { 6, ANGLE_PREDICTOR_HORIZON };
+	static float toothErrors[(int)(360 / ANGLE_TEST_TOOTH)];
+
+	for (size_t n = 0; n < efi::size(angleTestNoise); n++) {
+		const angle_test_noise_s *noise = &angleTestNoise[n];
+		angleTestSeed = 1;
+		for (size_t t = 0; t < efi::size(toothErrors); t++) {
+			toothErrors[t] = t == 0 ? 0 : noise->toothError * angleTestRandom();
+		}
+		for (size_t r = 0; r < efi::size(rampsRpmPerSecond); r++) {
+			for (size_t a = 0; a < efi::size(angles); a++) {
+				// degrees per second at 800 rpm, degrees per second squared
+				double speed = 800 * 6.0;
+				double acceleration = rampsRpmPerSecond[r] * 6.0;
+				AnglePredictor predictor;
+				double position = 0;
+				double time = 0;
+				double revolutionStart = 0;
+				double oneDegreeSeconds = 0;
+				float averageError = 0;
+				float predictorError = 0;
+
+				for (int tooth = 0; tooth < ANGLE_TEST_REVOLUTIONS * 360 / ANGLE_TEST_TOOTH; tooth++) {
+					double nominal = tooth * ANGLE_TEST_TOOTH;
+					double actual = nominal + toothErrors[tooth % efi::size(toothErrors)];
+					time += angleTestDuration(speed, acceleration, noise->ripple, position, actual);
+					position = actual;
+					// this is when trigger ISR takes the timestamp
+					double seenTime = time + noise->jitter * (angleTestRandom() + 1) / 2;
+					efitick_t nowNt = (efitick_t)(seenTime * NT_PER_SECOND);
+					if (fmod(nominal, 360) == 0) {
+						predictor.onEngineCycle(nowNt, 360);
+						if (tooth != 0) {
+							oneDegreeSeconds = (seenTime - revolutionStart) / 360;
+						}
+						revolutionStart = seenTime;
+					}
+					// both methods are compared once predictor has seen two complete revolutions
+					if (tooth < 2 * 360 / ANGLE_TEST_TOOTH) {
+						continue;
+					}
+					double target = nominal + angles[a];
+					double targetTime = time + angleTestDuration(speed, acceleration, noise->ripple, actual, target);
+					double targetSpeed = angleTestSpeed(speed, acceleration, noise->ripple, target);
+
+					double averageTime = seenTime + oneDegreeSeconds * angles[a];
+					averageError = maxF(averageError, absF((averageTime - targetTime) * targetSpeed));
+
+					float delayNt = predictor.getDelayNt(nowNt, angles[a]);
+					// same sanity limit as scheduleByAngle
+					float averageDelayNt = oneDegreeSeconds * angles[a] * NT_PER_SECOND;
+					if (!(delayNt > averageDelayNt / 2 && delayNt < averageDelayNt * 2)) {
+						delayNt = averageDelayNt;
+					}
+					double predictedTime = (double)(nowNt + (efitick_t)delayNt) / NT_PER_SECOND;
+					predictorError = maxF(predictorError, absF((predictedTime - targetTime) * targetSpeed));
+				}
+				scheduleMsg(logger, "%s ramp %d rpm/s angle %d: average rpm error=%.3f predictor error=%.3f degrees",
+						noise->name, rampsRpmPerSecond[r], angles[a], averageError, predictorError);
+			}
+		}
+	}
+}
+
+extern uint32_t cachedTimeNowHits;
+
+/**
+ * Cost of lock-free 64 bit clock read versus cached timestamp
+ */
+static void testTimeNow(const int count) {
+	efitick_t result = 0;
+	time_t start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		result += getTimeNowNt();
+	}
+	time_t time = currentTimeMillis() - start;
+	if (result != 0) {
+		scheduleMsg(logger, "Finished %d iterations of getTimeNowNt in %dms", count, time);
+	}
+
+	{
+		CachedTimeNowScope timeNow;
+		start = currentTimeMillis();
+		for (int i = 0; i < count; i++) {
+			result += getTimeNowNtCached();
+		}
+		time = currentTimeMillis() - start;
+	}
+	if (result != 0) {
+		scheduleMsg(logger, "Finished %d iterations of getTimeNowNtCached in %dms", count, time);
+	}
+	scheduleMsg(logger, "%d clock reads served from cache so far", cachedTimeNowHits);
+}
+
+#if EFI_ENGINE_SNIFFER
+/**
+ * Per-event cost of text engine sniffer formatting versus binary ring recording
+ */
+static void testEngineSniffer(const int count) {
+	static char buffer[400];
+	static Logging chartLogger("perftest chart", buffer, sizeof(buffer));
+	static EngineSnifferRing ring;
+	engine_sniffer_record_s record;
+	record.name = PROTOCOL_COIL1_SHORT_NAME;
+	strcpy(record.msg, PROTOCOL_ES_UP);
+
+	time_t start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		if (remainingSize(&chartLogger) < 40) {
+			resetLogging(&chartLogger);
+		}
+		bool alreadyLocked = lockOutputBuffer();
+		record.timestampNt = i;
+		decodeEngineSnifferRecord(&chartLogger, &record, 0);
+		if (!alreadyLocked) {
+			unlockOutputBuffer();
+		}
+	}
+	time_t time = currentTimeMillis() - start;
+	scheduleMsg(logger, "Finished %d text engine sniffer events in %dms", count, time);
+
+	// binary events are converted into text in batches by the publishing thread, that cost is included here
+	start = currentTimeMillis();
+	for (int i = 0; i < count; i++) {
+		ring.add(PROTOCOL_COIL1_SHORT_NAME, PROTOCOL_ES_UP, i);
+		if (ring.getPendingCount() < ENGINE_SNIFFER_RING_SIZE) {
+			continue;
+		}
+		while (true) {
+			bool alreadyLocked = lockOutputBuffer();
+			bool hasRecord = ring.read(&record);
+			if (hasRecord) {
+				if (remainingSize(&chartLogger) < 40) {
+					resetLogging(&chartLogger);
+				}
+				decodeEngineSnifferRecord(&chartLogger, &record, 0);
+			}
+			if (!alreadyLocked) {
+				unlockOutputBuffer();
+			}
+			if (!hasRecord) {
+				break;
+			}
+		}
+	}
+	time = currentTimeMillis() - start;
+	scheduleMsg(logger, "Finished %d binary engine sniffer events in %dms, dropped %d", count, time,
+			ring.droppedCounter);
+	ring.clear();
+}
+#endif /* EFI_ENGINE_SNIFFER */
+
 static void runTests(const int count) {
 	scheduleMsg(logger, "Running tests: %d", count);
 	testRusefiMethods(count / 10);
+	testConsoleDispatch(count / 10);
+	testCyclicBuffer(count);
+	testFloatFormatting(count / 100);
+	testAnglePredictor();
+	testTimeNow(count);
+#if EFI_ENGINE_SNIFFER
+	testEngineSniffer(count / 10);
+#endif /* EFI_ENGINE_SNIFFER */
 	testSystemCalls(count);
 	testMath(count);
 }
 
-extern Overflow64Counter halTime;
+extern LockFreeCounter64 halTime;
 
 #if EFI_RTC
 static int rtcStartTime;
@@ -297,6 +623,48 @@ static void runChibioTest(void) {
 	TestThread(getConsoleChannel());
 }
 
+typedef struct {
+	const char *command;
+	/**
+	 * parameter is iteration count, duration in milliseconds or in seconds, see each test
+	 */
+	void (*run)(Logging *logger, int parameter);
+	/**
+	 * for tests without parameter, used if run is nullptr
+	 */
+	void (*runChecks)(Logging *logger);
+} self_test_s;
+
+static const self_test_s selfTests[] = {
+	{"spimodel", runSpiArbiterModel, nullptr},
+	{"knockdsptest", runKnockDspTest, nullptr},
+	{"gpiobatchtest", nullptr, runGpioBatchTest},
+	{"counter64test", nullptr, runCounter64Test},
+	{"tsparsertest", runTsFrameParserTest, nullptr},
+	{"adcsubtest", runAdcSubscriptionTest, nullptr},
+	{"knocktrackertest", runKnockTrackerTest, nullptr},
+	{"misfiretest", runMisfireTest, nullptr},
+#if EFI_VE_LEARNING
+	{"velearntest", runVeLearnerTest, nullptr},
+#endif /* EFI_VE_LEARNING */
+#if EFI_TUNER_STUDIO
+	{"ochtest", runOutputChannelGroupsTest, nullptr},
+#endif /* EFI_TUNER_STUDIO */
+	{"seqlocktest", runSeqLockTest, nullptr},
+	{"virtualclocktest", runVirtualClockTest, nullptr},
+	{"sweeptest", runEngineSweepTest, nullptr},
+};
+
+static void runSelfTestAction(int parameter, void *arg) {
+	const self_test_s *test = (const self_test_s *)arg;
+	test->run(logger, parameter);
+}
+
+static void runSelfTestChecksAction(void *arg) {
+	const self_test_s *test = (const self_test_s *)arg;
+	test->runChecks(logger);
+}
+
 void initTimePerfActions(Logging *sharedLogger) {
 	logger = sharedLogger;
 #if EFI_RTC
@@ -304,6 +672,14 @@ void initTimePerfActions(Logging *sharedLogger) {
 #endif
 
 	addConsoleActionI("perftest", runTests);
+	for (size_t i = 0; i < efi::size(selfTests); i++) {
+		const self_test_s *test = &selfTests[i];
+		if (test->run != nullptr) {
+			addConsoleActionIP(test->command, runSelfTestAction, (void *)test);
+		} else {
+			addConsoleActionP(test->command, runSelfTestChecksAction, (void *)test);
+		}
+	}
 
 	addConsoleAction("timeinfo", timeInfo);
 	addConsoleAction("chtest", runChibioTest);
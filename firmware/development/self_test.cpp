@@ -0,0 +1,30 @@
+/**
+ * @file	self_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "self_test.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+static int failed;
+
+void selfTestStart(void) {
+	failed = 0;
+}
+
+void selfTestCheck(Logging *logger, const char *name, bool isOk) {
+	if (!isOk) {
+		failed++;
+	}
+	scheduleMsg(logger, " %s %s", name, isOk ? "ok" : "FAILED");
+}
+
+int selfTestFailedCount(void) {
+	return failed;
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
@@ -0,0 +1,21 @@
+/**
+ * @file	self_test.h
+ * @brief Pass/fail bookkeeping shared by console self-tests
+ *
+ * Each self-test starts with selfTestStart(), reports every check with selfTestCheck() and prints
+ * selfTestFailedCount() in its summary line. Console commands run one at a time so a single counter is enough.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void selfTestStart(void);
+void selfTestCheck(Logging *logger, const char *name, bool isOk);
+/**
+ * @return number of failed checks since selfTestStart()
+ */
+int selfTestFailedCount(void);
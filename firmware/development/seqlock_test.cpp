@@ -0,0 +1,183 @@
+/**
+ * @file	seqlock_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "seqlock_test.h"
+#include "self_test.h"
+#include "seqlock.h"
+
+#if (EFI_PERF_METRICS || ! EFI_PROD_CODE) && ! EFI_UNIT_TEST
+
+#include <string.h>
+
+/**
+ * about the size of engine_state2_s
+ */
+#define SEQLOCK_TEST_WORDS 48
+
+typedef struct {
+	uint32_t words[SEQLOCK_TEST_WORDS];
+} seqlock_test_s;
+
+static seqlock_test_s shared;
+static SeqLock lock;
+static volatile bool isLocked;
+static volatile bool isStopRequested;
+
+/**
+ * copies made by the helper thread, plain or seqlock depending on isLocked
+ */
+static seqlock_test_s helperCopy;
+static volatile uint32_t helperReads;
+static volatile uint32_t helperTornReads;
+
+static THD_WORKING_AREA(seqLockHelperStack, UTILITY_THREAD_STACK_SIZE);
+
+static void writeShared(uint32_t value) {
+	if (isLocked) {
+		lock.writeBegin();
+	}
+	for (int i = 0; i < SEQLOCK_TEST_WORDS; i++) {
+		((volatile uint32_t *)shared.words)[i] = value;
+	}
+	if (isLocked) {
+		lock.writeEnd();
+	}
+}
+
+/**
+ * @return false if the copy is a mix of two writes
+ */
+static bool readShared(seqlock_test_s *copy) {
+	if (isLocked) {
+		if (!lock.snapshot(&shared, copy)) {
+			// gave up, not a torn read as far as the caller is concerned
+			return true;
+		}
+	} else {
+		memcpy(copy, (const void *)&shared, sizeof(*copy));
+	}
+	for (int i = 1; i < SEQLOCK_TEST_WORDS; i++) {
+		if (copy->words[i] != copy->words[0]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void periodicWriter(void *arg) {
+	(void)arg;
+	uint32_t value = 0;
+	while (!isStopRequested) {
+		writeShared(++value);
+		chThdSleepMilliseconds(1);
+	}
+}
+
+static void periodicReader(void *arg) {
+	(void)arg;
+	while (!isStopRequested) {
+		helperReads++;
+		if (!readShared(&helperCopy)) {
+			helperTornReads++;
+		}
+		chThdSleepMilliseconds(1);
+	}
+}
+
+static void resetState(bool useLock) {
+	isLocked = useLock;
+	isStopRequested = false;
+	helperReads = 0;
+	helperTornReads = 0;
+	lock.retryCounter = 0;
+	lock.failedCounter = 0;
+	memset(&shared, 0, sizeof(shared));
+}
+
+/**
+ * Helper thread writes once per tick above this thread which keeps copying.
+ * @return number of torn copies
+ */
+static uint32_t runWriterAbove(Logging *logger, bool useLock, int durationMs) {
+	resetState(useLock);
+	thread_t *writer = chThdCreateStatic(seqLockHelperStack, sizeof(seqLockHelperStack), NORMALPRIO + 1,
+			(tfunc_t)(void*) periodicWriter, NULL);
+	static seqlock_test_s copy;
+	uint32_t reads = 0;
+	uint32_t tornReads = 0;
+	efitick_t endNt = getTimeNowNt() + US2NT(MS2US(durationMs));
+	while (getTimeNowNt() < endNt) {
+		reads++;
+		if (!readShared(&copy)) {
+			tornReads++;
+		}
+	}
+	isStopRequested = true;
+	chThdWait(writer);
+	scheduleMsg(logger, " writer above reader, %s: %d reads, %d torn, %d retries, %d gave up",
+			useLock ? "seqlock" : "plain", reads, tornReads, lock.retryCounter, lock.failedCounter);
+	return tornReads;
+}
+
+/**
+ * Helper thread copies once per tick above this thread which keeps writing.
+ * @return number of torn copies
+ */
+static uint32_t runReaderAbove(Logging *logger, bool useLock, int durationMs) {
+	resetState(useLock);
+	thread_t *reader = chThdCreateStatic(seqLockHelperStack, sizeof(seqLockHelperStack), NORMALPRIO + 1,
+			(tfunc_t)(void*) periodicReader, NULL);
+	uint32_t value = 0;
+	efitick_t endNt = getTimeNowNt() + US2NT(MS2US(durationMs));
+	while (getTimeNowNt() < endNt) {
+		writeShared(++value);
+	}
+	isStopRequested = true;
+	chThdWait(reader);
+	scheduleMsg(logger, " reader above writer, %s: %d reads, %d torn, %d retries, %d gave up",
+			useLock ? "seqlock" : "plain", helperReads, helperTornReads, lock.retryCounter, lock.failedCounter);
+	return helperTornReads;
+}
+
+static void testNestedWriters(Logging *logger) {
+	SeqLock nested;
+	seqlock_test_s source;
+	seqlock_test_s copy;
+	memset(&source, 0, sizeof(source));
+	nested.writeBegin();
+	// same as trigger ISR preempting fast callback while both write the same structure
+	nested.writeBegin();
+	nested.writeEnd();
+	selfTestCheck(logger, "inner writer done, outer still keeps readers away", !nested.snapshot(&source, &copy));
+	nested.writeEnd();
+	selfTestCheck(logger, "outer writer done", nested.snapshot(&source, &copy));
+}
+
+void runSeqLockTest(Logging *logger, int durationMs) {
+	if (durationMs <= 0) {
+		durationMs = 500;
+	}
+	selfTestStart();
+	testNestedWriters(logger);
+
+	// plain copies only show that the test does catch torn reads
+	runWriterAbove(logger, false, durationMs);
+	selfTestCheck(logger, "writer above reader", runWriterAbove(logger, true, durationMs) == 0);
+	runReaderAbove(logger, false, durationMs);
+	selfTestCheck(logger, "reader above writer", runReaderAbove(logger, true, durationMs) == 0);
+
+	const int count = 1000000;
+	efitick_t start = getTimeNowNt();
+	for (int i = 0; i < count; i++) {
+		SeqLockWriteScope scope(&lock);
+	}
+	int ns = (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+	scheduleMsg(logger, "seqlock: write scope %dns, %d failed", ns, selfTestFailedCount());
+}
+
+#endif /* (EFI_PERF_METRICS || ! EFI_PROD_CODE) && ! EFI_UNIT_TEST */
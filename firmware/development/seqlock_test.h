@@ -0,0 +1,18 @@
+/**
+ * @file	seqlock_test.h
+ * @brief SeqLock stress test with real preemption
+ *
+ * A structure is written and copied by two threads of different priority, once with the writer above the reader
+ * like trigger ISR against TunerStudio thread and once with the reader above the writer like TunerStudio thread
+ * against idle thread. Plain copies are expected to be torn, seqlock snapshots are not. Nested writers and the
+ * cost of one write scope are checked as well.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runSeqLockTest(Logging *logger, int durationMs);
@@ -0,0 +1,173 @@
+/**
+ * @file	spi_arbiter_model.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "spi_arbiter_model.h"
+#include "spi_arbiter.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+/**
+ * SD card high speed configuration, 5.25MHz
+ */
+#define SPI_MODEL_BITS_PER_US 5
+/**
+ * chip select, DMA setup and completion interrupt
+ */
+#define SPI_MODEL_TRANSACTION_OVERHEAD_US 5
+
+typedef struct {
+	const char *name;
+	spi_priority_e priority;
+	int periodUs;
+	/**
+	 * bytes per period, bulk clients split this into chunks
+	 */
+	int size;
+	/**
+	 * zero if there is no deadline
+	 */
+	int deadlineUs;
+} spi_model_client_s;
+
+/**
+ * deadlines are the same the firmware drivers pass to the arbiter
+ */
+static const spi_model_client_s clients[] = {
+	// one command per knock window, 4 cylinders at 6000 rpm. Command has to reach the chip before next window
+	{"hip9011", SPI_PRIORITY_URGENT, 5000, 1, 5000},
+	// output updates, exchange is due before next poll
+	{"tle8888", SPI_PRIORITY_NORMAL, 1000, 2, 7000},
+	{"cj125", SPI_PRIORITY_NORMAL, 20000, 2, 20000},
+	// one log buffer every 20ms
+	{"sd card", SPI_PRIORITY_BULK, 20000, 8 * 512, 0},
+};
+
+#define SPI_MODEL_CLIENT_COUNT (sizeof(clients) / sizeof(clients[0]))
+
+typedef struct {
+	spi_request_s request;
+	efitick_t nextArrivalUs;
+	/**
+	 * bytes left to transfer within current period, zero if client is idle
+	 */
+	int remaining;
+	LatencyHistogram waitTime;
+	uint32_t missedDeadlineCounter;
+} spi_model_state_s;
+
+static spi_model_state_s states[SPI_MODEL_CLIENT_COUNT];
+static SpiArbiter arbiter;
+
+/**
+ * not really random but enough so that periodic clients do not stay in lockstep
+ */
+static uint32_t jitterSeed;
+
+static int getJitterUs(int periodUs) {
+	jitterSeed = jitterSeed * 1103515245 + 12345;
+	return (jitterSeed >> 16) % (periodUs / 4);
+}
+
+static int getTransferTimeUs(int size) {
+	return SPI_MODEL_TRANSACTION_OVERHEAD_US + size * 8 / SPI_MODEL_BITS_PER_US;
+}
+
+static void runModel(Logging *logger, const char *title, bool isPrioritized, int durationMs) {
+	jitterSeed = 1;
+	for (size_t i = 0; i < SPI_MODEL_CLIENT_COUNT; i++) {
+		spi_model_state_s *state = &states[i];
+		state->nextArrivalUs = getJitterUs(clients[i].periodUs);
+		state->remaining = 0;
+		state->waitTime.reset();
+		state->missedDeadlineCounter = 0;
+		state->request.priority = isPrioritized ? clients[i].priority : SPI_PRIORITY_BULK;
+		state->request.onGrant = nullptr;
+		state->request.context = state;
+	}
+
+	efitick_t nowUs = 0;
+	efitick_t endUs = durationMs * 1000LL;
+	spi_model_state_s *owner = nullptr;
+	int ownerChunk = 0;
+	efitick_t busyUntilUs = 0;
+
+	while (nowUs < endUs) {
+		// what comes first: end of current transfer or next arrival of an idle client
+		efitick_t nextUs = owner == nullptr ? endUs : busyUntilUs;
+		for (size_t i = 0; i < SPI_MODEL_CLIENT_COUNT; i++) {
+			if (states[i].remaining == 0 && states[i].nextArrivalUs < nextUs) {
+				nextUs = states[i].nextArrivalUs;
+			}
+		}
+		nowUs = nextUs;
+
+		spi_request_s *granted = nullptr;
+		if (owner != nullptr && nowUs >= busyUntilUs) {
+			spi_model_state_s *done = owner;
+			done->remaining -= ownerChunk;
+			owner = nullptr;
+			granted = arbiter.release(nowUs);
+			if (done->remaining > 0) {
+				// bulk client goes back into the queue for the next chunk
+				if (arbiter.request(&done->request, nowUs)) {
+					granted = &done->request;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < SPI_MODEL_CLIENT_COUNT; i++) {
+			spi_model_state_s *state = &states[i];
+			if (state->remaining != 0 || state->nextArrivalUs > nowUs) {
+				continue;
+			}
+			state->remaining = clients[i].size;
+			state->request.deadlineNt = clients[i].deadlineUs == 0 ? 0 : nowUs + clients[i].deadlineUs;
+			state->nextArrivalUs += clients[i].periodUs + getJitterUs(clients[i].periodUs);
+			if (arbiter.request(&state->request, nowUs)) {
+				granted = &state->request;
+			}
+		}
+
+		if (granted != nullptr) {
+			owner = (spi_model_state_s *)granted->context;
+			int index = owner - states;
+			bool isSplit = isPrioritized && clients[index].priority == SPI_PRIORITY_BULK;
+			ownerChunk = isSplit ? minI(owner->remaining, SPI_BULK_CHUNK_SIZE) : owner->remaining;
+			busyUntilUs = nowUs + getTransferTimeUs(ownerChunk);
+			owner->waitTime.add(nowUs - granted->requestNt);
+			if (granted->deadlineNt != 0 && nowUs > granted->deadlineNt) {
+				owner->missedDeadlineCounter++;
+			}
+		}
+	}
+	// whatever is still in the queue is of no interest
+	while (arbiter.isBusy()) {
+		arbiter.release(endUs);
+	}
+
+	scheduleMsg(logger, "%s, %dms:", title, durationMs);
+	for (size_t i = 0; i < SPI_MODEL_CLIENT_COUNT; i++) {
+		latency_histogram_s h;
+		states[i].waitTime.snapshot(&h);
+		latency_percentiles_s wait;
+		latencyHistogramGetPercentiles(&h, &wait);
+		scheduleMsg(logger, " %s/%s: count=%d wait p50=%dus p99=%dus max=%dus missed deadline=%d", clients[i].name,
+				getSpiPriorityName(clients[i].priority), wait.count, wait.p50, wait.p99, wait.max,
+				states[i].missedDeadlineCounter);
+	}
+}
+
+void runSpiArbiterModel(Logging *logger, int durationMs) {
+	if (durationMs <= 0) {
+		durationMs = 1000;
+	}
+	runModel(logger, "single mutex", false, durationMs);
+	runModel(logger, "priority arbiter", true, durationMs);
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
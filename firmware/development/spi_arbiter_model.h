@@ -0,0 +1,17 @@
+/**
+ * @file	spi_arbiter_model.h
+ * @brief Discrete event model of a shared SPI bus
+ *
+ * Synthetic SD card, knock chip, smart driver and wideband controller workloads are run against SpiArbiter
+ * on virtual time, once the way plain bus mutex behaves and once with priorities and chunked SD writes.
+ * No hardware is touched so this could run on the host as well as on the chip.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runSpiArbiterModel(Logging *logger, int durationMs);
@@ -0,0 +1,166 @@
+/**
+ * @file	ts_frame_parser_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "ts_frame_parser_test.h"
+#include "ts_frame_parser.h"
+#include "tunerstudio_io.h"
+#include "crc.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+#include <string.h>
+
+#define TS_TEST_STREAM_SIZE (2 * TS_RX_BUFFER_SIZE)
+#define TS_TEST_MAX_FRAMES 16
+
+static uint8_t stream[TS_TEST_STREAM_SIZE];
+static int streamSize;
+static TsFrameParser parser;
+
+static void appendPlain(char command) {
+	stream[streamSize++] = command;
+}
+
+/**
+ * @return offset of the packet in the stream
+ */
+static int appendCrcPacket(char command, int dataSize) {
+	int offset = streamSize;
+	int packetSize = dataSize + 1;
+	stream[streamSize++] = packetSize >> 8;
+	stream[streamSize++] = packetSize & 0xFF;
+	stream[streamSize++] = command;
+	for (int i = 0; i < dataSize; i++) {
+		stream[streamSize++] = i;
+	}
+	uint32_t crc = SWAP_UINT32(crc32(stream + offset + 2, packetSize));
+	memcpy(stream + streamSize, &crc, CRC_VALUE_SIZE);
+	streamSize += CRC_VALUE_SIZE;
+	return offset;
+}
+
+typedef struct {
+	ts_frame_e type;
+	/**
+	 * command byte, zero if frame has no payload
+	 */
+	char command;
+} ts_test_frame_s;
+
+static const ts_test_frame_s expected[] = {
+	{TS_FRAME_PLAIN, TS_HELLO_COMMAND},
+	{TS_FRAME_CRC, TS_OUTPUT_COMMAND},
+	{TS_FRAME_CRC, TS_CHUNK_WRITE_COMMAND},
+	{TS_FRAME_PLAIN, TS_COMMAND_F},
+	{TS_FRAME_CRC, TS_READ_COMMAND},
+	{TS_FRAME_CRC_MISMATCH, 0},
+	{TS_FRAME_INVALID_SIZE, 0},
+	{TS_FRAME_CRC, TS_GET_TEXT},
+};
+
+#define TS_TEST_EXPECTED_COUNT (sizeof(expected) / sizeof(expected[0]))
+
+static void buildStream(void) {
+	streamSize = 0;
+	appendPlain(TS_HELLO_COMMAND);
+	appendCrcPacket(TS_OUTPUT_COMMAND, 4);
+	// largest packet which fits next to size and CRC
+	appendCrcPacket(TS_CHUNK_WRITE_COMMAND, TS_RX_BUFFER_SIZE - CRC_WRAPPING_SIZE - 1);
+	appendPlain(TS_COMMAND_F);
+	appendCrcPacket(TS_READ_COMMAND, 6);
+	int corrupted = appendCrcPacket(TS_READ_COMMAND, 6);
+	stream[corrupted + 5] ^= 1;
+	// size way above the buffer, only these two bytes are dropped
+	stream[streamSize++] = 0x7F;
+	stream[streamSize++] = 0xFF;
+	appendCrcPacket(TS_GET_TEXT, 0);
+}
+
+/**
+ * @return true if frames received with given chunk size are the expected ones
+ */
+static bool feedInChunks(int chunkSize, int *frameCount) {
+	memset(&parser, 0, sizeof(parser));
+	parser.reset();
+	ts_test_frame_s received[TS_TEST_MAX_FRAMES];
+	int count = 0;
+	int position = 0;
+	while (position < streamSize) {
+		int size = minI(minI(chunkSize, parser.getFreeSize()), streamSize - position);
+		if (size <= 0) {
+			// buffer is full of a partial frame, parser would be stuck
+			return false;
+		}
+		memcpy(parser.getWritePointer(), stream + position, size);
+		parser.onReceived(size);
+		position += size;
+
+		char *payload;
+		int payloadSize;
+		ts_frame_e type;
+		while ((type = parser.next(&payload, &payloadSize)) != TS_FRAME_INCOMPLETE) {
+			if (count == TS_TEST_MAX_FRAMES) {
+				return false;
+			}
+			received[count].type = type;
+			received[count].command = type == TS_FRAME_CRC || type == TS_FRAME_PLAIN ? payload[0] : 0;
+			count++;
+		}
+	}
+	*frameCount = count;
+	if (count != (int)TS_TEST_EXPECTED_COUNT || parser.getPendingSize() != 0) {
+		return false;
+	}
+	for (int i = 0; i < count; i++) {
+		if (received[i].type != expected[i].type || received[i].command != expected[i].command) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static const int chunkSizes[] = {1, 3, 7, 64, TS_TEST_STREAM_SIZE};
+
+void runTsFrameParserTest(Logging *logger, int count) {
+	if (count <= 0) {
+		count = 10000;
+	}
+	buildStream();
+	int failed = 0;
+	for (size_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); i++) {
+		int frameCount = 0;
+		bool isOk = feedInChunks(chunkSizes[i], &frameCount);
+		if (!isOk) {
+			failed++;
+		}
+		scheduleMsg(logger, " %d byte chunks: %d frames, %d pipelined %s", chunkSizes[i], frameCount,
+				parser.pipelinedFrameCounter, isOk ? "ok" : "FAILED");
+	}
+
+	// 'O' poll followed by a page read in the same read, the way a pipelining host sends them
+	streamSize = 0;
+	appendCrcPacket(TS_OUTPUT_COMMAND, 4);
+	appendCrcPacket(TS_READ_COMMAND, 6);
+	memset(&parser, 0, sizeof(parser));
+	parser.reset();
+	int frames = 0;
+	efitick_t start = getTimeNowNt();
+	for (int i = 0; i < count; i++) {
+		memcpy(parser.getWritePointer(), stream, streamSize);
+		parser.onReceived(streamSize);
+		char *payload;
+		int payloadSize;
+		while (parser.next(&payload, &payloadSize) != TS_FRAME_INCOMPLETE) {
+			frames++;
+		}
+	}
+	int pairNs = (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+	scheduleMsg(logger, "%d 'O' + 'R' pairs: %dns per pair, %d frames, %d failed", count, pairNs, frames, failed);
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
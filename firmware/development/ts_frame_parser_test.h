@@ -0,0 +1,16 @@
+/**
+ * @file	ts_frame_parser_test.h
+ * @brief TunerStudio frame parser checks against a mixed request stream
+ *
+ * Plain commands, CRC packets, a corrupted packet and an invalid size are fed to TsFrameParser in chunks of
+ * different sizes, every chunking has to produce the same frames. Then parsing of pipelined 'O' + 'R' pairs is timed.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runTsFrameParserTest(Logging *logger, int count);
@@ -0,0 +1,167 @@
+/**
+ * @file	ve_learner_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "ve_learner_test.h"
+#include "self_test.h"
+#include "ve_learner.h"
+
+#if (EFI_PERF_METRICS || ! EFI_PROD_CODE) && EFI_VE_LEARNING
+
+#include <math.h>
+
+#define VE_TEST_TARGET_AFR 14.7f
+#define VE_TEST_TABLE_VE 80
+/**
+ * operating point moves towards a new random target this often
+ */
+#define VE_TEST_TARGET_PERIOD 300
+#define VE_TEST_CYCLES 60000
+#define VE_TEST_NOISE 0.01f
+
+/**
+ * separate learner so that the test does not touch what engine has learned
+ */
+static VeLearner learner;
+static fuel_table_t veTable;
+static float loadBins[FUEL_LOAD_COUNT];
+static float rpmBins[FUEL_RPM_COUNT];
+// keeps the loop from being optimized away
+static volatile float sink;
+
+static uint32_t seed;
+
+static uint32_t nextRandom(void) {
+	// not really random but repeatable
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16;
+}
+
+/**
+ * @return repeatable value in 0..1 range
+ */
+static float nextUniform(void) {
+	return (nextRandom() % 10001) / 10000.0f;
+}
+
+/**
+ * what the engine actually has, smooth error field against the flat table
+ */
+static float getTrueVe(float rpm, float load) {
+	return VE_TEST_TABLE_VE * (1 + 0.12f * sinf(rpm / 1500) + 0.08f * cosf(load / 30));
+}
+
+static void locate(float value, const float *bins, int size, int *index, float *fraction) {
+	int i = 0;
+	while (i < size - 2 && bins[i + 1] <= value) {
+		i++;
+	}
+	*index = i;
+	*fraction = clampF(0, (value - bins[i]) / (bins[i + 1] - bins[i]), 1);
+}
+
+static float getTableVe(float rpm, float load) {
+	int l, r;
+	float loadFraction, rpmFraction;
+	locate(load, loadBins, FUEL_LOAD_COUNT, &l, &loadFraction);
+	locate(rpm, rpmBins, FUEL_RPM_COUNT, &r, &rpmFraction);
+	float low = veTable[l][r] * (1 - rpmFraction) + veTable[l][r + 1] * rpmFraction;
+	float high = veTable[l + 1][r] * (1 - rpmFraction) + veTable[l + 1][r + 1] * rpmFraction;
+	return low * (1 - loadFraction) + high * loadFraction;
+}
+
+/**
+ * @return RMS error of VE which would be used, percent, over the region the test drives through
+ */
+static float getRmsError(void) {
+	float sum = 0;
+	int count = 0;
+	for (float rpm = 1200; rpm <= 4800; rpm += 100) {
+		for (float load = 30; load <= 90; load += 2) {
+			float usedVe = getTableVe(rpm, load) * (learner.isApplying ? learner.getCorrection(rpm, load) : 1);
+			float error = usedVe / getTrueVe(rpm, load) - 1;
+			sum += error * error;
+			count++;
+		}
+	}
+	return sqrtf(sum / count) * 100;
+}
+
+void runVeLearnerTest(Logging *logger, int count) {
+	if (count <= 0) {
+		count = 100000;
+	}
+	selfTestStart();
+	seed = 1;
+	for (int i = 0; i < FUEL_LOAD_COUNT; i++) {
+		loadBins[i] = 20 + i * 6;
+	}
+	for (int i = 0; i < FUEL_RPM_COUNT; i++) {
+		rpmBins[i] = 800 + i * 400;
+	}
+	for (int l = 0; l < FUEL_LOAD_COUNT; l++) {
+		for (int r = 0; r < FUEL_RPM_COUNT; r++) {
+			veTable[l][r] = VE_TEST_TABLE_VE;
+		}
+	}
+	learner.init(loadBins, rpmBins);
+	learner.isLearning = false;
+	learner.isApplying = true;
+
+	selfTestCheck(logger, "no samples while not learning",
+			!learner.addSample(2000, 50, VE_TEST_TARGET_AFR, VE_TEST_TARGET_AFR));
+	learner.isLearning = true;
+
+	float initialError = getRmsError();
+	float halfwayError = 0;
+	float rpm = 2000;
+	float load = 50;
+	float targetRpm = rpm;
+	float targetLoad = load;
+	float measuredAfr = VE_TEST_TARGET_AFR;
+	for (int cycle = 1; cycle <= VE_TEST_CYCLES; cycle++) {
+		if (cycle % VE_TEST_TARGET_PERIOD == 0) {
+			targetRpm = 1200 + nextUniform() * 3600;
+			targetLoad = 30 + nextUniform() * 60;
+		}
+		rpm += (targetRpm - rpm) * 0.02f;
+		load += (targetLoad - load) * 0.02f;
+		float usedVe = getTableVe(rpm, load) * learner.getCorrection(rpm, load);
+		float actualAfr = VE_TEST_TARGET_AFR * getTrueVe(rpm, load) / usedVe;
+		// sensor and transport lag
+		measuredAfr += (actualAfr - measuredAfr) * 0.4f;
+		float noise = VE_TEST_NOISE * (2 * nextUniform() - 1);
+		learner.addSample(rpm, load, measuredAfr * (1 + noise), VE_TEST_TARGET_AFR);
+		if (cycle == VE_TEST_CYCLES / 3) {
+			halfwayError = getRmsError();
+		}
+	}
+	float learnedError = getRmsError();
+	selfTestCheck(logger, "error goes down", halfwayError < initialError / 2 && learnedError < halfwayError);
+	selfTestCheck(logger, "error below 1.5%", learnedError < 1.5f);
+	// lambda is still about previous operating point after a step
+	selfTestCheck(logger, "load step is skipped", !learner.addSample(rpm, load * 1.2f, measuredAfr, VE_TEST_TARGET_AFR));
+	scheduleMsg(logger, "  RMS VE error %.2f%%, %.2f%% after %d cycles, %.2f%% after %d, %d samples %d transient",
+			initialError, halfwayError, VE_TEST_CYCLES / 3, learnedError, VE_TEST_CYCLES, learner.sampleCounter,
+			learner.transientCounter);
+
+	int changedCount = learner.commit(veTable);
+	float committedError = getRmsError();
+	selfTestCheck(logger, "commit keeps VE", changedCount > 0 && absF(committedError - learnedError) < 0.01f);
+	selfTestCheck(logger, "commit restarts learning", learner.getCorrection(3000, 60) == 1 && learner.sampleCounter == 0);
+
+	efitick_t start = getTimeNowNt();
+	for (int i = 0; i < count; i++) {
+		learner.addSample(2000 + (i & 1), 50, VE_TEST_TARGET_AFR, VE_TEST_TARGET_AFR);
+		sink += learner.getCorrection(2000, 50);
+	}
+	int ns = (int)(NT2US((getTimeNowNt() - start) * 1000) / count);
+	learner.isLearning = false;
+	scheduleMsg(logger, "ve learner: %dns per sample and lookup, %d failed", ns, selfTestFailedCount());
+}
+
+#endif /* (EFI_PERF_METRICS || ! EFI_PROD_CODE) && EFI_VE_LEARNING */
@@ -0,0 +1,17 @@
+/**
+ * @file	ve_learner_test.h
+ * @brief Closed loop VE learning against a synthetic engine
+ *
+ * A flat VE table is off from the true VE of the simulated engine by up to 20%. The operating point drifts around,
+ * measured AFR lags behind fueling and has some noise. RMS VE error over the driven region is checked while
+ * learning and after commit, then one sample plus lookup is timed.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void runVeLearnerTest(Logging *logger, int count);
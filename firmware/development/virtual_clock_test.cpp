@@ -0,0 +1,169 @@
+/**
+ * @file	virtual_clock_test.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "virtual_clock_test.h"
+#include "self_test.h"
+#include "virtual_clock_executor.h"
+#include "trigger_simulator.h"
+#include "engine.h"
+
+#if EFI_PERF_METRICS || ! EFI_PROD_CODE
+
+EXTERN_ENGINE;
+
+#define VIRTUAL_CLOCK_TEST_RPM 3000
+#define VIRTUAL_CLOCK_TEST_PERIOD_MS 5
+#define VIRTUAL_CLOCK_TEST_EVENTS 5
+
+static VirtualClockExecutor executor;
+
+typedef struct {
+	scheduling_s scheduling;
+	efitick_t momentNt;
+	efitick_t executedNt;
+} virtual_clock_event_s;
+
+static virtual_clock_event_s events[VIRTUAL_CLOCK_TEST_EVENTS];
+static int executionOrder[VIRTUAL_CLOCK_TEST_EVENTS];
+static int executionCount;
+
+static void onTestEvent(virtual_clock_event_s *event) {
+	event->executedNt = executor.getNowNt();
+	executionOrder[executionCount++] = event - events;
+}
+
+static scheduling_s followUp;
+static efitick_t followUpNt;
+
+static void onFollowUp(void *arg) {
+	(void)arg;
+	followUpNt = executor.getNowNt();
+}
+
+static void onScheduleFollowUp(void *arg) {
+	(void)arg;
+	executor.scheduleForLater(&followUp, 0, &onFollowUp);
+}
+
+static void testOrdering(Logging *logger) {
+	static const efitick_t moments[VIRTUAL_CLOCK_TEST_EVENTS] = { 500, 100, 300, 100000, 200 };
+	executor.reset();
+	executionCount = 0;
+	for (int i = 0; i < VIRTUAL_CLOCK_TEST_EVENTS; i++) {
+		events[i].momentNt = moments[i];
+		events[i].executedNt = -1;
+		executor.scheduleByTimestampNt(&events[i].scheduling, moments[i], { &onTestEvent, &events[i] });
+	}
+	selfTestCheck(logger, "nothing executed before run", executionCount == 0);
+
+	int executed = executor.runUntil(1000);
+	selfTestCheck(logger, "events up to target", executed == VIRTUAL_CLOCK_TEST_EVENTS - 1);
+	bool isOrdered = true;
+	bool isOnTime = true;
+	for (int i = 0; i < executionCount; i++) {
+		const virtual_clock_event_s *event = &events[executionOrder[i]];
+		isOrdered = isOrdered && (i == 0 || event->momentNt >= events[executionOrder[i - 1]].momentNt);
+		isOnTime = isOnTime && event->executedNt == event->momentNt;
+	}
+	selfTestCheck(logger, "timestamp order", isOrdered);
+	selfTestCheck(logger, "clock is at event timestamp", isOnTime);
+	selfTestCheck(logger, "clock is at target after run", executor.getNowNt() == 1000);
+
+	executor.runUntil(100000);
+	selfTestCheck(logger, "event at target is executed", events[3].executedNt == 100000);
+
+	executor.scheduleForLater(&followUp, 10, &onScheduleFollowUp);
+	followUpNt = -1;
+	executor.runUntil(200000);
+	selfTestCheck(logger, "event scheduled by callback for now", followUpNt == 100000 + US2NT(10));
+	executor.reset();
+	selfTestCheck(logger, "reset", executor.getNowNt() == 0);
+}
+
+static uint32_t signalHash;
+
+static void onShaftSignal(trigger_event_e signal, efitick_t timestamp) {
+	signalHash = signalHash * 31 + signal;
+	signalHash = signalHash * 31 + (uint32_t)timestamp;
+}
+
+static scheduling_s periodicTask;
+static uint32_t periodicCounter;
+
+static void onPeriodicTask(void *arg) {
+	(void)arg;
+	periodicCounter++;
+	signalHash = signalHash * 31 + (uint32_t)executor.getNowNt();
+	executor.scheduleForLater(&periodicTask, MS2US(VIRTUAL_CLOCK_TEST_PERIOD_MS), &onPeriodicTask);
+}
+
+typedef struct {
+	uint32_t hash;
+	uint32_t signals;
+	uint32_t cycles;
+	uint32_t periodic;
+	uint32_t executed;
+	int durationMs;
+} virtual_clock_run_s;
+
+static void runStimulation(int seconds, float rpmMultiplier, virtual_clock_run_s *result) {
+	executor.reset();
+	signalHash = 0;
+	periodicCounter = 0;
+	VirtualTriggerStimulator stimulator(&executor, &engine->triggerCentral.triggerShape, &onShaftSignal);
+
+	time_t start = currentTimeMillis();
+	stimulator.setRpm(VIRTUAL_CLOCK_TEST_RPM, rpmMultiplier);
+	executor.scheduleForLater(&periodicTask, MS2US(VIRTUAL_CLOCK_TEST_PERIOD_MS), &onPeriodicTask);
+	// one second at a time, same way a host main loop would run it
+	for (int i = 1; i <= seconds; i++) {
+		executor.runUntil((efitick_t)i * NT_PER_SECOND);
+	}
+	result->durationMs = currentTimeMillis() - start;
+
+	result->hash = signalHash;
+	result->signals = stimulator.eventCounter;
+	result->cycles = stimulator.cycleCounter;
+	result->periodic = periodicCounter;
+	result->executed = executor.executeCounter;
+	// stimulator and periodic task are not needed past this point
+	executor.reset();
+}
+
+static void testStimulation(Logging *logger, int seconds) {
+	if (TRIGGER_WAVEFORM(getSize()) == 0) {
+		scheduleMsg(logger, "virtual clock: no trigger shape, stimulation skipped");
+		return;
+	}
+	float rpmMultiplier = getRpmMultiplier(engine->getOperationMode(PASS_ENGINE_PARAMETER_SIGNATURE));
+
+	virtual_clock_run_s first;
+	virtual_clock_run_s second;
+	runStimulation(seconds, rpmMultiplier, &first);
+	runStimulation(seconds, rpmMultiplier, &second);
+
+	float expectedCycles = seconds * VIRTUAL_CLOCK_TEST_RPM / 60.0f * rpmMultiplier;
+	selfTestCheck(logger, "trigger cycles", absF(first.cycles - expectedCycles) <= 1);
+	// each shape index is at least one edge
+	selfTestCheck(logger, "trigger events", first.signals >= first.cycles * TRIGGER_WAVEFORM(getSize()));
+	selfTestCheck(logger, "periodic task", (int)first.periodic == seconds * 1000 / VIRTUAL_CLOCK_TEST_PERIOD_MS);
+	selfTestCheck(logger, "identical runs", first.hash == second.hash && first.signals == second.signals
+			&& first.periodic == second.periodic && first.executed == second.executed);
+
+	scheduleMsg(logger, "virtual clock: %ds at %drpm, %d trigger events and %d tasks in %dms (%dms)",
+			seconds, VIRTUAL_CLOCK_TEST_RPM, first.signals, first.periodic, first.durationMs, second.durationMs);
+}
+
+void runVirtualClockTest(Logging *logger, int seconds) {
+	selfTestStart();
+	testOrdering(logger);
+	testStimulation(logger, seconds > 0 ? seconds : 10);
+	scheduleMsg(logger, "virtual clock: %d failed", selfTestFailedCount());
+}
+
+#endif /* EFI_PERF_METRICS || ! EFI_PROD_CODE */
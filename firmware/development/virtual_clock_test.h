@@ -0,0 +1,16 @@
+/**
+ * @file	virtual_clock_test.h
+ * @brief VirtualClockExecutor ordering and faster than real time trigger stimulation checks
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+/**
+ * @param seconds how long configured trigger shape is stimulated on virtual clock, each of two runs
+ */
+void runVirtualClockTest(Logging *logger, int seconds);
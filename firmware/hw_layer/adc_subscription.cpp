@@ -3,68 +3,115 @@
 #include "adc_inputs.h"
 #include "engine.h"
 #include "perf_trace.h"
+#include "linear_func.h"
 
 #include <iterator>
 
 EXTERN_ENGINE;
 
+bool AdcSubscriptionTable::subscribe(FunctionalSensor &sensor, adc_channel_e channel, float voltsPerAdcVolt,
+		int oversampling) {
+	if (count >= ADC_MAX_SUBSCRIPTIONS) {
+		return false;
+	}
+	oversampling = maxI(1, minI(oversampling, UINT8_MAX));
+
+	// Populate the entry
+	size_t i = count;
+	sensors[i] = &sensor;
+	channels[i] = channel;
+	voltsPerAdcSum[i] = voltsPerAdcVolt / oversampling;
+	framesPerUpdate[i] = oversampling;
+	converters[i] = nullptr;
+	linears[i] = nullptr;
+	rawSums[i] = 0;
+	frameCounts[i] = 0;
+
+	count++;
+	return true;
+}
+
+void AdcSubscriptionTable::update(efitick_t nowNt, float voltsPerCount, adc_sample_source_t getSample) {
+	for (size_t i = 0; i < count; i++) {
+		rawSums[i] += getSample(channels[i]);
+		if (++frameCounts[i] < framesPerUpdate[i]) {
+			// oversampled channel, decimated result would be posted once enough frames are accumulated
+			continue;
+		}
+		float sensorVolts = rawSums[i] * (voltsPerCount * voltsPerAdcSum[i]);
+		rawSums[i] = 0;
+		frameCounts[i] = 0;
+
+		FunctionalSensor *sensor = sensors[i];
+		// converter could be replaced on configuration change
+		const SensorConverter *converter = sensor->getFunction();
+		if (converter != converters[i]) {
+			converters[i] = converter;
+			linears[i] = converter == nullptr ? nullptr : converter->getLinearFunc();
+		}
+
+		const LinearFunc *linear = linears[i];
+		if (linear != nullptr) {
+			// same as LinearFunc::convert without virtual call and without SensorResult in between
+			float value = linear->apply(sensorVolts);
+			sensor->postConvertedValue(sensorVolts, linear->isInRange(value), value, nowNt);
+		} else {
+			sensor->postRawValue(sensorVolts, nowNt);
+		}
+	}
+}
+
+void AdcSubscriptionTable::reset() {
+	count = 0;
+}
+
+size_t AdcSubscriptionTable::size() const {
+	return count;
+}
+
 #if EFI_UNIT_TEST
 
 void AdcSubscription::SubscribeSensor(FunctionalSensor &sensor,
 									  adc_channel_e channel,
-									  float voltsPerAdcVolt /*= 0.0f*/)
+									  float voltsPerAdcVolt /*= 0.0f*/,
+									  int oversampling /*= 1*/)
 {
 }
 
 #else
 
-struct AdcSubscriptionEntry {
-	FunctionalSensor *Sensor;
-	float VoltsPerAdcVolt;
-	adc_channel_e Channel;
-};
-
-static size_t s_nextEntry = 0;
-static AdcSubscriptionEntry s_entries[8];
+static AdcSubscriptionTable s_entries;
 
 void AdcSubscription::SubscribeSensor(FunctionalSensor &sensor,
 									  adc_channel_e channel,
-									  float voltsPerAdcVolt /*= 0.0f*/) {
+									  float voltsPerAdcVolt /*= 0.0f*/,
+									  int oversampling /*= 1*/) {
 	// Don't subscribe null channels
 	if (channel == EFI_ADC_NONE) {
 		return;
 	}
 
-	// bounds check
-	if (s_nextEntry >= std::size(s_entries)) {
-		return;
-	}
-
 	// if 0, default to the board's divider coefficient
 	if (voltsPerAdcVolt == 0) {
 		voltsPerAdcVolt = engineConfiguration->analogInputDividerCoefficient;
 	}
 
-	// Populate the entry
-	auto &entry = s_entries[s_nextEntry];
-	entry.Sensor = &sensor;
-	entry.VoltsPerAdcVolt = voltsPerAdcVolt;
-	entry.Channel = channel;
+	// bounds check
+	if (!s_entries.subscribe(sensor, channel, voltsPerAdcVolt, oversampling)) {
+		warning(CUSTOM_ERR_6639, "Too many ADC subscriptions");
+	}
+}
 
-	s_nextEntry++;
+static int getSubscriptionSample(adc_channel_e channel) {
+	return getAdcValue("sensor", channel);
 }
 
 void AdcSubscription::UpdateSubscribers(efitick_t nowNt) {
 	ScopePerf perf(PE::AdcSubscriptionUpdateSubscribers);
 
-	for (size_t i = 0; i < s_nextEntry; i++) {
-		auto &entry = s_entries[i];
-
-		float mcuVolts = getVoltage("sensor", entry.Channel);
-		float sensorVolts = mcuVolts * entry.VoltsPerAdcVolt;
-
-		entry.Sensor->postRawValue(sensorVolts, nowNt);
-	}
+	// ADC reference is the same for all channels
+	float voltsPerCount = engineConfiguration->adcVcc / ADC_MAX_VALUE;
+	s_entries.update(nowNt, voltsPerCount, &getSubscriptionSample);
 }
 
 #endif // !EFI_UNIT_TEST
@@ -7,8 +7,62 @@
 #include "functional_sensor.h"
 #include "global.h"
 
+#ifndef ADC_MAX_SUBSCRIPTIONS
+#define ADC_MAX_SUBSCRIPTIONS 24
+#endif
+
+class LinearFunc;
+
+/**
+ * raw sample of given channel, same units as getAdcValue
+ */
+typedef int (*adc_sample_source_t)(adc_channel_e channel);
+
+/**
+ * Subscriptions are stored as struct of arrays so that the update pass walks a few dense arrays instead of
+ * jumping between entries of a larger structure.
+ */
+class AdcSubscriptionTable {
+public:
+	/**
+	 * @return false if table is full
+	 */
+	bool subscribe(FunctionalSensor &sensor, adc_channel_e channel, float voltsPerAdcVolt, int oversampling);
+	/**
+	 * One pass over all subscriptions: raw sample to volts, oversampling, conversion and range check. Linear
+	 * conversions are inlined, other converters go through SensorConverter::convert
+	 */
+	void update(efitick_t nowNt, float voltsPerCount, adc_sample_source_t getSample);
+	void reset();
+	size_t size() const;
+private:
+	size_t count = 0;
+	FunctionalSensor *sensors[ADC_MAX_SUBSCRIPTIONS];
+	adc_channel_e channels[ADC_MAX_SUBSCRIPTIONS];
+	/**
+	 * divider coefficient over oversampling factor: sum of raw samples times this is sensor volts
+	 */
+	float voltsPerAdcSum[ADC_MAX_SUBSCRIPTIONS];
+	uint8_t framesPerUpdate[ADC_MAX_SUBSCRIPTIONS];
+
+	// converter of each sensor as of last pass, LinearFunc is only looked up again if it has changed
+	const SensorConverter *converters[ADC_MAX_SUBSCRIPTIONS];
+	const LinearFunc *linears[ADC_MAX_SUBSCRIPTIONS];
+
+	// oversampling accumulator
+	uint32_t rawSums[ADC_MAX_SUBSCRIPTIONS];
+	uint8_t frameCounts[ADC_MAX_SUBSCRIPTIONS];
+};
+
 class AdcSubscription {
 public:
-	static void SubscribeSensor(FunctionalSensor &sensor, adc_channel_e channel, float voltsPerAdcVolt = 0.0f);
+	/**
+	 * @param oversampling number of slow ADC frames averaged into one sensor update, for noisy channels
+	 * which do not need the full slow ADC rate. Sensor timeout has to be longer than that many frames
+	 */
+	static void SubscribeSensor(FunctionalSensor &sensor, adc_channel_e channel, float voltsPerAdcVolt = 0.0f, int oversampling = 1);
+	/**
+	 * updates all subscriptions from latest slow ADC frame, see AdcSubscriptionTable::update
+	 */
 	static void UpdateSubscribers(efitick_t nowNt);
 };
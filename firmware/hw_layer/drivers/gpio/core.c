@@ -14,6 +14,43 @@
 #define STRING(x) STRING2(x)
 #pragma message(STRING(BOARD_EXT_GPIOCHIPS))
 
+/**
+ * @brief Merge one pin write into pending pins of a chip
+ * @details does not depend on registered chips so that it could be exercised with mock ops,
+ * see gpio_batch_test.cpp
+ */
+
+void gpiochip_pending_add(struct gpiochip_pending *pending, unsigned int pin, int value)
+{
+	uint32_t bit = 1u << pin;
+
+	pending->mask |= bit;
+	if (value)
+		pending->value |= bit;
+	else
+		pending->value &= ~bit;
+	pending->count++;
+}
+
+/**
+ * @brief Send pending pins of a chip with a single writePort call
+ */
+
+int gpiochip_pending_flush(struct gpiochip_pending *pending, const struct gpiochip_ops *ops, void *priv)
+{
+	uint32_t mask = pending->mask;
+	uint32_t value = pending->value;
+
+	pending->mask = 0;
+	pending->value = 0;
+	pending->count = 0;
+
+	if (mask == 0)
+		return 0;
+
+	return ops->writePort(priv, mask, value);
+}
+
 #if (BOARD_EXT_GPIOCHIPS > 0)
 
 /*==========================================================================*/
@@ -42,6 +79,7 @@ struct gpiochip {
 	const char			**gpio_names;
 	/* private driver data passed to ops */
 	void				*priv;
+	struct gpiochip_batch_stats	stats;
 };
 
 static struct gpiochip chips[BOARD_EXT_GPIOCHIPS];
@@ -65,6 +103,23 @@ static struct gpiochip *gpiochip_find(brain_pin_e pin)
 	return NULL;
 }
 
+/**
+ * @brief Account one batch flush of a chip
+ * @details batches could be flushed from threads and ISRs at the same time
+ */
+static void gpiochip_update_stats(struct gpiochip *chip, uint32_t count, uint32_t latency)
+{
+	syssts_t sts = chSysGetStatusAndLockX();
+	chip->stats.batches++;
+	chip->stats.pins += count;
+	chip->stats.lastLatencyNt = latency;
+	if (count > chip->stats.maxBatchSize)
+		chip->stats.maxBatchSize = count;
+	if (latency > chip->stats.maxLatencyNt)
+		chip->stats.maxLatencyNt = latency;
+	chSysRestoreStatusX(sts);
+}
+
 /*==========================================================================*/
 /* Exported functions.														*/
 /*==========================================================================*/
@@ -263,6 +318,94 @@ int gpiochips_writePad(brain_pin_e pin, int value)
 	return -1;
 }
 
+/**
+ * @brief Open batch window
+ * @details until matching gpiochips_batchEnd() pins written with gpiochips_batchWritePad() to
+ * chips which implement writePort ops are accumulated per chip, so that several outputs changing
+ * together cost one register update (one SPI exchange) instead of one per pin.
+ * Batch belongs to its caller only: writes of other threads and ISRs are never deferred by it.
+ */
+
+void gpiochips_batchBegin(struct gpiochip_batch *batch)
+{
+	for (int i = 0; i < BOARD_EXT_GPIOCHIPS; i++) {
+		batch->chips[i].mask = 0;
+		batch->chips[i].value = 0;
+		batch->chips[i].count = 0;
+	}
+	batch->since_nt = getTimeNowLowerNt();
+}
+
+/**
+ * @brief Set value to gpio of gpiochip as part of a batch
+ * @details returns -1 in case of pin not belong to any gpio chip
+ * returns 0 if write was deferred until batch end
+ * else return value from gpiochip driver
+ */
+
+int gpiochips_batchWritePad(struct gpiochip_batch *batch, brain_pin_e pin, int value)
+{
+	struct gpiochip *chip = gpiochip_find(pin);
+
+	if (!chip)
+		return -1;
+
+	if (!chip->ops->writePort)
+		return gpiochips_writePad(pin, value);
+
+	gpiochip_pending_add(&batch->chips[chip - chips], pin - chip->base, value);
+
+	return 0;
+}
+
+/**
+ * @brief Close batch window
+ * @details flushes all pending pins, one writePort call per chip.
+ * returns first negative driver return code or 0
+ */
+
+int gpiochips_batchEnd(struct gpiochip_batch *batch)
+{
+	int ret = 0;
+	uint32_t latency = getTimeNowLowerNt() - batch->since_nt;
+
+	for (int i = 0; i < BOARD_EXT_GPIOCHIPS; i++) {
+		struct gpiochip *chip = &chips[i];
+		struct gpiochip_pending *pending = &batch->chips[i];
+
+		if (pending->mask == 0)
+			continue;
+
+		gpiochip_update_stats(chip, pending->count, latency);
+
+		int chip_ret = gpiochip_pending_flush(pending, chip->ops, chip->priv);
+		if ((chip_ret < 0) && (ret == 0))
+			ret = chip_ret;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Get batching statistics of chip with given index
+ * @details returns NULL if there is no registered chip
+ */
+
+const char *gpiochips_getBatchStats(int index, struct gpiochip_batch_stats *stats)
+{
+	if ((index < 0) || (index >= BOARD_EXT_GPIOCHIPS))
+		return NULL;
+
+	struct gpiochip *chip = &chips[index];
+
+	if (!chip->base)
+		return NULL;
+
+	*stats = chip->stats;
+
+	return chip->name;
+}
+
 /**
  * @brief Get value to gpio of gpiochip
  * @details actual input value depent on current gpiochip implementation
@@ -360,6 +503,13 @@ int gpiochips_init(void)
 	return 0;
 }
 
+const char *gpiochips_getBatchStats(int index, struct gpiochip_batch_stats *stats)
+{
+	(void)index; (void)stats;
+
+	return NULL;
+}
+
 int gpiochips_get_total_pins(void)
 {
 	return 0;
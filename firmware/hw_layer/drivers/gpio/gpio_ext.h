@@ -28,6 +28,8 @@ struct gpiochip_ops {
 	/* pin argument is pin number within gpio chip, not a global number */
 	int (*setPadMode)(void *data, unsigned int pin, int mode);
 	int (*writePad)(void *data, unsigned int pin, int value);
+	/* optional: apply several pins with one register update, bit N of mask/value is pin N */
+	int (*writePort)(void *data, uint32_t mask, uint32_t value);
 	int (*readPad)(void *data, unsigned int pin);
 	brain_pin_diag_e (*getDiag)(void *data, unsigned int pin);
 	int (*init)(void *data);
@@ -54,6 +56,45 @@ int gpiochips_writePad(brain_pin_e pin, int value);
 int gpiochips_readPad(brain_pin_e pin);
 brain_pin_diag_e gpiochips_getDiag(brain_pin_e pin);
 
+/* pins of one chip collected by a batch, bit N is pin N */
+struct gpiochip_pending {
+	uint32_t mask;
+	uint32_t value;
+	uint32_t count;
+};
+
+/* merge one pin write into pending pins, later write of the same pin wins */
+void gpiochip_pending_add(struct gpiochip_pending *pending, unsigned int pin, int value);
+/* send pending pins with one writePort call and clear them, returns 0 if nothing was pending */
+int gpiochip_pending_flush(struct gpiochip_pending *pending, const struct gpiochip_ops *ops, void *priv);
+
+#if (BOARD_EXT_GPIOCHIPS > 0)
+/* owned by the caller, usually on its stack, so batches of different threads and ISRs never defer each other */
+struct gpiochip_batch {
+	struct gpiochip_pending chips[BOARD_EXT_GPIOCHIPS];
+	uint32_t since_nt;
+};
+
+void gpiochips_batchBegin(struct gpiochip_batch *batch);
+/* pins of chips with writePort ops are deferred until batch end, other pins are written right away */
+int gpiochips_batchWritePad(struct gpiochip_batch *batch, brain_pin_e pin, int value);
+int gpiochips_batchEnd(struct gpiochip_batch *batch);
+#endif /* (BOARD_EXT_GPIOCHIPS > 0) */
+
+struct gpiochip_batch_stats {
+	/* number of combined writePort calls */
+	uint32_t batches;
+	/* number of writePad requests which went into these batches */
+	uint32_t pins;
+	uint32_t maxBatchSize;
+	/* time between first deferred pin and flush, in NT */
+	uint32_t maxLatencyNt;
+	uint32_t lastLatencyNt;
+};
+
+/* returns chip name and fills stats, returns NULL if no chip at this index */
+const char *gpiochips_getBatchStats(int index, struct gpiochip_batch_stats *stats);
+
 /* return total number of external gpios */
 int gpiochips_get_total_pins(void);
 
@@ -12,6 +12,7 @@
 
 #include "global.h"
 #include "gpio/gpio_ext.h"
+#include "spi_arbiter.h"
 #include "gpio/mc33810.h"
 #include "pin_repository.h"
 #include "os_util.h"
@@ -141,10 +142,8 @@ static int mc33810_spi_rw(struct mc33810_priv *chip, uint16_t tx, uint16_t *rx)
 	uint16_t rxb;
 	SPIDriver *spi = get_bus(chip);
 
-	/* Acquire ownership of the bus. */
-	spiAcquireBus(spi);
-	/* Setup transfer parameters. */
-	spiStart(spi, &chip->cfg->spi_config);
+	/* Acquire ownership of the bus, transfer parameters are set up by arbiter if needed. */
+	spiArbiterAcquire(spi, &chip->cfg->spi_config, SPI_PRIORITY_NORMAL, MS2US(MC33810_POLL_INTERVAL_MS));
 	/* Slave Select assertion. */
 	spiSelect(spi);
 	/* Atomic transfer operations. */
@@ -154,7 +153,7 @@ static int mc33810_spi_rw(struct mc33810_priv *chip, uint16_t tx, uint16_t *rx)
 	/* Slave Select de-assertion. */
 	spiUnselect(spi);
 	/* Ownership release. */
-	spiReleaseBus(spi);
+	spiArbiterRelease(spi);
 
 	if (rx)
 		*rx = rxb;
@@ -417,12 +416,12 @@ int mc33810_writePad(void *data, unsigned int pin, int value)
 
 	chip = (struct mc33810_priv *)data;
 
-	/* TODO: lock */
+	syssts_t sts = chSysGetStatusAndLockX();
 	if (value)
 		chip->o_state |=  (1 << pin);
 	else
 		chip->o_state &= ~(1 << pin);
-	/* TODO: unlock */
+	chSysRestoreStatusX(sts);
 	/* direct driven? */
 	if (chip->o_direct_mask & (1 << pin)) {
 		/* TODO: ensure that output driver enabled */
@@ -512,8 +511,44 @@ int mc33810_deinit(void *data)
 	return 0;
 }
 
+/**
+ * @brief Set several MC33810 outputs at once
+ * @details direct driven pins are toggled one by one, all SPI driven pins
+ * share one driver wakeup and so one output register update.
+ */
+
+static int mc33810_writePort(void *data, uint32_t mask, uint32_t value)
+{
+	struct mc33810_priv *chip;
+	int ret = 0;
+
+	if (data == NULL)
+		return -1;
+
+	chip = (struct mc33810_priv *)data;
+	mask &= (1 << MC33810_OUTPUTS) - 1;
+
+	uint32_t direct = mask & chip->o_direct_mask;
+	for (unsigned int pin = 0; direct != 0; pin++, direct >>= 1) {
+		if (direct & 1)
+			ret |= mc33810_writePad(data, pin, (value >> pin) & 1);
+	}
+
+	uint32_t spi = mask & ~chip->o_direct_mask;
+	if (spi) {
+		/* writePad and writePort could be called from threads and ISRs */
+		syssts_t sts = chSysGetStatusAndLockX();
+		chip->o_state = (uint8_t)((chip->o_state & ~spi) | (value & spi));
+		chSysRestoreStatusX(sts);
+		mc33810_wake_driver(chip);
+	}
+
+	return ret;
+}
+
 struct gpiochip_ops mc33810_ops = {
 	.writePad	= mc33810_writePad,
+	.writePort	= mc33810_writePort,
 	.readPad	= NULL,	/* chip outputs only */
 	.getDiag	= mc33810_getDiag,
 	.init		= mc33810_init,
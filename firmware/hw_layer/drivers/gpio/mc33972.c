@@ -16,6 +16,7 @@
 
 #include "global.h"
 #include "gpio/gpio_ext.h"
+#include "spi_arbiter.h"
 #include "gpio/mc33972.h"
 #include "pin_repository.h"
 
@@ -113,10 +114,8 @@ static int mc33972_spi_w(struct mc33972_priv *chip, uint32_t tx)
 	txb[0] = (tx >> 16) & 0xff;
 	txb[1] = (tx >>  8) & 0xff;
 	txb[2] = (tx >>  0) & 0xff;
-	/* Acquire ownership of the bus. */
-	spiAcquireBus(spi);
-	/* Setup transfer parameters. */
-	spiStart(spi, &chip->cfg->spi_config);
+	/* Acquire ownership of the bus, transfer parameters are set up by arbiter if needed. */
+	spiArbiterAcquire(spi, &chip->cfg->spi_config, SPI_PRIORITY_NORMAL, MS2US(MC33972_POLL_INTERVAL_MS));
 	/* Slave Select assertion. */
 	spiSelect(spi);
 	/* Atomic transfer operations. */
@@ -127,7 +126,7 @@ static int mc33972_spi_w(struct mc33972_priv *chip, uint32_t tx)
 	/* Slave Select de-assertion. */
 	spiUnselect(spi);
 	/* Ownership release. */
-	spiReleaseBus(spi);
+	spiArbiterRelease(spi);
 
 	/* save received data */
 	chip->i_state = (rxb[0] << 16) | (rxb[1] << 8) | (rxb[2] << 0);
@@ -22,6 +22,7 @@
 
 #include "global.h"
 #include "gpio/gpio_ext.h"
+#include "spi_arbiter.h"
 #include "gpio/tle6240.h"
 #include "pin_repository.h"
 #include "os_util.h"
@@ -129,10 +130,8 @@ static int tle6240_spi_rw(struct tle6240_priv *chip, uint16_t tx, uint16_t *rx)
 	uint16_t rxb;
 	SPIDriver *spi = get_bus(chip);
 
-	/* Acquire ownership of the bus. */
-	spiAcquireBus(spi);
-	/* Setup transfer parameters. */
-	spiStart(spi, &chip->cfg->spi_config);
+	/* Acquire ownership of the bus, transfer parameters are set up by arbiter if needed. */
+	spiArbiterAcquire(spi, &chip->cfg->spi_config, SPI_PRIORITY_NORMAL, MS2US(TLE6240_POLL_INTERVAL_MS));
 	/* Slave Select assertion. */
 	spiSelect(spi);
 	/* Atomic transfer operations. */
@@ -142,7 +141,7 @@ static int tle6240_spi_rw(struct tle6240_priv *chip, uint16_t tx, uint16_t *rx)
 	/* Slave Select de-assertion. */
 	spiUnselect(spi);
 	/* Ownership release. */
-	spiReleaseBus(spi);
+	spiArbiterRelease(spi);
 
 	if (rx)
 		*rx = rxb;
@@ -385,12 +384,12 @@ static int tle6240_writePad(void *data, unsigned int pin, int value)
 
 	chip = (struct tle6240_priv *)data;
 
-	/* TODO: lock */
+	syssts_t sts = chSysGetStatusAndLockX();
 	if (value)
 		chip->o_state |=  (1 << pin);
 	else
 		chip->o_state &= ~(1 << pin);
-	/* TODO: unlock */
+	chSysRestoreStatusX(sts);
 	/* direct driven? */
 	if (chip->o_direct_mask & (1 << pin)) {
 		int n = (pin < 8) ? pin : (pin - 4);
@@ -464,8 +463,44 @@ static int tle6240_deinit(void *data)
 	return 0;
 }
 
+/**
+ * @brief Set several TLE6240 outputs at once
+ * @details direct driven pins are toggled one by one, all SPI driven pins
+ * share one driver wakeup and so one output register update.
+ */
+
+static int tle6240_writePort(void *data, uint32_t mask, uint32_t value)
+{
+	struct tle6240_priv *chip;
+	int ret = 0;
+
+	if (data == NULL)
+		return -1;
+
+	chip = (struct tle6240_priv *)data;
+	mask &= (1 << TLE6240_OUTPUTS) - 1;
+
+	uint32_t direct = mask & chip->o_direct_mask;
+	for (unsigned int pin = 0; direct != 0; pin++, direct >>= 1) {
+		if (direct & 1)
+			ret |= tle6240_writePad(data, pin, (value >> pin) & 1);
+	}
+
+	uint32_t spi = mask & ~chip->o_direct_mask;
+	if (spi) {
+		/* writePad and writePort could be called from threads and ISRs */
+		syssts_t sts = chSysGetStatusAndLockX();
+		chip->o_state = (uint16_t)((chip->o_state & ~spi) | (value & spi));
+		chSysRestoreStatusX(sts);
+		tle6240_wake_driver(chip);
+	}
+
+	return ret;
+}
+
 struct gpiochip_ops tle6240_ops = {
 	.writePad	= tle6240_writePad,
+	.writePort	= tle6240_writePort,
 	.readPad	= NULL,	/* chip outputs only */
 	.getDiag	= tle6240_getDiag,
 	.init		= tle6240_init,
@@ -38,6 +38,7 @@
 #include "persistent_configuration.h"
 #include "hardware.h"
 #include "gpio/gpio_ext.h"
+#include "spi_arbiter.h"
 #include "pin_repository.h"
 #include "os_util.h"
 
@@ -269,10 +270,8 @@ static int tle8888_spi_rw(struct tle8888_priv *chip, uint16_t tx, uint16_t *rx)
 	 * wrong access mode the data is always 0)
 	 */
 
-	/* Acquire ownership of the bus. */
-	spiAcquireBus(spi);
-	/* Setup transfer parameters. */
-	spiStart(spi, &chip->cfg->spi_config);
+	/* Acquire ownership of the bus, transfer parameters are set up by arbiter if needed. */
+	spiArbiterAcquire(spi, &chip->cfg->spi_config, SPI_PRIORITY_NORMAL, MS2US(TLE8888_POLL_INTERVAL_MS));
 	/* Slave Select assertion. */
 	spiSelect(spi);
 	/* Atomic transfer operations. */
@@ -281,7 +280,7 @@ static int tle8888_spi_rw(struct tle8888_priv *chip, uint16_t tx, uint16_t *rx)
 	/* Slave Select de-assertion. */
 	spiUnselect(spi);
 	/* Ownership release. */
-	spiReleaseBus(spi);
+	spiArbiterRelease(spi);
 
 	spiTxb = tx;
 	tle8888SpiCounter++;
@@ -637,13 +636,13 @@ int tle8888_writePad(void *data, unsigned int pin, int value) {
 
 	struct tle8888_priv *chip = (struct tle8888_priv *)data;
 
-	/* TODO: lock */
+	syssts_t sts = chSysGetStatusAndLockX();
 	if (value) {
 		chip->o_state |=  (1 << pin);
 	} else {
 		chip->o_state &= ~(1 << pin);
 	}
-	/* TODO: unlock */
+	chSysRestoreStatusX(sts);
 	/* direct driven? */
 	if (chip->o_direct_mask & (1 << pin)) {
 		return tle8888_update_direct_output(chip, pin, value);
@@ -771,8 +770,44 @@ int tle8888_deinit(void *data)
 	return 0;
 }
 
+/**
+ * @brief Set several TLE8888 outputs at once
+ * @details direct driven pins are toggled one by one, all SPI driven pins
+ * share one driver wakeup and so one output register update.
+ */
+
+static int tle8888_writePort(void *data, uint32_t mask, uint32_t value)
+{
+	struct tle8888_priv *chip;
+	int ret = 0;
+
+	if (data == NULL)
+		return -1;
+
+	chip = (struct tle8888_priv *)data;
+	mask &= (1 << TLE8888_OUTPUTS) - 1;
+
+	uint32_t direct = mask & chip->o_direct_mask;
+	for (unsigned int pin = 0; direct != 0; pin++, direct >>= 1) {
+		if (direct & 1)
+			ret |= tle8888_writePad(data, pin, (value >> pin) & 1);
+	}
+
+	uint32_t spi = mask & ~chip->o_direct_mask;
+	if (spi) {
+		/* writePad and writePort could be called from threads and ISRs */
+		syssts_t sts = chSysGetStatusAndLockX();
+		chip->o_state = ((chip->o_state & ~spi) | (value & spi));
+		chSysRestoreStatusX(sts);
+		tle8888_wake_driver(chip);
+	}
+
+	return ret;
+}
+
 struct gpiochip_ops tle8888_ops = {
 	.writePad	= tle8888_writePad,
+	.writePort	= tle8888_writePort,
 	.readPad	= NULL,	/* chip outputs only */
 	//.getDiag	= tle8888_getDiag,
 	.init		= tle8888_init,
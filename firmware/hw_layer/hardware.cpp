@@ -36,8 +36,10 @@
 #include "idle_thread.h"
 #include "mcp3208.h"
 #include "hip9011.h"
+#include "software_knock.h"
 #include "histogram.h"
 #include "mmc_card.h"
+#include "spi_arbiter.h"
 #include "neo6m.h"
 #include "lcd_HD44780.h"
 #include "settings.h"
@@ -69,8 +71,6 @@
 
 EXTERN_ENGINE;
 
-static mutex_t spiMtx;
-
 #if HAL_USE_SPI
 extern bool isSpiInitialized[5];
 
@@ -79,20 +79,6 @@ extern bool isSpiInitialized[5];
  */
 bool rtcWorks = true;
 
-/**
- * Only one consumer can use SPI bus at a given time
- */
-void lockSpi(spi_device_e device) {
-	UNUSED(device);
-	efiAssertVoid(CUSTOM_STACK_SPI, getCurrentRemainingStack() > 128, "lockSpi");
-	// todo: different locks for different SPI devices!
-	chMtxLock(&spiMtx);
-}
-
-void unlockSpi(void) {
-	chMtxUnlock(&spiMtx);
-}
-
 static void initSpiModules(engine_configuration_s *engineConfiguration) {
 	UNUSED(engineConfiguration);
 	if (CONFIG(is_enabled_spi_1)) {
@@ -427,7 +413,9 @@ void initHardware(Logging *l) {
 	// 10 extra seconds to re-flash the chip
 	//flashProtect();
 
-	chMtxObjectInit(&spiMtx);
+#if HAL_USE_SPI
+	initSpiArbiter(sharedLogger);
+#endif /* HAL_USE_SPI */
 
 #if EFI_HISTOGRAMS
 	/**
@@ -543,6 +531,10 @@ void initHardware(Logging *l) {
 	initHip9011(sharedLogger);
 #endif /* EFI_HIP_9011 */
 
+#if EFI_SOFTWARE_KNOCK
+	initSoftwareKnock(sharedLogger);
+#endif /* EFI_SOFTWARE_KNOCK */
+
 #if EFI_FILE_LOGGING
 	initMmcCard();
 #endif /* EFI_FILE_LOGGING */
@@ -36,6 +36,7 @@
 #include "engine.h"
 #include "settings.h"
 #include "hardware.h"
+#include "spi_arbiter.h"
 #include "rpm_calculator.h"
 #include "trigger_central.h"
 #include "hip9011_logic.h"
@@ -111,15 +112,35 @@ static void checkResponse(void) {
 
 // this macro is only used on startup
 #define SPI_SYNCHRONOUS(value) \
+	spiArbiterAcquire(driver, &hipSpiCfg, SPI_PRIORITY_URGENT, 0); \
 	spiSelect(driver); \
 	tx_buff[0] = value; \
 	spiExchange(driver, 1, tx_buff, rx_buff); \
 	spiUnselect(driver); \
+	spiArbiterRelease(driver); \
 	checkResponse();
 
 
 static SPIDriver *driver;
 
+/**
+ * knock window commands are sent from ISR, they go ahead of everything else waiting for the bus
+ */
+static spi_request_s hipRequest;
+static volatile bool isHipRequestQueued = false;
+/**
+ * command sent after a window has to reach the chip before next window starts, zero if not known yet
+ */
+static volatile efitick_t nextWindowStartNt = 0;
+static efitick_t previousCycleStartNt = 0;
+
+static void onHipSpiGranted(spi_request_s *request) {
+	(void)request;
+	isHipRequestQueued = false;
+	spiSelectI(driver);
+	spiStartExchangeI(driver, 1, tx_buff, rx_buff);
+}
+
 void Hip9011Hardware::sendSyncCommand(unsigned char command) {
 	SPI_SYNCHRONOUS(command);
 	chThdSleepMilliseconds(10);
@@ -127,9 +148,13 @@ void Hip9011Hardware::sendSyncCommand(unsigned char command) {
 
 void Hip9011Hardware::sendCommand(unsigned char command) {
 	tx_buff[0] = command;
-
-	spiSelectI(driver);
-	spiStartExchangeI(driver, 1, tx_buff, rx_buff);
+	if (isHipRequestQueued) {
+		// previous command has not reached the chip yet, now it would be this one
+		return;
+	}
+	isHipRequestQueued = true;
+	hipRequest.deadlineNt = nextWindowStartNt;
+	spiArbiterSubmitI(driver, &hipSpiCfg, &hipRequest);
 }
 
 EXTERN_ENGINE;
@@ -253,13 +278,20 @@ static void intHoldCallback(trigger_event_e ckpEventType, uint32_t index, efitic
 	ScopePerf perf(PE::Hip9011IntHoldCallback);
 
 	int rpm = GET_RPM_VALUE;
-	if (!isValidRpm(rpm))
+	if (!isValidRpm(rpm)) {
+		previousCycleStartNt = 0;
+		nextWindowStartNt = 0;
 		return;
+	}
 
 	int structIndex = getRevolutionCounter() % 2;
 	// todo: schedule this based on closest trigger event, same as ignition works
-	scheduleByAngle(&startTimer[structIndex], edgeTimestamp, engineConfiguration->knockDetectionWindowStart,
-			&startIntegration);
+	efitick_t windowStartNt = scheduleByAngle(&startTimer[structIndex], edgeTimestamp,
+			engineConfiguration->knockDetectionWindowStart, &startIntegration);
+	if (previousCycleStartNt != 0) {
+		nextWindowStartNt = windowStartNt + (edgeTimestamp - previousCycleStartNt);
+	}
+	previousCycleStartNt = edgeTimestamp;
 #if EFI_PROD_CODE
 	hipLastExecutionCount = lastExecutionCount;
 #endif /* EFI_PROD_CODE */
@@ -297,6 +329,7 @@ void setHipGain(float value) {
 static void endOfSpiExchange(SPIDriver *spip) {
 	(void)spip;
 	spiUnselectI(driver);
+	spiArbiterReleaseI(driver);
 	instance.state = READY_TO_INTEGRATE;
 	checkResponse();
 }
@@ -352,11 +385,13 @@ static void hipStartupCode(void) {
 	 * Let's restart SPI to switch it from synchronous mode into
 	 * asynchronous mode
 	 */
+	spiArbiterAcquire(driver, &hipSpiCfg, SPI_PRIORITY_URGENT, 0);
 	spiStop(driver);
 #if EFI_PROD_CODE
 	hipSpiCfg.end_cb = endOfSpiExchange;
 #endif
 	spiStart(driver, &hipSpiCfg);
+	spiArbiterRelease(driver);
 	instance.state = READY_TO_INTEGRATE;
 }
 
@@ -420,6 +455,8 @@ void initHip9011(Logging *sharedLogger) {
 
 	scheduleMsg(logger, "Starting HIP9011/TPIC8101 driver");
 	spiStart(driver, &hipSpiCfg);
+	hipRequest.priority = SPI_PRIORITY_URGENT;
+	hipRequest.onGrant = onHipSpiGranted;
 
 	instance.currentBandIndex = getBandIndex();
 
@@ -18,6 +18,7 @@ HW_LAYER_EMS_CPP = $(HW_LAYER_EGT_CPP) \
 	$(PROJECT_DIR)/hw_layer/digital_input_icu.cpp \
 	$(PROJECT_DIR)/hw_layer/digital_input_exti.cpp \
 	$(PROJECT_DIR)/hw_layer/hardware.cpp \
+	$(PROJECT_DIR)/hw_layer/spi_arbiter.cpp \
 	$(PROJECT_DIR)/hw_layer/smart_gpio.cpp \
 	$(PROJECT_DIR)/hw_layer/neo6m.cpp \
 	$(PROJECT_DIR)/hw_layer/mmc_card.cpp \
@@ -30,6 +31,7 @@ HW_LAYER_EMS_CPP = $(HW_LAYER_EGT_CPP) \
 	$(PROJECT_DIR)/hw_layer/hip9011.cpp \
 	$(PROJECT_DIR)/hw_layer/mc33816.cpp \
 	$(PROJECT_DIR)/hw_layer/hip9011_logic.cpp \
+	$(PROJECT_DIR)/hw_layer/software_knock.cpp \
 	$(PROJECT_DIR)/hw_layer/vehicle_speed.cpp \
 	$(PROJECT_DIR)/hw_layer/stepper.cpp \
 	$(PROJECT_DIR)/hw_layer/stepper_dual_hbridge.cpp \
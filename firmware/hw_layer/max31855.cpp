@@ -21,6 +21,7 @@
 #include "mpu_util.h"
 #include "settings.h"
 #include "pin_repository.h"
+#include "spi_arbiter.h"
 #endif /* EFI_PROD_CODE */
 
 #if EFI_MAX_31855
@@ -94,13 +95,14 @@ static uint32_t readEgtPacket(int egtChannel) {
 		return 0xFFFFFFFF;
 	}
 
-	spiStart(driver, &spiConfig[egtChannel]);
+	// each channel has its own chip select, arbiter restarts the driver only if configuration has changed
+	spiArbiterAcquire(driver, &spiConfig[egtChannel], SPI_PRIORITY_NORMAL, 0);
 	spiSelect(driver);
 
 	spiReceive(driver, sizeof(egtPacket), &egtPacket);
 
 	spiUnselect(driver);
-	spiStop(driver);
+	spiArbiterRelease(driver);
 	egtPacket = SWAP_UINT32(egtPacket);
 	return egtPacket;
 }
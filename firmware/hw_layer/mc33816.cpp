@@ -22,6 +22,7 @@
 #include "hardware.h"
 #include "mc33816_data.h"
 #include "mpu_util.h"
+#include "spi_arbiter.h"
 
 EXTERN_CONFIG;
 
@@ -70,6 +71,19 @@ static void showStats() {
 static void mcRestart();
 
 
+/**
+ * Chip is only configured from thread context, SPI3 is still shared through the arbiter
+ */
+static void mcSelect() {
+	spiArbiterAcquire(driver, &spiCfg, SPI_PRIORITY_NORMAL, 0);
+	spiSelect(driver);
+}
+
+static void mcUnselect() {
+	spiUnselect(driver);
+	spiArbiterRelease(driver);
+}
+
 // Receive 16bits
 unsigned short recv_16bit_spi() {
 	unsigned short ret;
@@ -96,7 +110,7 @@ static void spi_writew(unsigned short param) {
 }
 
 static void setup_spi() {
-	spiSelect(driver);
+	mcSelect();
 	// Select Channel command
 	spi_writew(0x7FE1);
     // Common Page
@@ -108,21 +122,21 @@ static void setup_spi() {
 	// Mode A + Watchdog timer full
     //spi_writew(0x001F);
 	spi_writew(0x009F); // + fast slew rate on miso
-	spiUnselect(driver);
+	mcUnselect();
 }
 
 static unsigned short readId() {
-	spiSelect(driver);
+	mcSelect();
 	spi_writew(0xBAA1);
 	unsigned short ID =  recv_16bit_spi();
-	spiUnselect(driver);
+	mcUnselect();
 	return ID;
 }
 
 // Read a single word in Data RAM
 unsigned short mcReadDram(MC33816Mem addr) {
 	unsigned short readValue;
-	spiSelect(driver);
+	mcSelect();
 	// Select Channel command, Common Page
     spi_writew(0x7FE1);
     spi_writew(0x0004);
@@ -130,13 +144,13 @@ unsigned short mcReadDram(MC33816Mem addr) {
     spi_writew((0x8000 | addr << 5) + 1);
     readValue = recv_16bit_spi();
 
-    spiUnselect(driver);
+    mcUnselect();
     return readValue;
 }
 
 // Update a single word in Data RAM
 void mcUpdateDram(MC33816Mem addr, unsigned short data) {
-	spiSelect(driver);
+	mcSelect();
 	// Select Channel command, Common Page
     spi_writew(0x7FE1);
     spi_writew(0x0004);
@@ -144,7 +158,7 @@ void mcUpdateDram(MC33816Mem addr, unsigned short data) {
     spi_writew((addr << 5) + 1);
     spi_writew(data);
 
-    spiUnselect(driver);
+    mcUnselect();
 }
 
 void setBoostVoltage(float volts)
@@ -166,13 +180,13 @@ void setBoostVoltage(float volts)
 }
 
 static bool check_flash() {
-	spiSelect(driver);
+	mcSelect();
 
 	// ch1
 	// read (MSB=1) at location, and 1 word
     spi_writew((0x8000 | 0x100 << 5) + 1);
     if (!(recv_16bit_spi() & (1<<5))) {
-    	spiUnselect(driver);
+    	mcUnselect();
     	return false;
     }
 
@@ -181,21 +195,21 @@ static bool check_flash() {
     spi_writew((0x8000 | 0x120 << 5) + 1);
 
     if (!(recv_16bit_spi() & (1<<5))) {
-    	spiUnselect(driver);
+    	mcUnselect();
     	return false;
     }
 
-    spiUnselect(driver);
+    mcUnselect();
 	return true;
 }
 
 static void enable_flash() {
-	spiSelect(driver);
+	mcSelect();
     spi_writew(0x2001); //ch1
     spi_writew(0x0018); //enable flash
     spi_writew(0x2401); //ch2
     spi_writew(0x0018); // enable flash
-    spiUnselect(driver);
+    mcUnselect();
 }
 
 static void download_RAM(int target) {
@@ -242,7 +256,7 @@ static void download_RAM(int target) {
    }
 
    // Chip-Select high
-   spiSelect(driver);
+   mcSelect();
 
    if (target != DATA_RAM)
    {
@@ -272,7 +286,7 @@ static void download_RAM(int target) {
    }
    */
    spiSend(driver, size, RAM_ptr);
-   spiUnselect(driver);
+   mcUnselect();
 }
 
 static void download_register(int r_target) {
@@ -336,7 +350,7 @@ static void download_register(int r_target) {
 	   r_command = r_start_address << 5;      // start address
 	   r_command += r_size;                   // number of words to follow
 
-	   spiSelect(driver);						// Chip
+	   mcSelect();						// Chip
 
 	   spi_writew(r_command);             // sends address and number of words to be sent
 
@@ -351,7 +365,7 @@ static void download_register(int r_target) {
 	      spi_writew(r_command);          // sends address and number of words to be sent
 	      spiSend(driver, remainder_size, reg_ptr + r_size);
 	   }
-	   spiUnselect(driver);
+	   mcUnselect();
 }
 
 void initMc33816(Logging *sharedLogger) {
@@ -390,7 +404,7 @@ void initMc33816(Logging *sharedLogger) {
 		return;
 	}
 
-	spiStart(driver, &spiCfg);
+	// driver is started with spiCfg by SPI arbiter on first exchange
 
 	addConsoleAction("mc33_stats", showStats);
 	addConsoleAction("mc33_restart", mcRestart);
@@ -409,7 +423,9 @@ static void mcRestart() {
 	driven.setValue(0); // ensure driven is off
 
 	// Does starting turn this high to begin with??
+	spiArbiterAcquire(driver, &spiCfg, SPI_PRIORITY_NORMAL, 0);
 	spiUnselect(driver);
+	spiArbiterRelease(driver);
 
 	//delay/wait? .. possibly only 30us for each needed, per datasheet
 	resetB.setValue(0);
@@ -12,6 +12,7 @@
 #if EFI_MCP_3208
 #include "mcp3208.h"
 #include "pin_repository.h"
+#include "spi_arbiter.h"
 
 McpAdcState *hack;
 
@@ -26,16 +27,9 @@ int getMcp3208adc(int channel) {
 	return getValue(hack, channel);
 }
 
-static int getNextChannel(void) {
-	return adcEventCounter % 2;
-}
-
-static void spiCallback(SPIDriver *spip) {
-	spiUnselectI(spip);
+static void onExchangeDone(McpAdcState *state) {
 	adcEventCounter++;
 
-	McpAdcState *state = hack;
-
 	int withError = 0;
 
 	if (state->rx_buff[0] != 255) {
@@ -55,11 +49,9 @@ static void spiCallback(SPIDriver *spip) {
 	} else {
 		adcErrorCounter++;
 	}
-
-	requestAdcValueI(state, getNextChannel());
 }
 
-static const SPIConfig spicfg = { spiCallback,
+static const SPIConfig spicfg = { NULL,
 /* HW dependent part.*/
 MCP3208_CS_PORT,
 MCP3208_CS_PIN,
@@ -77,20 +69,20 @@ static void createRequest(McpAdcState *state, int channel) {
 	state->tx_buff[1] = (channel & 3) << 6;
 }
 
+/**
+ * One exchange per request: chip used to be polled by a chain of exchanges started from SPI callback, that way
+ * it would never give the bus to anyone else.
+ */
 void requestAdcValue(McpAdcState *state, int channel) {
 	createRequest(state, channel);
 
+	spiArbiterAcquire(state->driver, &spicfg, SPI_PRIORITY_NORMAL, 0);
 	spiSelect(state->driver);
-	spiStartExchange(state->driver, 3, state->tx_buff, state->rx_buff);
-	// SPI unselect is in the callback
-}
-
-void requestAdcValueI(McpAdcState *state, int channel) {
-	createRequest(state, channel);
+	spiExchange(state->driver, 3, state->tx_buff, state->rx_buff);
+	spiUnselect(state->driver);
+	spiArbiterRelease(state->driver);
 
-	spiSelectI(state->driver);
-	spiStartExchangeI(state->driver, 3, state->tx_buff, state->rx_buff);
-	// SPI unselect is in the callback
+	onExchangeDone(state);
 }
 
 void adc_in_out(McpAdcState *state) {
@@ -135,8 +127,7 @@ void init_adc_mcp3208(McpAdcState *state, SPIDriver *driver) {
 	todo: convert to new API, todo: array of CS
 	mySetPadMod("ext adc chip select", MCP3208_CS_PORT, MCP3208_CS_PIN, PAL_STM32_MODE_OUTPUT);
 
-
-	spiStart(driver, &spicfg);
+	// driver is started with spicfg by SPI arbiter on first exchange
 }
 
 #endif /* EFI_MCP_3208 */
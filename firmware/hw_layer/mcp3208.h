@@ -35,7 +35,6 @@ typedef struct {
 
 void init_adc_mcp3208(McpAdcState *state, SPIDriver *driver);
 void requestAdcValue(McpAdcState *state, int channel);
-void requestAdcValueI(McpAdcState *state, int channel);
 void adc_in_out(McpAdcState *state);
 
 int getMcp3208adc(int channel);
@@ -22,6 +22,7 @@
 #include "pin_repository.h"
 #include "ff.h"
 #include "hardware.h"
+#include "spi_arbiter.h"
 #include "engine_configuration.h"
 #include "status_loop.h"
 #include "usb_msd_cfg.h"
@@ -42,13 +43,67 @@ static bool fs_ready = false;
 
 EXTERN_ENGINE;
 
-#define F_SYNC_FREQUENCY 100
+#define SD_SECTOR_SIZE 512
+/**
+ * Log lines are collected in one half while SD writer thread writes the other one. Halves are always
+ * handed over completely full so that card only sees whole sector multi-block writes.
+ */
+#ifndef SD_LOG_BUFFER_SIZE
+#define SD_LOG_BUFFER_SIZE (8 * SD_SECTOR_SIZE)
+#endif
+/**
+ * SPI bus is shared with CJ125, HIP9011 and smart drivers: bus is released after this many bytes
+ * so that waiting urgent transactions could go ahead
+ */
+#define SD_WRITE_CHUNK_SIZE SPI_BULK_CHUNK_SIZE
+/**
+ * f_sync once per this many buffers
+ */
+#define SD_SYNC_FREQUENCY 8
+/**
+ * Contiguous area is allocated for new log file so that growing file does not have to look for free clusters
+ */
+#define SD_LOG_PREALLOCATE_SIZE (16 * 1024 * 1024)
 
 static int totalLoggedBytes = 0;
 static int fileCreatedCounter = 0;
-static int writeCounter = 0;
 static int totalWritesCounter = 0;
 static int totalSyncCounter = 0;
+static int droppedRecordsCounter = 0;
+static int bufferWriteCounter = 0;
+static uint32_t totalWrittenBytes = 0;
+static efitick_t totalWriteDurationNt = 0;
+static uint32_t maxSpiLockNt = 0;
+static bool isPreallocated = false;
+
+typedef struct {
+	char data[SD_LOG_BUFFER_SIZE];
+	int size;
+	/**
+	 * lines which start in this buffer, added to droppedRecordsCounter if buffer could not be written
+	 */
+	int recordCount;
+} sd_log_buffer_s;
+
+static sd_log_buffer_s logBuffers[2] NO_CACHE;
+/**
+ * index of the buffer appendToLog is filling
+ */
+static int activeBuffer = 0;
+/**
+ * index of the full buffer handed over to SD writer thread, -1 if writer is idle
+ */
+static volatile int writingBuffer = -1;
+static binary_semaphore_t sdWriterSemaphore;
+/**
+ * Log file is only ever touched by SD writer thread: unmount is a request to that thread
+ */
+static volatile bool isUnmountRequested = false;
+/**
+ * set under lock while SD writer thread is flushing buffers before close, appendToLog drops lines meanwhile
+ */
+static bool isLogFileClosing = false;
+static binary_semaphore_t sdUnmountSemaphore;
 
 #define LOG_INDEX_FILENAME "index.txt"
 
@@ -71,6 +126,7 @@ extern const USBConfig msdusbcfg;
 
 
 static THD_WORKING_AREA(mmcThreadStack,3 * UTILITY_THREAD_STACK_SIZE);		// MMC monitor thread
+static THD_WORKING_AREA(sdWriterThreadStack, 2 * UTILITY_THREAD_STACK_SIZE);
 
 /**
  * MMC driver instance.
@@ -96,6 +152,18 @@ static SPIConfig ls_spicfg = {
 // don't forget check if STM32_SPI_USE_SPI2 defined and spi has init with correct GPIO in hardware.cpp
 static MMCConfig mmccfg = { NULL, &ls_spicfg, &hs_spicfg };
 
+/**
+ * MMC driver only restarts SPI while connecting, reads and writes expect the driver to be running with
+ * high speed configuration. Giving it to the arbiter also tells ISR users that driver has to be restarted for them.
+ */
+static void lockSdSpi(void) {
+	spiArbiterAcquire(mmccfg.spip, &hs_spicfg, SPI_PRIORITY_BULK, 0);
+}
+
+static void unlockSdSpi(void) {
+	spiArbiterRelease(mmccfg.spip);
+}
+
 /**
  * fatfs MMC/SPI
  */
@@ -105,10 +173,12 @@ static LoggingWithStorage logger("mmcCard");
 
 static int fatFsErrors = 0;
 
-static void mmcUnMount(void);
-
 static void setSdCardReady(bool value) {
 	fs_ready = value;
+#if EFI_TUNER_STUDIO
+	// 'hasSdCard' is in version group
+	invalidateOutputChannelGroups(1 << OCG_VERSION);
+#endif /* EFI_TUNER_STUDIO */
 }
 
 // print FAT error function
@@ -139,12 +209,19 @@ static void sdStatistics(void) {
 	scheduleMsg(&logger, "SD enabled=%s status=%s", boolToString(CONFIG(isSdCardEnabled)),
 			sdStatus);
 	if (isSdCardAlive()) {
-		scheduleMsg(&logger, "filename=%s size=%d", logName, totalLoggedBytes);
+		scheduleMsg(&logger, "filename=%s size=%d preallocated=%s", logName, totalLoggedBytes,
+				boolToString(isPreallocated));
+	}
+	int writeMs = NT2US(totalWriteDurationNt) / 1000;
+	scheduleMsg(&logger, "written=%d in %dms buffers=%d syncs=%d dropped=%d max SPI lock=%dus", totalWrittenBytes,
+			writeMs, bufferWriteCounter, totalSyncCounter, droppedRecordsCounter, (int)NT2US(maxSpiLockNt));
+	if (writeMs > 0) {
+		scheduleMsg(&logger, "write throughput %dKB/s", totalWrittenBytes / writeMs);
 	}
 }
 
 static void incLogFileName(void) {
-	lockSpi(SPI_NONE);
+	lockSdSpi();
 	memset(&FDCurrFile, 0, sizeof(FIL));						// clear the memory
 	FRESULT err = f_open(&FDCurrFile, LOG_INDEX_FILENAME, FA_READ);				// This file has the index for next log file name
 
@@ -176,7 +253,7 @@ static void incLogFileName(void) {
 	f_write(&FDCurrFile, (void*)data, strlen(data), &result);
 	f_close(&FDCurrFile);
 	scheduleMsg(&logger, "Done %d", logFileIndex);
-	unlockSpi();
+	unlockSdSpi();
 }
 
 static void prepareLogFileName(void) {
@@ -199,13 +276,13 @@ static void prepareLogFileName(void) {
  * so that we can later append to that file
  */
 static void createLogFile(void) {
-	lockSpi(SPI_NONE);
+	lockSdSpi();
 	memset(&FDLogFile, 0, sizeof(FIL));						// clear the memory
 	prepareLogFileName();
 
 	FRESULT err = f_open(&FDLogFile, logName, FA_OPEN_ALWAYS | FA_WRITE);				// Create new file
 	if (err != FR_OK && err != FR_EXIST) {
-		unlockSpi();
+		unlockSdSpi();
 		sdStatus = SD_STATE_OPEN_FAILED;
 		warning(CUSTOM_ERR_SD_MOUNT_FAILED, "SD: mount failed");
 		printError("FS mount failed", err);	// else - show error
@@ -214,15 +291,24 @@ static void createLogFile(void) {
 
 	err = f_lseek(&FDLogFile, f_size(&FDLogFile)); // Move to end of the file to append data
 	if (err) {
-		unlockSpi();
+		unlockSdSpi();
 		sdStatus = SD_STATE_SEEK_FAILED;
 		warning(CUSTOM_ERR_SD_SEEK_FAILED, "SD: seek failed");
 		printError("Seek error", err);
 		return;
 	}
+	/**
+	 * Only possible for a new empty file. Mode 1 allocates the whole area right away and file pointer stays
+	 * at zero, file is truncated to what was actually written on close.
+	 */
+	efitick_t startNt = getTimeNowNt();
+	isPreallocated = f_size(&FDLogFile) == 0 && f_expand(&FDLogFile, SD_LOG_PREALLOCATE_SIZE, 1) == FR_OK;
+	// FAT walk is done under SD SPI lock same as any write
+	uint32_t durationNt = getTimeNowNt() - startNt;
+	maxSpiLockNt = maxI(maxSpiLockNt, durationNt);
 	f_sync(&FDLogFile);
 	setSdCardReady(true);						// everything Ok
-	unlockSpi();
+	unlockSdSpi();
 }
 
 static void removeFile(const char *pathx) {
@@ -230,10 +316,10 @@ static void removeFile(const char *pathx) {
 		scheduleMsg(&logger, "Error: No File system is mounted");
 		return;
 	}
-	lockSpi(SPI_NONE);
+	lockSdSpi();
 	f_unlink(pathx);
 
-	unlockSpi();
+	unlockSdSpi();
 }
 
 int
@@ -261,14 +347,14 @@ static void listDirectory(const char *path) {
 		scheduleMsg(&logger, "Error: No File system is mounted");
 		return;
 	}
-	lockSpi(SPI_NONE);
+	lockSdSpi();
 
 	DIR dir;
 	FRESULT res = f_opendir(&dir, path);
 
 	if (res != FR_OK) {
 		scheduleMsg(&logger, "Error opening directory %s", path);
-		unlockSpi();
+		unlockSdSpi();
 		return;
 	}
 
@@ -294,7 +380,7 @@ static void listDirectory(const char *path) {
 //					(fno.fdate >> 5) & 15, fno.fdate & 31, (fno.ftime >> 11), (fno.ftime >> 5) & 63, fno.fsize,
 //					fno.fname);
 	}
-	unlockSpi();
+	unlockSdSpi();
 }
 
 static int errorReported = FALSE; // this is used to report the error only once
@@ -304,40 +390,189 @@ void readLogFileContent(char *buffer, short fileId, short offset, short length)
 }
 #endif
 
+/**
+ * Writes in SD_WRITE_CHUNK_SIZE portions, each under its own SPI lock. File position is kept sector aligned
+ * so that FatFS writes straight from our buffer with multi-block writes instead of going through its sector buffer.
+ * This method is invoked on SD writer thread only.
+ */
+static bool writeToLogFile(const char *data, int size) {
+	while (size > 0) {
+		int misalignment = f_tell(&FDLogFile) % SD_SECTOR_SIZE;
+		int chunk = minI(size, misalignment == 0 ? SD_WRITE_CHUNK_SIZE : SD_SECTOR_SIZE - misalignment);
+		UINT bytesWritten;
+
+		lockSdSpi();
+		efitick_t startNt = getTimeNowNt();
+		FRESULT err = f_write(&FDLogFile, data, chunk, &bytesWritten);
+		uint32_t durationNt = getTimeNowNt() - startNt;
+		unlockSdSpi();
+
+		totalWriteDurationNt += durationNt;
+		maxSpiLockNt = maxI(maxSpiLockNt, durationNt);
+		totalWritesCounter++;
+		if (bytesWritten < (UINT)chunk) {
+			printError("write error or disk full", err); // error or disk full
+			return false;
+		}
+		totalWrittenBytes += bytesWritten;
+		data += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+static void syncLogFile(void) {
+	lockSdSpi();
+	efitick_t startNt = getTimeNowNt();
+	f_sync(&FDLogFile);
+	uint32_t durationNt = getTimeNowNt() - startNt;
+	maxSpiLockNt = maxI(maxSpiLockNt, durationNt);
+	unlockSdSpi();
+	totalSyncCounter++;
+}
+
+/**
+ * @return false if there was a write error
+ */
+static bool writeLogBuffer(sd_log_buffer_s *buffer) {
+	bool isOk = buffer->size == 0 || writeToLogFile(buffer->data, buffer->size);
+	if (!isOk) {
+		droppedRecordsCounter += buffer->recordCount;
+	}
+	buffer->size = 0;
+	buffer->recordCount = 0;
+	return isOk;
+}
+
+/**
+ * Writes whatever is left in log buffers and closes the file. Invoked on SD writer thread.
+ */
+static void closeLogFile(void) {
+	bool alreadyLocked = lockAnyContext();
+	// appendToLog checks this under the same lock, so from now on both buffers are ours
+	isLogFileClosing = true;
+	int handedOver = writingBuffer;
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
+
+	bool isOk = true;
+	if (handedOver >= 0) {
+		isOk = writeLogBuffer(&logBuffers[handedOver]);
+		handedOver ^= 1;
+	} else {
+		handedOver = activeBuffer;
+	}
+	sd_log_buffer_s *partial = &logBuffers[handedOver];
+	if (isOk) {
+		// this is the only write which is not a whole number of sectors
+		writeLogBuffer(partial);
+	} else {
+		droppedRecordsCounter += partial->recordCount;
+		partial->size = 0;
+		partial->recordCount = 0;
+	}
+	writingBuffer = -1;
+	activeBuffer = 0;
+
+	lockSdSpi();
+	if (isPreallocated) {
+		// unused tail of preallocated area goes back to free clusters
+		f_truncate(&FDLogFile);
+		isPreallocated = false;
+	}
+	f_close(&FDLogFile);						// close file
+	f_sync(&FDLogFile);							// sync ALL
+	mmcDisconnect(&MMCD1);						// Brings the driver in a state safe for card removal.
+	mmcStop(&MMCD1);							// Disables the MMC peripheral.
+	unlockSdSpi();
+	f_mount(NULL, 0, 0);						// FATFS: Unregister work area prior to discard it
+	memset(&FDLogFile, 0, sizeof(FIL));			// clear FDLogFile
+	isLogFileClosing = false;
+	setSdCardReady(false);						// status = false
+	scheduleMsg(&logger, "MMC/SD card removed");
+}
+
+static THD_FUNCTION(sdWriterThread, arg) {
+	(void)arg;
+	chRegSetThreadName("SD_Writer");
+
+	while (true) {
+		chBSemWait(&sdWriterSemaphore);
+		int index = writingBuffer;
+		if (index >= 0 && isSdCardAlive()) {
+			if (writeLogBuffer(&logBuffers[index])) {
+				writingBuffer = -1;
+				bufferWriteCounter++;
+				if (bufferWriteCounter % SD_SYNC_FREQUENCY == 0) {
+					/**
+					 * Performance optimization: not f_sync after each buffer, f_sync updates directory entry and FAT
+					 */
+					syncLogFile();
+				}
+			} else {
+				writingBuffer = -1;
+				closeLogFile();
+			}
+		}
+		if (isUnmountRequested) {
+			isUnmountRequested = false;
+			if (isSdCardAlive()) {
+				closeLogFile();
+			}
+			chBSemSignal(&sdUnmountSemaphore);
+		}
+	}
+}
+
 /**
  * @brief Appends specified line to the current log file
+ *
+ * Line is only copied into log buffer, SD writer thread does the actual writing. If both buffers are
+ * full the line is dropped.
  */
 void appendToLog(const char *line) {
-	UINT bytesWritten;
-
 	if (!isSdCardAlive()) {
 		if (!errorReported)
 			scheduleMsg(&logger, "appendToLog Error: No File system is mounted");
 		errorReported = TRUE;
 		return;
 	}
-	UINT lineLength = strlen(line);
-	totalLoggedBytes += lineLength;
-	lockSpi(SPI_NONE);
-	FRESULT err = f_write(&FDLogFile, line, lineLength, &bytesWritten);
-	if (bytesWritten < lineLength) {
-		printError("write error or disk full", err); // error or disk full
-		mmcUnMount();
+	int lineLength = strlen(line);
+	bool needToWakeWriter = false;
+
+	bool alreadyLocked = lockAnyContext();
+	sd_log_buffer_s *buffer = &logBuffers[activeBuffer];
+	int freeSize = SD_LOG_BUFFER_SIZE - buffer->size;
+	if (isLogFileClosing) {
+		// SD writer thread is closing the file, buffers are not ours anymore
+		droppedRecordsCounter++;
+	} else if ((lineLength >= freeSize && writingBuffer >= 0) || lineLength > freeSize + SD_LOG_BUFFER_SIZE) {
+		droppedRecordsCounter++;
 	} else {
-		writeCounter++;
-		totalWritesCounter++;
-		if (writeCounter >= F_SYNC_FREQUENCY) {
-			/**
-			 * Performance optimization: not f_sync after each line, f_sync is probably a heavy operation
-			 * todo: one day someone should actually measure the relative cost of f_sync
-			 */
-			f_sync(&FDLogFile);
-			totalSyncCounter++;
-			writeCounter = 0;
+		totalLoggedBytes += lineLength;
+		buffer->recordCount++;
+		// lines could span two buffers: this way every buffer handed to the writer is exactly full
+		int head = minI(lineLength, freeSize);
+		memcpy(buffer->data + buffer->size, line, head);
+		buffer->size += head;
+		if (buffer->size == SD_LOG_BUFFER_SIZE) {
+			writingBuffer = activeBuffer;
+			activeBuffer ^= 1;
+			needToWakeWriter = true;
+			sd_log_buffer_s *next = &logBuffers[activeBuffer];
+			memcpy(next->data, line + head, lineLength - head);
+			next->size = lineLength - head;
+			next->recordCount = 0;
 		}
 	}
+	if (!alreadyLocked) {
+		unlockAnyContext();
+	}
 
-	unlockSpi();
+	if (needToWakeWriter) {
+		chBSemSignal(&sdWriterSemaphore);
+	}
 }
 
 /*
@@ -348,14 +583,10 @@ static void mmcUnMount(void) {
 		scheduleMsg(&logger, "Error: No File system is mounted. \"mountsd\" first");
 		return;
 	}
-	f_close(&FDLogFile);						// close file
-	f_sync(&FDLogFile);							// sync ALL
-	mmcDisconnect(&MMCD1);						// Brings the driver in a state safe for card removal.
-	mmcStop(&MMCD1);							// Disables the MMC peripheral.
-	f_mount(NULL, 0, 0);						// FATFS: Unregister work area prior to discard it
-	memset(&FDLogFile, 0, sizeof(FIL));			// clear FDLogFile
-	setSdCardReady(false);						// status = false
-	scheduleMsg(&logger, "MMC/SD card removed");
+	// SD writer thread might be in the middle of a write, it flushes and closes once it is done
+	isUnmountRequested = true;
+	chBSemSignal(&sdWriterSemaphore);
+	chBSemWait(&sdUnmountSemaphore);
 }
 
 #if HAL_USE_USB_MSD
@@ -381,12 +612,12 @@ static void MMCmount(void) {
 	}
 
 	// Performs the initialization procedure on the inserted card.
-	lockSpi(SPI_NONE);
+	lockSdSpi();
 	sdStatus = SD_STATE_CONNECTING;
 	if (mmcConnect(&MMCD1) != HAL_SUCCESS) {
 		sdStatus = SD_STATE_NOT_CONNECTED;
 		warning(CUSTOM_OBD_MMC_ERROR, "Can't connect or mount MMC/SD");
-		unlockSpi();
+		unlockSdSpi();
 		return;
 	}
 
@@ -414,7 +645,7 @@ static void MMCmount(void) {
 	//}
 
 
-	unlockSpi();
+	unlockSdSpi();
 #if HAL_USE_USB_MSD
 	sdStatus = SD_STATE_MOUNTED;
 	return;
@@ -443,6 +674,10 @@ static THD_FUNCTION(MMCmonThread, arg) {
 			tsOutputChannels.debugIntField2 = totalWritesCounter;
 			tsOutputChannels.debugIntField3 = totalSyncCounter;
 			tsOutputChannels.debugIntField4 = fileCreatedCounter;
+			tsOutputChannels.debugIntField5 = droppedRecordsCounter;
+			tsOutputChannels.debugFloatField1 = NT2US(maxSpiLockNt);
+			int writeMs = NT2US(totalWriteDurationNt) / 1000;
+			tsOutputChannels.debugFloatField2 = writeMs == 0 ? 0 : totalWrittenBytes / writeMs;
 		}
 
 		// this returns TRUE if SD module is there, even without an SD card?
@@ -491,6 +726,9 @@ void initMmcCard(void) {
 	mmcObjectInit(&MMCD1); 						// Initializes an instance.
 	mmcStart(&MMCD1, &mmccfg);
 
+	chBSemObjectInit(&sdWriterSemaphore, true);
+	chBSemObjectInit(&sdUnmountSemaphore, true);
+	chThdCreateStatic(sdWriterThreadStack, sizeof(sdWriterThreadStack), LOWPRIO, (tfunc_t)(void*) sdWriterThread, NULL);
 	chThdCreateStatic(mmcThreadStack, sizeof(mmcThreadStack), LOWPRIO, (tfunc_t)(void*) MMCmonThread, NULL);
 
 	addConsoleAction("mountsd", MMCmount);
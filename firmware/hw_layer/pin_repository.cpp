@@ -17,6 +17,7 @@
 #include "memstreams.h"
 #include "drivers/gpio/gpio_ext.h"
 #include "smart_gpio.h"
+#include "efi_gpio.h"
 #include "hardware.h"
 
 static bool initialized = false;
@@ -170,6 +171,21 @@ static void reportPins(void) {
 	#endif
 
 	scheduleMsg(&logger, "Total pins count: %d", totalPinsUsed);
+
+	scheduleMsg(&logger, "grouped output edges=%d register writes=%d", outputPinGroupEdgeCounter,
+			outputPinGroupWriteCounter);
+
+	#if (BOARD_EXT_GPIOCHIPS > 0)
+		for (int i = 0; i < BOARD_EXT_GPIOCHIPS; i++) {
+			struct gpiochip_batch_stats stats;
+			const char *chip_name = gpiochips_getBatchStats(i, &stats);
+			if (chip_name != NULL) {
+				scheduleMsg(&logger, "ext %s: batches=%d pins=%d max size=%d latency last=%dus max=%dus",
+					chip_name, stats.batches, stats.pins, stats.maxBatchSize,
+					(int)NT2US(stats.lastLatencyNt), (int)NT2US(stats.maxLatencyNt));
+			}
+		}
+	#endif
 }
 
 static MemoryStream portNameStream;
@@ -31,6 +31,7 @@ EXTERN_ENGINE;
 extern TunerStudioOutputChannels tsOutputChannels;
 #endif /* EFI_TUNER_STUDIO */
 #include "hardware.h"
+#include "spi_arbiter.h"
 #include "backup_ram.h"
 #include "pin_repository.h"
 
@@ -94,11 +95,13 @@ static constexpr float lambdaLsu49[] = {
 
 static uint8_t cjReadRegister(uint8_t regAddr) {
 #if ! EFI_UNIT_TEST
+	spiArbiterAcquire(driver, &cj125spicfg, SPI_PRIORITY_NORMAL, MS2US(CJ125_TICK_DELAY));
 	spiSelect(driver);
 	tx_buff[0] = regAddr;
 	spiSend(driver, 1, tx_buff);
 	spiReceive(driver, 1, rx_buff);
 	spiUnselect(driver);
+	spiArbiterRelease(driver);
 
 #ifdef CJ125_DEBUG_SPI
 	scheduleMsg(logger, "cjReadRegister: addr=%d answer=%d", regAddr, rx_buff[0]);
@@ -117,9 +120,11 @@ static void cjWriteRegister(uint8_t regAddr, uint8_t regValue) {
 #endif /* CJ125_DEBUG_SPI */
 	// todo: extract 'sendSync' method?
 #if HAL_USE_SPI
+	spiArbiterAcquire(driver, &cj125spicfg, SPI_PRIORITY_NORMAL, MS2US(CJ125_TICK_DELAY));
 	spiSelect(driver);
 	spiSend(driver, 2, tx_buff);
 	spiUnselect(driver);
+	spiArbiterRelease(driver);
 #endif /* HAL_USE_SPI */
 }
 
@@ -0,0 +1,193 @@
+/**
+ * @file	software_knock.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "software_knock.h"
+
+#if EFI_SOFTWARE_KNOCK
+
+#include "engine.h"
+#include "engine_math.h"
+#include "rpm_calculator.h"
+#include "trigger_central.h"
+#include "hip9011_logic.h"
+#include "knock_dsp.h"
+#include "adc_inputs.h"
+#include "pin_repository.h"
+
+#if !STM32_ADC_USE_ADC3
+#error "EFI_SOFTWARE_KNOCK requires STM32_ADC_USE_ADC3"
+#endif
+
+EXTERN_ENGINE;
+
+#define KNOCK_ADC_DEVICE ADCD3
+
+static Logging *logger;
+
+static KnockDsp dsp;
+static float dspBaseFrequencyHz;
+
+static adcsample_t sampleBuffer[KNOCK_DSP_MAX_SAMPLES] NO_CACHE;
+/**
+ * samples per window for current rpm, updated once per engine cycle
+ */
+static volatile int sampleCount;
+static volatile int samplingCylinder = -1;
+static volatile int samplingCount;
+/**
+ * true from conversion start until the thread is done with the buffer
+ */
+static volatile bool isBufferBusy = false;
+
+static binary_semaphore_t knockSemaphore;
+static THD_WORKING_AREA(knockThreadStack, UTILITY_THREAD_STACK_SIZE);
+
+typedef struct {
+	scheduling_s start;
+	int cylinderIndex;
+} knock_window_s;
+
+static knock_window_s windows[IGNITION_PIN_COUNT];
+
+static uint32_t windowCounter = 0;
+static uint32_t skippedWindowCounter = 0;
+static uint32_t maxProcessingNt = 0;
+
+static void knockCompletionCallback(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
+	(void)buffer;
+	(void)n;
+	// ADC driver fires an intermediate callback when the buffer is half full
+	if (adcp->state != ADC_COMPLETE) {
+		return;
+	}
+	chSysLockFromISR();
+	chBSemSignalI(&knockSemaphore);
+	chSysUnlockFromISR();
+}
+
+/**
+ * one channel converted again and again until DMA has filled the requested number of samples
+ */
+static ADCConversionGroup knockConversionGroup = { FALSE, 1 /* num_channels */, knockCompletionCallback, NULL,
+		0, // cr1
+		ADC_CR2_SWSTART | ADC_CR2_CONT, // cr2
+		ADC_SMPR1_SMP_AN10(ADC_SAMPLE_480) |
+		ADC_SMPR1_SMP_AN11(ADC_SAMPLE_480) |
+		ADC_SMPR1_SMP_AN12(ADC_SAMPLE_480) |
+		ADC_SMPR1_SMP_AN13(ADC_SAMPLE_480), // sample times for channels 10...18
+		ADC_SMPR2_SMP_AN0(ADC_SAMPLE_480) |
+		ADC_SMPR2_SMP_AN1(ADC_SAMPLE_480) |
+		ADC_SMPR2_SMP_AN2(ADC_SAMPLE_480) |
+		ADC_SMPR2_SMP_AN3(ADC_SAMPLE_480), // sample times for channels 0...9
+		0,
+		0,
+		ADC_SQR1_NUM_CH(1), // Conversion group sequence 13...16 + sequence length
+		0, // Conversion group sequence 7...12
+		0  // Conversion group sequence 1...6, channel is set on init
+};
+
+static void startSampling(knock_window_s *window) {
+	if (isBufferBusy || sampleCount < 2) {
+		// previous window is still being sampled or processed
+		skippedWindowCounter++;
+		return;
+	}
+	isBufferBusy = true;
+	samplingCylinder = window->cylinderIndex;
+	samplingCount = sampleCount;
+	chSysLockFromISR();
+	adcStartConversionI(&KNOCK_ADC_DEVICE, &knockConversionGroup, sampleBuffer, samplingCount);
+	chSysUnlockFromISR();
+}
+
+/**
+ * Shaft Position callback used to schedule knock windows of all cylinders for this engine cycle
+ */
+static void knockWindowCallback(trigger_event_e ckpEventType, uint32_t index, efitick_t edgeTimestamp DECLARE_ENGINE_PARAMETER_SUFFIX) {
+	(void)ckpEventType;
+	// this callback is invoked on interrupt thread
+	if (index != 0)
+		return;
+
+	int rpm = GET_RPM_VALUE;
+	if (!isValidRpm(rpm))
+		return;
+
+	angle_t windowWidth = CONFIG(knockDetectionWindowEnd) - CONFIG(knockDetectionWindowStart);
+	int windowSamples = (int)(getOneDegreeTimeUs(rpm) * windowWidth * KNOCK_SAMPLE_RATE_HZ / 1000000);
+	sampleCount = minI(windowSamples, KNOCK_DSP_MAX_SAMPLES);
+
+	for (int i = 0; i < CONFIG(specs.cylindersCount); i++) {
+		angle_t angle = CONFIG(knockDetectionWindowStart) + ENGINE(ignitionPositionWithinEngineCycle[i]);
+		fixAngle(angle, "knock", CUSTOM_ERR_6647);
+		windows[i].cylinderIndex = i;
+		scheduleByAngle(&windows[i].start, edgeTimestamp, angle, { startSampling, &windows[i] } PASS_ENGINE_PARAMETER_SUFFIX);
+	}
+}
+
+static msg_t knockThread(void *arg) {
+	(void)arg;
+	chRegSetThreadName("Knock");
+	while (true) {
+		chBSemWait(&knockSemaphore);
+
+		uint32_t startNt = getTimeNowLowerNt();
+		float frequencyHz = getHIP9011Band(PASS_HIP_PARAMS) * 1000;
+		if (frequencyHz != dspBaseFrequencyHz) {
+			dspBaseFrequencyHz = frequencyHz;
+			dsp.configure(KNOCK_SAMPLE_RATE_HZ, frequencyHz);
+		}
+		float knockVolts = dsp.process(sampleBuffer, samplingCount) * engine->adcToVoltageInputDividerCoefficient;
+		int cylinderIndex = samplingCylinder;
+		isBufferBusy = false;
+
+		windowCounter++;
+		engine->knockLogic(knockVolts);
+		engine->knockTracker.onKnockSample(cylinderIndex, knockVolts, CONFIG(knockVThreshold), CONFIG(maxKnockSubDeg),
+				currentTimeMillis());
+		maxProcessingNt = maxI(maxProcessingNt, getTimeNowLowerNt() - startNt);
+	}
+	return -1;
+}
+
+static void showSoftwareKnockInfo(void) {
+	scheduleMsg(logger, "software knock on %s: %dHz sample rate, %d samples per window", getAdc_channel_e(
+			engineConfiguration->hipOutputChannel), KNOCK_SAMPLE_RATE_HZ, sampleCount);
+	for (int i = 0; i < dsp.bandCount; i++) {
+		scheduleMsg(logger, " band %d: %.0fHz amplitude=%.2f", i, dsp.bandFrequencyHz[i], dsp.bandAmplitude[i]);
+	}
+	KnockTracker *tracker = &engine->knockTracker;
+	efitimems_t nowMs = currentTimeMillis();
+	for (int i = 0; i < engineConfiguration->specs.cylindersCount; i++) {
+		scheduleMsg(logger, " cylinder %d: %.3fv noise floor=%.3fv threshold=%.3fv knocks=%d/%d retard=%.1f", i + 1,
+				tracker->knockLevel[i], tracker->noiseFloor[i], tracker->getThreshold(i, engineConfiguration->knockVThreshold),
+				tracker->knockCounter[i], tracker->sampleCounter[i], tracker->getRetard(i, nowMs));
+	}
+	scheduleMsg(logger, "windows=%d skipped=%d max processing=%dus threshold=%.2fv", windowCounter,
+			skippedWindowCounter, (int)NT2US(maxProcessingNt), engineConfiguration->knockVThreshold);
+}
+
+void initSoftwareKnock(Logging *sharedLogger) {
+	logger = sharedLogger;
+	addConsoleAction("knockinfo", showSoftwareKnockInfo);
+	adc_channel_e channel = engineConfiguration->hipOutputChannel;
+	if (CONFIG(isHip9011Enabled) || channel == EFI_ADC_NONE) {
+		return;
+	}
+
+	knockConversionGroup.sqr3 = channel;
+	efiSetPadMode("knock", getAdcChannelBrainPin("knock", channel), PAL_MODE_INPUT_ANALOG);
+	adcStart(&KNOCK_ADC_DEVICE, NULL);
+
+	chBSemObjectInit(&knockSemaphore, true);
+	chThdCreateStatic(knockThreadStack, sizeof(knockThreadStack), NORMALPRIO, (tfunc_t)(void*) knockThread, NULL);
+
+	addTriggerEventListener(&knockWindowCallback, "knock window", engine);
+}
+
+#endif /* EFI_SOFTWARE_KNOCK */
@@ -0,0 +1,19 @@
+/**
+ * @file	software_knock.h
+ * @brief	Knock detection without HIP9011: raw knock sensor is sampled by ADC3 and processed by KnockDsp
+ *
+ * Knock sensor signal, biased to half of ADC range, goes to hipOutputChannel pin. For every cylinder the pin is
+ * sampled over the knock detection window offset by that cylinder firing angle and the window is then run through
+ * a Goertzel filter bank tuned to the same bore based frequency HIP9011 band is tuned to.
+ *
+ * Boards which enable EFI_SOFTWARE_KNOCK need STM32_ADC_USE_ADC3 and hipOutputChannel on an ADC3 capable pin.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+void initSoftwareKnock(Logging *sharedLogger);
@@ -0,0 +1,280 @@
+/**
+ * @file	spi_arbiter.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "global.h"
+#include "spi_arbiter.h"
+
+static const char *priorityNames[SPI_PRIORITY_COUNT] = {"urgent", "normal", "bulk"};
+
+const char *getSpiPriorityName(spi_priority_e priority) {
+	return priority < SPI_PRIORITY_COUNT ? priorityNames[priority] : "invalid";
+}
+
+/**
+ * @return true if a should be granted the bus before b
+ */
+static bool isAhead(const spi_request_s *a, const spi_request_s *b) {
+	if (a->priority != b->priority) {
+		return a->priority < b->priority;
+	}
+	if (a->deadlineNt == 0) {
+		// first come first served among requests without deadline
+		return false;
+	}
+	return b->deadlineNt == 0 || a->deadlineNt < b->deadlineNt;
+}
+
+void SpiArbiter::grant(spi_request_s *request, efitick_t nowNt) {
+	owner = request;
+	grantNt = nowNt;
+	int priority = request->priority;
+	grantCounter[priority]++;
+	waitTime[priority].add(nowNt - request->requestNt);
+	if (request->deadlineNt != 0 && nowNt > request->deadlineNt) {
+		missedDeadlineCounter[priority]++;
+	}
+}
+
+bool SpiArbiter::request(spi_request_s *request, efitick_t nowNt) {
+	request->requestNt = nowNt;
+	request->next = nullptr;
+	if (owner == nullptr) {
+		grant(request, nowNt);
+		return true;
+	}
+	spi_request_s **position = &head;
+	while (*position != nullptr && !isAhead(request, *position)) {
+		position = &(*position)->next;
+	}
+	request->next = *position;
+	*position = request;
+	return false;
+}
+
+spi_request_s *SpiArbiter::release(efitick_t nowNt) {
+	if (owner != nullptr) {
+		int priority = owner->priority;
+		maxHoldNt[priority] = maxI(maxHoldNt[priority], nowNt - grantNt);
+	}
+	owner = nullptr;
+	spi_request_s *next = head;
+	if (next != nullptr) {
+		head = next->next;
+		grant(next, nowNt);
+	}
+	return next;
+}
+
+bool SpiArbiter::isBusy() const {
+	return owner != nullptr;
+}
+
+int SpiArbiter::getQueueLength() const {
+	int result = 0;
+	for (spi_request_s *current = head; current != nullptr; current = current->next) {
+		result++;
+	}
+	return result;
+}
+
+void SpiArbiter::resetStatistics() {
+	for (int i = 0; i < SPI_PRIORITY_COUNT; i++) {
+		waitTime[i].reset();
+		grantCounter[i] = 0;
+		missedDeadlineCounter[i] = 0;
+		maxHoldNt[i] = 0;
+	}
+}
+
+#if HAL_USE_SPI
+
+/**
+ * SPI1..SPI4 plus one slot for users without a known driver
+ */
+#define SPI_BUS_COUNT 5
+
+typedef struct {
+	SPIDriver *driver;
+	/**
+	 * configuration the driver was last started with by the arbiter, NULL if owner has started it on its own
+	 */
+	const SPIConfig *config;
+	SpiArbiter arbiter;
+	/**
+	 * ISR request which owns the bus but needs the driver restarted with its configuration first, see onGrantI
+	 */
+	spi_request_s *pendingRestart;
+	uint32_t deferredRestartCounter;
+} spi_bus_s;
+
+static spi_bus_s buses[SPI_BUS_COUNT];
+
+static Logging *logger;
+
+/**
+ * spiStart() cannot be invoked from ISR, this thread does it on behalf of ISR users
+ */
+static THD_WORKING_AREA(spiRestartThreadStack, UTILITY_THREAD_STACK_SIZE);
+static thread_reference_t spiRestartThread = NULL;
+
+/**
+ * Buses are registered on first use, this method is invoked under system lock
+ */
+static spi_bus_s *getSpiBus(SPIDriver *driver) {
+	for (int i = 0; i < SPI_BUS_COUNT; i++) {
+		if (buses[i].driver == driver) {
+			return &buses[i];
+		}
+	}
+	for (int i = 0; i < SPI_BUS_COUNT; i++) {
+		if (buses[i].driver == NULL) {
+			buses[i].driver = driver;
+			return &buses[i];
+		}
+	}
+	// too many distinct drivers: they would share last bus arbiter which is still correct, only less parallel
+	return &buses[SPI_BUS_COUNT - 1];
+}
+
+static void onGrantI(spi_bus_s *bus, spi_request_s *request) {
+	if (request->onGrant == NULL) {
+		chThdResumeI((thread_reference_t *)request->context, MSG_OK);
+		return;
+	}
+	if (request->context != bus->config) {
+		/**
+		 * Last owner has left the driver with another configuration. Request keeps the bus, the driver is
+		 * restarted from thread context and only then the exchange is started.
+		 */
+		bus->deferredRestartCounter++;
+		bus->pendingRestart = request;
+		chThdResumeI(&spiRestartThread, MSG_OK);
+		return;
+	}
+	request->onGrant(request);
+}
+
+static void releaseI(spi_bus_s *bus) {
+	spi_request_s *next = bus->arbiter.release(getTimeNowNt());
+	if (next != NULL) {
+		onGrantI(bus, next);
+	}
+}
+
+static THD_FUNCTION(spiRestartThreadFunction, arg) {
+	(void)arg;
+	chRegSetThreadName("SPI restart");
+
+	while (true) {
+		chSysLock();
+		spi_bus_s *bus = NULL;
+		while (bus == NULL) {
+			for (int i = 0; i < SPI_BUS_COUNT && bus == NULL; i++) {
+				if (buses[i].pendingRestart != NULL) {
+					bus = &buses[i];
+				}
+			}
+			if (bus == NULL) {
+				chThdSuspendS(&spiRestartThread);
+			}
+		}
+		spi_request_s *request = bus->pendingRestart;
+		bus->pendingRestart = NULL;
+		chSysUnlock();
+
+		// request owns the bus so nobody else touches the driver meanwhile
+		const SPIConfig *config = (const SPIConfig *)request->context;
+		spiStart(bus->driver, config);
+
+		chSysLock();
+		bus->config = config;
+		request->onGrant(request);
+		chSchRescheduleS();
+		chSysUnlock();
+	}
+}
+
+void spiArbiterAcquire(SPIDriver *driver, const SPIConfig *config, spi_priority_e priority, int deadlineUs) {
+	efiAssertVoid(CUSTOM_STACK_SPI, getCurrentRemainingStack() > 128, "spiAcquire");
+	thread_reference_t thread = NULL;
+	spi_request_s request;
+	request.priority = priority;
+	request.onGrant = NULL;
+	request.context = &thread;
+
+	chSysLock();
+	spi_bus_s *bus = getSpiBus(driver);
+	efitick_t nowNt = getTimeNowNt();
+	request.deadlineNt = deadlineUs == 0 ? 0 : nowNt + US2NT(deadlineUs);
+	if (!bus->arbiter.request(&request, nowNt)) {
+		// previous owner would resume us once we are at the head of the queue
+		chThdSuspendS(&thread);
+	}
+	chSysUnlock();
+
+	if (config != NULL && bus->config != config) {
+		spiStart(driver, config);
+	}
+	bus->config = config;
+}
+
+void spiArbiterRelease(SPIDriver *driver) {
+	chSysLock();
+	releaseI(getSpiBus(driver));
+	chSchRescheduleS();
+	chSysUnlock();
+}
+
+void spiArbiterSubmitI(SPIDriver *driver, const SPIConfig *config, spi_request_s *request) {
+	spi_bus_s *bus = getSpiBus(driver);
+	request->context = (void *)config;
+	if (bus->arbiter.request(request, getTimeNowNt())) {
+		onGrantI(bus, request);
+	}
+}
+
+void spiArbiterReleaseI(SPIDriver *driver) {
+	releaseI(getSpiBus(driver));
+}
+
+static void printSpiArbiterState(void) {
+	for (int i = 0; i < SPI_BUS_COUNT; i++) {
+		spi_bus_s *bus = &buses[i];
+		if (bus->driver == NULL) {
+			continue;
+		}
+		scheduleMsg(logger, "bus %d: busy=%s queue=%d deferred restarts=%d", i, boolToString(bus->arbiter.isBusy()),
+				bus->arbiter.getQueueLength(), bus->deferredRestartCounter);
+		for (int p = 0; p < SPI_PRIORITY_COUNT; p++) {
+			latency_histogram_s h;
+			bus->arbiter.waitTime[p].snapshot(&h);
+			latency_percentiles_s wait;
+			latencyHistogramGetPercentiles(&h, &wait);
+			scheduleMsg(logger, " %s: grants=%d wait p50=%dus p99=%dus max=%dus missed=%d max hold=%dus",
+					getSpiPriorityName((spi_priority_e)p), bus->arbiter.grantCounter[p], (int)NT2US(wait.p50),
+					(int)NT2US(wait.p99), (int)NT2US(wait.max), bus->arbiter.missedDeadlineCounter[p],
+					(int)NT2US(bus->arbiter.maxHoldNt[p]));
+		}
+	}
+}
+
+static void resetSpiArbiterStatistics(void) {
+	for (int i = 0; i < SPI_BUS_COUNT; i++) {
+		buses[i].arbiter.resetStatistics();
+		buses[i].deferredRestartCounter = 0;
+	}
+}
+
+void initSpiArbiter(Logging *sharedLogger) {
+	logger = sharedLogger;
+	addConsoleAction("spiinfo", printSpiArbiterState);
+	addConsoleAction("spireset", resetSpiArbiterStatistics);
+	chThdCreateStatic(spiRestartThreadStack, sizeof(spiRestartThreadStack), NORMALPRIO + 2,
+			(tfunc_t)(void*) spiRestartThreadFunction, NULL);
+}
+
+#endif /* HAL_USE_SPI */
@@ -0,0 +1,123 @@
+/**
+ * @file	spi_arbiter.h
+ * @brief Priority based SPI bus ownership
+ *
+ * SD card, HIP9011, CJ125 and smart GPIO chips could share one SPI bus. With a plain mutex a knock window
+ * command or an injector driver update could wait behind a whole SD card write. Here waiting transactions are
+ * granted the bus by priority class and then by deadline, while bulk users release the bus between chunks
+ * so that urgent users could jump ahead.
+ *
+ * SpiArbiter itself only decides who is next, it does not depend on ChibiOS so that the same logic is used
+ * by the host model, see spi_arbiter_model.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "global.h"
+
+typedef enum {
+	/**
+	 * knock window commands
+	 */
+	SPI_PRIORITY_URGENT = 0,
+	/**
+	 * smart drivers, wideband controller
+	 */
+	SPI_PRIORITY_NORMAL = 1,
+	/**
+	 * SD card, potentiometers. Bulk users are expected to hold the bus for SPI_BULK_CHUNK_SIZE bytes at most
+	 */
+	SPI_PRIORITY_BULK = 2,
+	SPI_PRIORITY_COUNT = 3,
+} spi_priority_e;
+
+#define SPI_BULK_CHUNK_SIZE 1024
+
+#if HAL_USE_SPI
+/**
+ * Blocks current thread until it owns the bus of given driver. Not for ISR context.
+ * @param config if not NULL, driver is restarted with this configuration unless it was the last one used
+ * @param deadlineUs zero if there is no deadline
+ */
+EXTERNC void spiArbiterAcquire(SPIDriver *driver, const SPIConfig *config, spi_priority_e priority, int deadlineUs);
+EXTERNC void spiArbiterRelease(SPIDriver *driver);
+#endif /* HAL_USE_SPI */
+
+#ifdef __cplusplus
+
+#include "latency_histogram.h"
+
+struct spi_request_s;
+/**
+ * Invoked in system locked state, from ISR or from SPI restart thread.
+ */
+typedef void (*spi_grant_callback_t)(spi_request_s *request);
+
+struct spi_request_s {
+	spi_priority_e priority;
+	/**
+	 * zero if there is no deadline. Within same priority class earliest deadline goes first
+	 */
+	efitick_t deadlineNt;
+	efitick_t requestNt;
+	/**
+	 * ISR users cannot wait, they are notified once bus is granted. nullptr for thread users
+	 */
+	spi_grant_callback_t onGrant;
+	/**
+	 * whatever the caller needs in order to wake up the waiting owner
+	 */
+	void *context;
+	spi_request_s *next;
+};
+
+class SpiArbiter {
+public:
+	/**
+	 * @return true if bus was free and is now owned by this request, false if request was queued
+	 */
+	bool request(spi_request_s *request, efitick_t nowNt);
+	/**
+	 * Current owner gives the bus away.
+	 * @return request which now owns the bus, nullptr if nobody is waiting
+	 */
+	spi_request_s *release(efitick_t nowNt);
+	bool isBusy() const;
+	int getQueueLength() const;
+	void resetStatistics();
+
+	/**
+	 * time from request to grant
+	 */
+	LatencyHistogram waitTime[SPI_PRIORITY_COUNT];
+	uint32_t grantCounter[SPI_PRIORITY_COUNT] = {};
+	uint32_t missedDeadlineCounter[SPI_PRIORITY_COUNT] = {};
+	uint32_t maxHoldNt[SPI_PRIORITY_COUNT] = {};
+private:
+	void grant(spi_request_s *request, efitick_t nowNt);
+	spi_request_s *owner = nullptr;
+	efitick_t grantNt = 0;
+	/**
+	 * waiting requests sorted by priority, deadline and then by arrival
+	 */
+	spi_request_s *head = nullptr;
+};
+
+const char *getSpiPriorityName(spi_priority_e priority);
+
+#if HAL_USE_SPI
+/**
+ * Queues an exchange for ISR context. Priority, deadline and onGrant have to be set by the caller, the callback is
+ * expected to start the exchange and to invoke spiArbiterReleaseI once it is done.
+ * Driver cannot be restarted from ISR: if it was last started with another configuration, the request keeps
+ * the bus while SPI restart thread invokes spiStart() with given configuration and then the callback.
+ */
+void spiArbiterSubmitI(SPIDriver *driver, const SPIConfig *config, spi_request_s *request);
+void spiArbiterReleaseI(SPIDriver *driver);
+void initSpiArbiter(Logging *sharedLogger);
+#endif /* HAL_USE_SPI */
+
+#endif /* __cplusplus */
@@ -19,10 +19,16 @@ struct FuncPair {
 	FuncChain<resist, therm> thermistor;
 };
 
-static CCM_OPTIONAL FunctionalSensor clt(SensorType::Clt, MS2NT(10));
-static CCM_OPTIONAL FunctionalSensor iat(SensorType::Iat, MS2NT(10));
-static CCM_OPTIONAL FunctionalSensor aux1(SensorType::AuxTemp1, MS2NT(10));
-static CCM_OPTIONAL FunctionalSensor aux2(SensorType::AuxTemp2, MS2NT(10));
+/**
+ * Temperatures change slowly and thermistor channels are noisy: four slow ADC frames are averaged into
+ * one update, that is every 20ms at 200Hz slow ADC rate
+ */
+#define TEMP_SENSOR_OVERSAMPLING 4
+
+static CCM_OPTIONAL FunctionalSensor clt(SensorType::Clt, MS2NT(50));
+static CCM_OPTIONAL FunctionalSensor iat(SensorType::Iat, MS2NT(50));
+static CCM_OPTIONAL FunctionalSensor aux1(SensorType::AuxTemp1, MS2NT(50));
+static CCM_OPTIONAL FunctionalSensor aux2(SensorType::AuxTemp2, MS2NT(50));
 
 static FuncPair fclt, fiat, faux1, faux2;
 
@@ -60,7 +66,7 @@ static void configureTempSensor(FunctionalSensor &sensor,
 
 	configTherm(sensor, p, config, isLinear);
 
-	AdcSubscription::SubscribeSensor(sensor, channel);
+	AdcSubscription::SubscribeSensor(sensor, channel, 0.0f, TEMP_SENSOR_OVERSAMPLING);
 
 	// Register & subscribe
 	if (!sensor.Register()) {
@@ -30,11 +30,54 @@ static Logging * logging;
 static int consoleActionCount = 0;
 static TokenCallback consoleActions[CONSOLE_MAX_ACTIONS] CCM_OPTIONAL;
 
+/**
+ * Open addressing index into consoleActions, built as actions are registered so that
+ * command lookup does not need to compare against every registered token.
+ * Zero means empty slot, otherwise value is action index plus one.
+ */
+#define CONSOLE_ACTIONS_HASH_SIZE 512
+static_assert((CONSOLE_ACTIONS_HASH_SIZE & (CONSOLE_ACTIONS_HASH_SIZE - 1)) == 0, "hash size should be power of two");
+static_assert(CONSOLE_ACTIONS_HASH_SIZE >= 2 * CONSOLE_MAX_ACTIONS, "hash size too small for CONSOLE_MAX_ACTIONS");
+static uint16_t consoleActionsHash[CONSOLE_ACTIONS_HASH_SIZE];
+
 #define SECURE_LINE_PREFIX "sec!"
 #define SECURE_LINE_PREFIX_LENGTH 4
 
 void resetConsoleActions(void) {
 	consoleActionCount = 0;
+	memset(consoleActionsHash, 0, sizeof(consoleActionsHash));
+}
+
+/**
+ * FNV-1a hash of token, token ends with zero or space
+ */
+static uint32_t hashToken(const char *token) {
+	uint32_t hash = 2166136261u;
+	while (*token != 0 && *token != SPACE_CHAR) {
+		hash ^= (uint8_t)*token++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @return slot which either holds the action with given token or is the empty slot where it should go
+ */
+static uint16_t *findActionSlot(const char *token) {
+	uint32_t index = hashToken(token);
+	while (true) {
+		index &= CONSOLE_ACTIONS_HASH_SIZE - 1;
+		uint16_t *slot = &consoleActionsHash[index];
+		if (*slot == 0 || strEqual(token, consoleActions[*slot - 1].token)) {
+			return slot;
+		}
+		index++;
+	}
+}
+
+static TokenCallback *findAction(const char *token) {
+	uint16_t slot = *findActionSlot(token);
+	return slot == 0 ? NULL : &consoleActions[slot - 1];
 }
 
 static void doAddAction(const char *token, action_type_e type, Void callback, void *param) {
@@ -45,10 +88,10 @@ static void doAddAction(const char *token, action_type_e type, Void callback, vo
 			firmwareError(CUSTOM_ERR_COMMAND_LOWER_CASE_EXPECTED, "lowerCase expected [%s]", token);
 		}
 	}
-	for (int i = 0; i < consoleActionCount; i++) {
-		if (strcmp(token, consoleActions[i].token) == 0 /* zero result means strings are equal */) {
-			firmwareError(CUSTOM_SAME_TWICE, "Same action twice [%s]", token);
-		}
+	uint16_t *slot = findActionSlot(token);
+	if (*slot != 0) {
+		firmwareError(CUSTOM_SAME_TWICE, "Same action twice [%s]", token);
+		return;
 	}
 
 	efiAssertVoid(CUSTOM_CONSOLE_TOO_MANY, consoleActionCount < CONSOLE_MAX_ACTIONS, "Too many console actions");
@@ -57,6 +100,7 @@ static void doAddAction(const char *token, action_type_e type, Void callback, vo
 	current->parameterType = type;
 	current->callback = callback;
 	current->param = param;
+	*slot = consoleActionCount;
 #endif /* EFI_DISABLE_CONSOLE_ACTIONS */
 }
 
@@ -224,220 +268,142 @@ int findEndOfToken(const char *line) {
 		parameter[spaceIndex] = 0; \
 }
 
-void handleActionWithParameter(TokenCallback *current, char *parameter) {
-    while (parameter[0] == SPACE_CHAR) {
-		parameter[0] = 0;
-		parameter++;
-	}
-
-    switch (current->parameterType) {
-	case STRING_PARAMETER:
-	{
-		VoidCharPtr callbackS = (VoidCharPtr) current->callback;
-		(*callbackS)(parameter);
-		return;
-	}
-	case STRING_PARAMETER_P:
-	{
-			VoidCharPtrVoidPtr callbackS = (VoidCharPtrVoidPtr) current->callback;
-			(*callbackS)(parameter, current->param);
-			return;
-	}
-	default:
-		// todo: handle all cases explicitly
-		break;
-	}
-
-
-
-	// todo: refactor this hell!
-	if (current->parameterType == STRING2_PARAMETER || current->parameterType == STRING2_PARAMETER_P) {
+/**
+ * Splits parameter line into at most maxArgs arguments in one pass. Quoted tokens are kept as one argument,
+ * the last argument receives the remainder of the line (this is how STRINGx_PARAMETER actions get values with spaces)
+ * @return number of arguments
+ */
+static int splitArguments(char *parameter, char **argv, int maxArgs) {
+	int argc = 0;
+	while (argc < maxArgs - 1) {
 		int spaceIndex = findEndOfToken(parameter);
 		if (spaceIndex == -1) {
-			return;
+			break;
 		}
 		REPLACE_SPACES_WITH_ZERO;
-		char * param0 = parameter;
-
+		argv[argc++] = parameter;
 		parameter += spaceIndex + 1;
-		char * param1 = parameter;
-
-		if (current->parameterType == STRING2_PARAMETER) {
-			VoidCharPtrCharPtr callbackS = (VoidCharPtrCharPtr) current->callback;
-			(*callbackS)(param0, param1);
-		} else {
-			VoidCharPtrCharPtrVoidPtr callbackS = (VoidCharPtrCharPtrVoidPtr) current->callback;
-			(*callbackS)(param0, param1, current->param);
-		}
-		return;
 	}
+	argv[argc++] = parameter;
+	return argc;
+}
 
-	if (current->parameterType == STRING3_PARAMETER) {
-		int spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1) {
-			return;
-		}
-		REPLACE_SPACES_WITH_ZERO;
-		char * param0 = parameter;
-
-		parameter += spaceIndex + 1;
-		spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1)
-			return;
-		REPLACE_SPACES_WITH_ZERO;
-		char * param1 = parameter;
-		parameter += spaceIndex + 1;
-		char * param2 = parameter;
-
-		VoidCharPtrCharPtrCharPtr callbackS = (VoidCharPtrCharPtrCharPtr) current->callback;
-		(*callbackS)(param0, param1, param2);
-		return;
-
+static bool parseInt(const char *parameter, int *value) {
+	*value = atoi(parameter);
+	if (absI(*value) == ERROR_CODE) {
+#if EFI_PROD_CODE || EFI_SIMULATOR
+		scheduleMsg(logging, "not an integer [%s]", parameter);
+#endif
+		return false;
 	}
+	return true;
+}
 
-	// todo: refactor this hell!
-	if (current->parameterType == STRING5_PARAMETER) {
-		int spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1) {
-			return;
-		}
-		REPLACE_SPACES_WITH_ZERO;
-		char * param0 = parameter;
-
-		parameter += spaceIndex + 1;
-		spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1)
-			return;
-		REPLACE_SPACES_WITH_ZERO;
-		char * param1 = parameter;
+static bool parseFloat(const char *parameter, float *value) {
+	*value = atoff(parameter);
+	if (cisnan(*value)) {
+		print("invalid float [%s]\r\n", parameter);
+		return false;
+	}
+	return true;
+}
 
-		parameter += spaceIndex + 1;
-		spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1)
-			return;
-		REPLACE_SPACES_WITH_ZERO;
-		char * param2 = parameter;
+#define MAX_ACTION_ARGUMENTS 5
 
-		parameter += spaceIndex + 1;
-		spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1)
-			return;
-		REPLACE_SPACES_WITH_ZERO;
-		char * param3 = parameter;
+void handleActionWithParameter(TokenCallback *current, char *parameter) {
+	while (parameter[0] == SPACE_CHAR) {
+		parameter[0] = 0;
+		parameter++;
+	}
 
-		parameter += spaceIndex + 1;
-		char * param4 = parameter;
+	int expectedCount = getParameterCount(current->parameterType);
+	if (expectedCount < 1) {
+		// FLOAT_PARAMETER_NAN_ALLOWED and other single-value types which are not listed in getParameterCount
+		expectedCount = 1;
+	}
 
-		VoidCharPtrCharPtrCharPtrCharPtrCharPtr callbackS = (VoidCharPtrCharPtrCharPtrCharPtrCharPtr) current->callback;
-		(*callbackS)(param0, param1, param2, param3, param4);
+	char *argv[MAX_ACTION_ARGUMENTS];
+	int argc = splitArguments(parameter, argv, expectedCount);
+	if (argc < expectedCount) {
 		return;
-
 	}
 
-	if (current->parameterType == TWO_INTS_PARAMETER) {
-		int spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1)
-			return;
-		REPLACE_SPACES_WITH_ZERO;
-		int value1 = atoi(parameter);
-		if (absI(value1) == ERROR_CODE) {
-#if EFI_PROD_CODE || EFI_SIMULATOR
-			scheduleMsg(logging, "not an integer [%s]", parameter);
-#endif
+	switch (current->parameterType) {
+	case STRING_PARAMETER:
+		((VoidCharPtr) current->callback)(argv[0]);
+		return;
+	case STRING_PARAMETER_P:
+		((VoidCharPtrVoidPtr) current->callback)(argv[0], current->param);
+		return;
+	case STRING2_PARAMETER:
+		((VoidCharPtrCharPtr) current->callback)(argv[0], argv[1]);
+		return;
+	case STRING2_PARAMETER_P:
+		((VoidCharPtrCharPtrVoidPtr) current->callback)(argv[0], argv[1], current->param);
+		return;
+	case STRING3_PARAMETER:
+		((VoidCharPtrCharPtrCharPtr) current->callback)(argv[0], argv[1], argv[2]);
+		return;
+	case STRING5_PARAMETER:
+		((VoidCharPtrCharPtrCharPtrCharPtrCharPtr) current->callback)(argv[0], argv[1], argv[2], argv[3], argv[4]);
+		return;
+	case TWO_INTS_PARAMETER:
+	case TWO_INTS_PARAMETER_P:
+	{
+		int value1, value2;
+		if (!parseInt(argv[0], &value1) || !parseInt(argv[1], &value2)) {
 			return;
 		}
-		parameter += spaceIndex + 1;
-		int value2 = atoi(parameter);
-		if (absI(value2) == ERROR_CODE) {
-#if EFI_PROD_CODE || EFI_SIMULATOR
-			scheduleMsg(logging, "not an integer [%s]", parameter);
-#endif
-			return;
+		if (current->parameterType == TWO_INTS_PARAMETER) {
+			((VoidIntInt) current->callback)(value1, value2);
+		} else {
+			((VoidIntIntVoidPtr) current->callback)(value1, value2, current->param);
 		}
-		VoidIntInt callbackS = (VoidIntInt) current->callback;
-		(*callbackS)(value1, value2);
 		return;
 	}
-
-	if (current->parameterType == FLOAT_PARAMETER_NAN_ALLOWED) {
-		float value = atoff(parameter);
-		VoidFloat callbackF = (VoidFloat) current->callback;
-
-		// invoke callback function by reference
-		(*callbackF)(value);
+	case FLOAT_PARAMETER_NAN_ALLOWED:
+		((VoidFloat) current->callback)(atoff(argv[0]));
 		return;
-	}
-
-	if (current->parameterType == FLOAT_PARAMETER) {
-		float value = atoff(parameter);
-		if (cisnan(value)) {
-			print("invalid float [%s]\r\n", parameter);
+	case FLOAT_PARAMETER:
+	{
+		float value;
+		if (!parseFloat(argv[0], &value)) {
 			return;
 		}
-		VoidFloat callbackF = (VoidFloat) current->callback;
-
-		// invoke callback function by reference
-		(*callbackF)(value);
+		((VoidFloat) current->callback)(value);
 		return;
 	}
-
-	if (current->parameterType == FLOAT_FLOAT_PARAMETER || current->parameterType == FLOAT_FLOAT_PARAMETER_P) {
-		int spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1)
-			return;
-		REPLACE_SPACES_WITH_ZERO;
-		float value1 = atoff(parameter);
-		if (cisnan(value1)) {
-			print("invalid float [%s]\r\n", parameter);
-			return;
-		}
-
-		parameter += spaceIndex + 1;
-		float value2 = atoff(parameter);
-
-		if (cisnan(value2)) {
-			print("invalid float [%s]\r\n", parameter);
+	case FLOAT_FLOAT_PARAMETER:
+	case FLOAT_FLOAT_PARAMETER_P:
+	{
+		float value1, value2;
+		if (!parseFloat(argv[0], &value1) || !parseFloat(argv[1], &value2)) {
 			return;
 		}
-	if (current->parameterType == FLOAT_FLOAT_PARAMETER) {
-			VoidFloatFloat callbackS = (VoidFloatFloat) current->callback;
-			(*callbackS)(value1, value2);
+		if (current->parameterType == FLOAT_FLOAT_PARAMETER) {
+			((VoidFloatFloat) current->callback)(value1, value2);
 		} else {
-			VoidFloatFloatVoidPtr callbackS = (VoidFloatFloatVoidPtr) current->callback;
-			(*callbackS)(value1, value2, current->param);
+			((VoidFloatFloatVoidPtr) current->callback)(value1, value2, current->param);
 		}
 		return;
 	}
-
-	if (current->parameterType == INT_FLOAT_PARAMETER) {
-		int spaceIndex = findEndOfToken(parameter);
-		if (spaceIndex == -1)
-			return;
-		REPLACE_SPACES_WITH_ZERO;
-		int value1 = atoi(parameter);
-		if (absI(value1) == ERROR_CODE) {
-#if EFI_PROD_CODE || EFI_SIMULATOR
-			scheduleMsg(logging, "not an integer [%s]", parameter);
-#endif
-			return;
-		}
-		parameter += spaceIndex + 1;
-		float value2 = atoff(parameter);
-
-		if (cisnan(value2)) {
-			print("invalid float [%s]\r\n", parameter);
+	case INT_FLOAT_PARAMETER:
+	{
+		int value1;
+		float value2;
+		if (!parseInt(argv[0], &value1) || !parseFloat(argv[1], &value2)) {
 			return;
 		}
-		
-		VoidIntFloat callback = (VoidIntFloat) current->callback;
-		callback(value1, value2);
-
+		((VoidIntFloat) current->callback)(value1, value2);
 		return;
 	}
+	default:
+		break;
+	}
 
-	int value = atoi(parameter);
+	int value = atoi(argv[0]);
 	if (absI(value) == ERROR_CODE) {
-		print("invalid integer [%s]\r\n", parameter);
+		print("invalid integer [%s]\r\n", argv[0]);
 		return;
 	}
 
@@ -451,7 +417,6 @@ void handleActionWithParameter(TokenCallback *current, char *parameter) {
 		// invoke callback function by reference
 		(*callback1)(value);
 	}
-
 }
 
 /**
@@ -513,7 +478,7 @@ char *validateSecureLine(char *line) {
 static char confirmation[200];
 static char handleBuffer[200];
 
-static bool handleConsoleLineInternal(const char *commandLine, int lineLength) {
+bool handleConsoleLineInternal(const char *commandLine, int lineLength) {
 	strncpy(handleBuffer, commandLine, sizeof(handleBuffer) - 1);
 	handleBuffer[sizeof(handleBuffer) - 1] = 0; // we want this to be null-terminated for sure
 	char *line = handleBuffer;
@@ -521,34 +486,27 @@ static bool handleConsoleLineInternal(const char *commandLine, int lineLength) {
 
 //	print("processing [%s] with %d actions\r\n", line, consoleActionCount);
 
+	if (firstTokenLength != lineLength) {
+		line[firstTokenLength] = 0; // change space into line end
+	}
+
+	TokenCallback *current = findAction(line);
+	if (current == NULL) {
+		return false;
+	}
+
 	if (firstTokenLength == lineLength) {
 		// no-param actions are processed here
-		for (int i = 0; i < consoleActionCount; i++) {
-			TokenCallback *current = &consoleActions[i];
-			if (strEqual(line, current->token)) {
-				if (current->parameterType == NO_PARAMETER) {
-					(*current->callback)();
-				} else if (current->parameterType == NO_PARAMETER_P) {
-					VoidPtr cb = (VoidPtr) current->callback;
-					(*cb)(current->param);
-				}
-				return true;
-			}
+		if (current->parameterType == NO_PARAMETER) {
+			(*current->callback)();
+		} else if (current->parameterType == NO_PARAMETER_P) {
+			VoidPtr cb = (VoidPtr) current->callback;
+			(*cb)(current->param);
 		}
 	} else {
-		char *ptr = line + firstTokenLength;
-		ptr[0] = 0; // change space into line end
-		ptr++; // start from next symbol
-
-		for (int i = 0; i < consoleActionCount; i++) {
-			TokenCallback *current = &consoleActions[i];
-			if (strEqual(line, current->token)) {
-				handleActionWithParameter(current, ptr);
-				return true;
-			}
-		}
+		handleActionWithParameter(current, line + firstTokenLength + 1);
 	}
-	return false;
+	return true;
 }
 
 #if EFI_PROD_CODE || EFI_SIMULATOR
@@ -52,6 +52,11 @@ void resetConsoleActions(void);
 void helpCommand(void);
 void initConsoleLogic(Logging *sharedLogger);
 void handleConsoleLine(char *line);
+/**
+ * same as handleConsoleLine but without secure line validation and confirmation output
+ * @return true if command was found
+ */
+bool handleConsoleLineInternal(const char *commandLine, int lineLength);
 int findEndOfToken(const char *line);
 char *unquote(char *line);
 
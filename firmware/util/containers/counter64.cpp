@@ -6,6 +6,9 @@
  */
 
 #include "counter64.h"
+#if !EFI_UNIT_TEST
+#include "os_util.h"
+#endif /* EFI_UNIT_TEST */
 
 /**
  * The main use-case of this class is to keep track of a 64-bit global number of CPU ticks from reset.
@@ -15,28 +18,100 @@
  * keep track of the current CYCCNT value, detect these overflows, and provide a nice,
  * clean 64 bit global cycle counter.
  *
- * In order for this to function, it's your responsibility to invoke offer() method at least once a second.
+ * In order for this to function, it's your responsibility to invoke update() at least once a second.
  */
-Overflow64Counter::Overflow64Counter() {
-	state.highBits = 0;
-	state.lowBits = 0;
+void LockFreeCounter64::update(uint32_t value) {
+	// only writer is changing the sequence so current slot is stable here
+	volatile const counter64_slot_s *current = &slots[sequence & 1];
+	uint32_t highBits = current->highBits;
+	if (value < current->lowBits) {
+		// new value less than previous value means there was an overflow in that 32 bit counter
+		highBits++;
+	}
+	publish(highBits, value);
+}
+
+void LockFreeCounter64::set(efitime_t value) {
+	publish((uint32_t)((uint64_t)value >> 32), (uint32_t)value);
+}
+
+void LockFreeCounter64::publish(uint32_t highBits, uint32_t lowBits) {
+	uint32_t next = sequence + 1;
+	volatile counter64_slot_s *slot = &slots[next & 1];
+	slot->highBits = highBits;
+	slot->lowBits = lowBits;
+	// all fields are volatile so the compiler keeps this store after the slot stores; single core MCU
+	sequence = next;
 }
 
+void LockFreeCounter64::snapshot(counter64_slot_s *result) const {
+	uint32_t before;
+	while (true) {
+		before = sequence;
+		volatile const counter64_slot_s *slot = &slots[before & 1];
+		result->highBits = slot->highBits;
+		result->lowBits = slot->lowBits;
+		if (before == sequence) {
+			return;
+		}
+		retryCounter++;
+	}
+}
+
+efitime_t LockFreeCounter64::get() const {
+	counter64_slot_s s;
+	snapshot(&s);
+	return (efitime_t)(((uint64_t)s.highBits << 32) | s.lowBits);
+}
+
+efitime_t LockFreeCounter64::extend(const counter64_slot_s *snapshot, uint32_t value) {
+	uint64_t highBits = snapshot->highBits;
+	if (value < snapshot->lowBits) {
+		// counter has overflown since last update
+		highBits++;
+	}
+	return (efitime_t)((highBits << 32) | value);
+}
+
+#if !EFI_UNIT_TEST
 /**
- * in order to have atomic writes this should be invoked within a critical section
+ * Thread which has an active CachedTimeNowScope, only that thread changes these two fields so there is no lock.
+ * Other threads and ISRs do not match the owner and read the clock as usual.
  */
-void updateAndSet(State64 *state, uint32_t value) {
-	if (value < state->lowBits) {
-		// new value less than previous value means there was an overflow in that 32 bit counter
-		state->highBits += 0x100000000LL;
+static void *cachedTimeNowOwner = nullptr;
+static efitick_t cachedTimeNowNt;
+#endif /* EFI_UNIT_TEST */
+uint32_t cachedTimeNowHits = 0;
+
+efitick_t getTimeNowNtCached(void) {
+#if !EFI_UNIT_TEST
+	if (!isIsrContext() && cachedTimeNowOwner != nullptr && cachedTimeNowOwner == chThdGetSelfX()) {
+		cachedTimeNowHits++;
+		return cachedTimeNowNt;
 	}
-	state->lowBits = value;
+#endif /* EFI_UNIT_TEST */
+	return getTimeNowNt();
 }
 
-#if EFI_UNIT_TEST
-efitime_t Overflow64Counter::update(uint32_t value) {
-	updateAndSet(&state, value);
-	return state.highBits + state.lowBits;
+CachedTimeNowScope::CachedTimeNowScope() {
+	nowNt = getTimeNowNt();
+#if !EFI_UNIT_TEST
+	// periodic callback could be invoked from trigger ISR, there is no caching in ISR context
+	isOwner = !isIsrContext();
+	if (isOwner) {
+		previousOwner = cachedTimeNowOwner;
+		previousNt = cachedTimeNowNt;
+		cachedTimeNowNt = nowNt;
+		cachedTimeNowOwner = chThdGetSelfX();
+	}
+#endif /* EFI_UNIT_TEST */
 }
-#endif
 
+CachedTimeNowScope::~CachedTimeNowScope() {
+#if !EFI_UNIT_TEST
+	if (isOwner) {
+		cachedTimeNowOwner = previousOwner;
+		cachedTimeNowNt = previousNt;
+	}
+#endif /* EFI_UNIT_TEST */
+}
@@ -10,22 +10,45 @@
 #include "global.h"
 
 typedef struct {
-	// todo: would probably be better to keep the high bits as 32 bit field to be sure
-	volatile efitime_t highBits;
-	volatile uint32_t lowBits;
-} State64;
+	uint32_t highBits;
+	uint32_t lowBits;
+} counter64_slot_s;
 
-void updateAndSet(State64 *state, uint32_t value);
-
-class Overflow64Counter
-{
-  public:
-	Overflow64Counter();
+/**
+ * 64 bit value for a 32 bit MCU: writes are not interrupted by readers, reads take no lock and are safe from ISR.
+ *
+ * Writer fills the slot which readers are not looking at and only then publishes it by incrementing the
+ * sequence number, so a reader which has preempted the writer still reads the previous complete slot. A reader
+ * retries whenever the sequence has changed while it was copying, even after a single publication which did not
+ * touch the slot being copied: that costs an extra copy but keeps the check to one comparison.
+ *
+ * Writers should not preempt each other: either there is one writer context or writes are under lock.
+ */
+class LockFreeCounter64 {
+public:
+	/**
+	 * Extends free running 32 bit counter to 64 bits. Has to be invoked at least once per 32 bit overflow
+	 * period, otherwise an overflow would be missed.
+	 */
+	void update(uint32_t value);
+	void set(efitime_t value);
+	/**
+	 * @return last value stored by update() or set()
+	 */
+	efitime_t get() const;
+	void snapshot(counter64_slot_s *result) const;
+	/**
+	 * @param value 32 bit counter value which was read AFTER the snapshot was taken
+	 */
+	static efitime_t extend(const counter64_slot_s *snapshot, uint32_t value);
 
-	efitime_t get();
-#if EFI_UNIT_TEST
-	efitime_t update(uint32_t value);
-#endif
+	/**
+	 * how many times readers had to copy the slot again, for diagnostics only
+	 */
+	mutable volatile uint32_t retryCounter = 0;
+private:
+	void publish(uint32_t highBits, uint32_t lowBits);
 
-	State64 state;
+	volatile uint32_t sequence = 0;
+	volatile counter64_slot_s slots[2] = {};
 };
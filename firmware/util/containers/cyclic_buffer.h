@@ -185,4 +185,115 @@ void cyclic_buffer<T, maxSize>::clear() {
 	currentIndex = 0;
 }
 
+/**
+ * Fixed capacity cyclic buffer with power-of-two capacity so that indexing is a mask instead of modulo. Indexing
+ * does not branch on wrap around, add() still branches while the window is filling up and whenever current min or
+ * max is evicted.
+ *
+ * Sum, min and max of the last 'window' elements are maintained as aggregates on add(), so reading them is O(1).
+ * Please note that for floating point types running sum accumulates rounding error over time.
+ *
+ * Single writer contract: add() and clear() are expected to be invoked from one context only, for instance
+ * from the trigger callback. clear() from another context has to be done with that context locked out. Readers in other contexts only read the aggregates, each of which is a single word.
+ */
+template<typename T, int capacity, int window = capacity>
+class static_cyclic_buffer
+{
+	static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "capacity should be a power of two");
+	static_assert(window > 0 && window <= capacity, "window should be within capacity");
+	static const unsigned int mask = capacity - 1;
+
+  public:
+	static_cyclic_buffer() {
+		clear();
+	}
+
+	void add(T value) {
+		// while buffer is not full evicted element is still zero from clear()
+		T evicted = elements[(head - window) & mask];
+		elements[head & mask] = value;
+		head++;
+		sum += value - evicted;
+
+		if (count < window) {
+			count++;
+			if (count == 1 || value > max) {
+				max = value;
+			}
+			if (count == 1 || value < min) {
+				min = value;
+			}
+			return;
+		}
+
+		if (value >= max) {
+			max = value;
+		} else if (evicted == max) {
+			max = scan(true);
+		}
+		if (value <= min) {
+			min = value;
+		} else if (evicted == min) {
+			min = scan(false);
+		}
+	}
+
+	/**
+	 * @param age zero for most recently added element
+	 */
+	T getRecent(int age) const {
+		return elements[(head - 1 - age) & mask];
+	}
+
+	/**
+	 * @return sum of last 'window' elements
+	 */
+	T getSum() const {
+		return sum;
+	}
+
+	T getMax() const {
+		return max;
+	}
+
+	T getMin() const {
+		return min;
+	}
+
+	/**
+	 * @return number of elements within the window, at most 'window'
+	 */
+	int getCount() const {
+		return count;
+	}
+
+	void clear() {
+		memset(elements, 0, sizeof(elements));
+		head = 0;
+		count = 0;
+		sum = 0;
+		min = 0;
+		max = 0;
+	}
+
+  private:
+	T scan(bool isMax) const {
+		T result = getRecent(0);
+		for (int i = 1; i < window; i++) {
+			T v = getRecent(i);
+			if (isMax ? v > result : v < result) {
+				result = v;
+			}
+		}
+		return result;
+	}
+
+	T elements[capacity];
+	unsigned int head;
+	int count;
+	T sum;
+	T min;
+	T max;
+};
+
 #endif //CYCLIC_BUFFER_H
@@ -0,0 +1,45 @@
+/**
+ * @file	seqlock.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include "seqlock.h"
+#include <string.h>
+
+#define SEQLOCK_WRITERS_MASK 0xFFFF
+/**
+ * plus one version minus one writer in a single add
+ */
+#define SEQLOCK_WRITE_END 0xFFFF
+
+void SeqLock::writeBegin() {
+	/**
+	 * Atomic add so that a writer which preempts us between load and store, trigger ISR for instance, is not lost.
+	 * On Cortex-M this is LDREX/STREX without disabling interrupts.
+	 */
+	__atomic_fetch_add(&sequence, 1, __ATOMIC_RELAXED);
+	// structure stores should not be moved above, same as smp_wmb() of Linux seqcount
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void SeqLock::writeEnd() {
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_fetch_add(&sequence, SEQLOCK_WRITE_END, __ATOMIC_RELAXED);
+}
+
+bool SeqLock::read(const void *source, void *destination, size_t size) const {
+	for (int attempt = 0; attempt < SEQLOCK_MAX_ATTEMPTS; attempt++) {
+		uint32_t before = sequence;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		memcpy(destination, source, size);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if ((before & SEQLOCK_WRITERS_MASK) == 0 && before == sequence) {
+			return true;
+		}
+		retryCounter++;
+	}
+	failedCounter++;
+	return false;
+}
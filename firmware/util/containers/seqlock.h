@@ -0,0 +1,67 @@
+/**
+ * @file	seqlock.h
+ * @brief	Consistent lock free snapshots of structures which are updated from trigger ISR or fast threads
+ *
+ * Writer marks the structure busy before touching it and publishes a new version once done. Reader copies the
+ * structure into its own buffer and checks that nobody was writing and that the version has not changed while it
+ * was copying, otherwise it copies again. Writers never wait and never disable interrupts, readers never block
+ * writers.
+ *
+ * Low 16 bits of the sequence count writers which are currently inside, high 16 bits are the version. This way a
+ * writer preempted by another writer of the same structure, for instance fast callback thread preempted by trigger
+ * ISR, still keeps readers away until the outer writer is done.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include "rusefi_types.h"
+#include <stddef.h>
+
+/**
+ * A reader with priority above the writer would never see the writer finish, so attempts are limited
+ */
+#define SEQLOCK_MAX_ATTEMPTS 16
+
+class SeqLock {
+public:
+	void writeBegin();
+	void writeEnd();
+	/**
+	 * @return false if no consistent copy was made within SEQLOCK_MAX_ATTEMPTS, destination has the last attempt
+	 */
+	bool read(const void *source, void *destination, size_t size) const;
+
+	template<typename T>
+	bool snapshot(const T *source, T *destination) const {
+		return read(source, destination, sizeof(T));
+	}
+
+	/**
+	 * how many times readers had to copy again, for diagnostics only
+	 */
+	mutable volatile uint32_t retryCounter = 0;
+	/**
+	 * how many reads gave up
+	 */
+	mutable volatile uint32_t failedCounter = 0;
+private:
+	volatile uint32_t sequence = 0;
+};
+
+/**
+ * Marks the structure busy for the lifetime of the scope
+ */
+class SeqLockWriteScope {
+public:
+	explicit SeqLockWriteScope(SeqLock *lock) : lock(lock) {
+		lock->writeBegin();
+	}
+	~SeqLockWriteScope() {
+		lock->writeEnd();
+	}
+private:
+	SeqLock *lock;
+};
@@ -153,35 +153,36 @@ void debugInt(Logging *logging, const char *caption, int value) {
 	appendPrintf(logging, "%d%s", value, DELIMETER);
 }
 
+/**
+ * sign, ten integer digits, up to 29 zeros of huge values, dot, six fraction digits and terminating zero
+ */
+#define FLOAT_TEXT_MAX_LENGTH 48
+
+/**
+ * Unlike appendPrintf this does not go through the printf engine and does not promote float to double, see ftoa10()
+ */
 void appendFloat(Logging *logging, float value, int precision) {
-	/**
-	 * todo: #1 this implementation is less than perfect
-	 * todo: #2 The only way to avoid double promotion would probably be using *float instead of float
-	 * See also http://stackoverflow.com/questions/5522051/printing-a-float-in-c-while-avoiding-variadic-parameter-promotion-to-double
-	 */
-	switch (precision) {
-	case 1:
-		appendPrintf(logging, "%.1f", value);
-		break;
-	case 2:
-		appendPrintf(logging, "%.2f", value);
-		break;
-	case 3:
-		appendPrintf(logging, "%.3f", value);
-		break;
-	case 4:
-		appendPrintf(logging, "%.4f", value);
-		break;
-	case 5:
-		appendPrintf(logging, "%.5f", value);
-		break;
-	case 6:
-		appendPrintf(logging, "%.6f", value);
-		break;
-
-	default:
-		appendPrintf(logging, "%.2f", value);
+	if (precision < 1 || precision > 6) {
+		precision = 2;
 	}
+	if (logging->buffer != NULL && remainingSize(logging) > FLOAT_TEXT_MAX_LENGTH) {
+		// fast path: plenty of space, writing right into the buffer
+		logging->linePointer = ftoa10(logging->linePointer, value, precision);
+		return;
+	}
+	char text[FLOAT_TEXT_MAX_LENGTH];
+	ftoa10(text, value, precision);
+	logging->append(text);
+}
+
+void appendInt(Logging *logging, int value) {
+	if (logging->buffer != NULL && remainingSize(logging) > FLOAT_TEXT_MAX_LENGTH) {
+		logging->linePointer = itoa10(logging->linePointer, value);
+		return;
+	}
+	char text[FLOAT_TEXT_MAX_LENGTH];
+	itoa10(text, value);
+	logging->append(text);
 }
 
 void debugFloat(Logging *logging, const char *caption, float value, int precision) {
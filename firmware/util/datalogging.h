@@ -57,6 +57,7 @@ void debugInt(Logging *logging, const char *caption, int value);
 
 void debugFloat(Logging *logging, const char *text, float value, int precision);
 void appendFloat(Logging *logging, float value, int precision);
+void appendInt(Logging *logging, int value);
 
 void resetLogging(Logging *logging);
 
@@ -193,6 +193,56 @@ char* itoa10(char *p, int num) {
 	return itoa_signed(p, num, 10);
 }
 
+/**
+ * Float to string with fixed number of digits after the decimal point, digits are produced by integer math
+ * and float is never promoted to double.
+ *
+ * @param precision number of digits after the decimal point, [0, 6]
+ * @return pointer at the end zero symbol after the digits
+ */
+char* ftoa10(char *p, float num, int precision) {
+	if (cisnan(num)) {
+		strcpy(p, "nan");
+		return p + 3;
+	}
+	if (num < 0) {
+		*p++ = '-';
+		num = -num;
+	}
+	if (num > 3.4e38f) {
+		strcpy(p, "inf");
+		return p + 3;
+	}
+	// values which do not fit into uint32_t are printed as integer part followed by zeros
+	int extraZeros = 0;
+	while (num >= 4294967040.0f) {
+		num /= 10;
+		extraZeros++;
+	}
+
+	uint32_t scale = efiPow10(precision);
+	uint32_t integerPart = (uint32_t)num;
+	uint32_t fraction = (uint32_t)((num - integerPart) * scale + 0.5f);
+	if (fraction >= scale) {
+		// rounding has carried into integer part, like 0.999 with precision 2
+		integerPart++;
+		fraction -= scale;
+	}
+
+	p = ltoa_internal(p, integerPart, 10);
+	while (extraZeros-- > 0) {
+		*p++ = '0';
+	}
+	if (precision > 0) {
+		*p++ = '.';
+		for (uint32_t divider = scale / 10; divider > 0; divider /= 10) {
+			*p++ = '0' + (fraction / divider) % 10;
+		}
+	}
+	*p = 0;
+	return p;
+}
+
 #define EPS 0.0001
 
 bool isSameF(float v1, float v2) {
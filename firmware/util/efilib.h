@@ -60,6 +60,7 @@ int minI(int i1, int i2);
 float maxF(float i1, float i2);
 float minF(float i1, float i2);
 char* itoa10(char *p, int num);
+char* ftoa10(char *p, float num, int precision);
 bool isSameF(float v1, float v2);
 float clampF(float min, float clamp, float max);
 
@@ -70,9 +70,30 @@ efitimesec_t getTimeNowSeconds(void);
 
 #ifdef __cplusplus
 }
+
+/**
+ * Same as getTimeNowNt() but while the current thread has an active CachedTimeNowScope it returns the timestamp
+ * taken when the scope was opened, so that many timeout checks within one periodic pass do not read the clock again
+ * and again. Other threads and ISRs always get the live clock.
+ * Staleness is bounded by the duration of the pass, use getTimeNowNt() for anything scheduling related.
+ */
+efitick_t getTimeNowNtCached(void);
+
+class CachedTimeNowScope {
+public:
+	CachedTimeNowScope();
+	~CachedTimeNowScope();
+	efitick_t nowNt;
+private:
+	bool isOwner = false;
+	void *previousOwner = nullptr;
+	efitick_t previousNt = 0;
+};
 #endif /* __cplusplus */
 
-#if EFI_PROD_CODE || EFI_SIMULATOR
+#if EFI_SIGNAL_EXECUTOR_VIRTUAL_CLOCK
+ #define getTimeNowLowerNt() ((uint32_t)getTimeNowNt())
+#elif EFI_PROD_CODE || EFI_SIMULATOR
  #define getTimeNowLowerNt() port_rt_get_counter_value()
 #else
  #define getTimeNowLowerNt() 0
@@ -0,0 +1,104 @@
+/**
+ * @file	latency_histogram.cpp
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#include <string.h>
+#include "latency_histogram.h"
+
+int LatencyHistogram::getIndex(uint32_t value) {
+	if (value < LATENCY_HISTOGRAM_SUB_BUCKETS) {
+		return value;
+	}
+	int highestBit = 31 - __builtin_clz(value);
+	int shift = highestBit - LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+	return ((shift + 1) << LATENCY_HISTOGRAM_SUB_BUCKET_BITS) + ((value >> shift) & (LATENCY_HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+uint32_t LatencyHistogram::getLowerBound(int index) {
+	if (index < LATENCY_HISTOGRAM_SUB_BUCKETS) {
+		return index;
+	}
+	int shift = (index >> LATENCY_HISTOGRAM_SUB_BUCKET_BITS) - 1;
+	uint32_t subBucket = index & (LATENCY_HISTOGRAM_SUB_BUCKETS - 1);
+	return (LATENCY_HISTOGRAM_SUB_BUCKETS + subBucket) << shift;
+}
+
+void LatencyHistogram::add(uint32_t value) {
+	__atomic_fetch_add(&data.counts[getIndex(value)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&data.totalCount, 1, __ATOMIC_RELAXED);
+
+	uint32_t currentMax = __atomic_load_n(&data.maxValue, __ATOMIC_RELAXED);
+	while (value > currentMax
+			&& !__atomic_compare_exchange_n(&data.maxValue, &currentMax, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		// currentMax was refreshed by failed compare-exchange, let's try again
+	}
+}
+
+void LatencyHistogram::reset() {
+	for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++) {
+		__atomic_store_n(&data.counts[i], 0, __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&data.totalCount, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&data.maxValue, 0, __ATOMIC_RELAXED);
+}
+
+void LatencyHistogram::snapshot(latency_histogram_s *destination) const {
+	uint32_t totalCount = 0;
+	for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++) {
+		destination->counts[i] = __atomic_load_n(&data.counts[i], __ATOMIC_RELAXED);
+		totalCount += destination->counts[i];
+	}
+	// sum of copied buckets, not the live counter, so that percentiles are computed over what was actually copied
+	destination->totalCount = totalCount;
+	destination->maxValue = __atomic_load_n(&data.maxValue, __ATOMIC_RELAXED);
+}
+
+void latencyHistogramMerge(latency_histogram_s *destination, const latency_histogram_s *source) {
+	for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++) {
+		destination->counts[i] += source->counts[i];
+	}
+	destination->totalCount += source->totalCount;
+	if (source->maxValue > destination->maxValue) {
+		destination->maxValue = source->maxValue;
+	}
+}
+
+uint32_t latencyHistogramPercentile(const latency_histogram_s *h, float fraction) {
+	if (h->totalCount == 0) {
+		return 0;
+	}
+	// rank of the sample we are looking for, rounded up
+	uint32_t rank = (uint32_t)(fraction * h->totalCount);
+	if (rank < h->totalCount * fraction) {
+		rank++;
+	}
+	if (rank == 0) {
+		rank = 1;
+	}
+
+	uint32_t accumulated = 0;
+	for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++) {
+		accumulated += h->counts[i];
+		if (accumulated >= rank) {
+			if (i == LATENCY_HISTOGRAM_BUCKET_COUNT - 1) {
+				return h->maxValue;
+			}
+			uint32_t upperBound = LatencyHistogram::getLowerBound(i + 1) - 1;
+			// bucket upper bound could be above the largest value we have ever seen
+			return upperBound < h->maxValue ? upperBound : h->maxValue;
+		}
+	}
+	return h->maxValue;
+}
+
+void latencyHistogramGetPercentiles(const latency_histogram_s *h, latency_percentiles_s *result) {
+	result->count = h->totalCount;
+	result->p50 = latencyHistogramPercentile(h, 0.5f);
+	result->p90 = latencyHistogramPercentile(h, 0.9f);
+	result->p99 = latencyHistogramPercentile(h, 0.99f);
+	result->p999 = latencyHistogramPercentile(h, 0.999f);
+	result->max = h->maxValue;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file	latency_histogram.h
+ * @brief Log-linear latency histogram which could be updated from ISR context
+ *
+ * Unlike histogram_s, bucket index is computed in O(1) from the position of the highest set bit: each
+ * power of two range is split into LATENCY_HISTOGRAM_SUB_BUCKETS linear buckets, so relative error is
+ * below 1/LATENCY_HISTOGRAM_SUB_BUCKETS for any value.
+ *
+ * Counters are updated with atomic increments, so it is safe to record from an ISR while a thread
+ * takes a snapshot. Snapshots are plain structures which could be merged and sent over the binary protocol.
+ *
+ * @date Oct 18, 2026
+ * @author Andrey Belomutskiy, (c) 2012-2020
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 3
+#define LATENCY_HISTOGRAM_SUB_BUCKETS (1 << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+#define LATENCY_HISTOGRAM_BUCKET_COUNT ((32 - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+	uint32_t counts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+	uint32_t totalCount;
+	uint32_t maxValue;
+} latency_histogram_s;
+
+typedef struct {
+	uint32_t count;
+	uint32_t p50;
+	uint32_t p90;
+	uint32_t p99;
+	uint32_t p999;
+	uint32_t max;
+} latency_percentiles_s;
+
+/**
+ * Binary protocol payload, see TS_GET_LATENCY_HISTOGRAMS. All values are in NT
+ */
+typedef struct {
+	latency_histogram_s triggerToSpark;
+	latency_histogram_s eventQueueLateness;
+} latency_histograms_snapshot_s;
+
+class LatencyHistogram {
+public:
+	/**
+	 * this method is safe to invoke from ISR
+	 */
+	void add(uint32_t value);
+	void reset();
+	/**
+	 * Copies current counters into destination. Not atomic as a whole, concurrent add() calls could be
+	 * partially reflected, but every counter is consistent on its own.
+	 */
+	void snapshot(latency_histogram_s *destination) const;
+
+	static int getIndex(uint32_t value);
+	/**
+	 * @return smallest value which goes into bucket with given index
+	 */
+	static uint32_t getLowerBound(int index);
+
+private:
+	latency_histogram_s data = {};
+};
+
+void latencyHistogramMerge(latency_histogram_s *destination, const latency_histogram_s *source);
+/**
+ * @param fraction value in (0, 1] range, for instance 0.999 for p99.9
+ * @return upper bound of the bucket which contains requested percentile
+ */
+uint32_t latencyHistogramPercentile(const latency_histogram_s *h, float fraction);
+void latencyHistogramGetPercentiles(const latency_histogram_s *h, latency_percentiles_s *result);
@@ -52,6 +52,7 @@ float Pid::getOutput(float target, float input) {
 }
 
 float Pid::getUnclampedOutput(float target, float input, float dTime) {
+	SeqLockWriteScope scope(&stateLock);
 	float error = (target - input) * errorAmplificationCoef;
 	this->target = target;
 	this->input = input;
@@ -69,6 +70,7 @@ float Pid::getUnclampedOutput(float target, float input, float dTime) {
  * @param dTime seconds probably? :)
  */
 float Pid::getOutput(float target, float input, float dTime) {
+	SeqLockWriteScope scope(&stateLock);
 	float output = getUnclampedOutput(target, input, dTime);
 
 	if (output > parameters->maxValue) {
@@ -88,6 +90,7 @@ void Pid::updateFactors(float pFactor, float iFactor, float dFactor) {
 }
 
 void Pid::reset(void) {
+	SeqLockWriteScope scope(&stateLock);
 	dTerm = iTerm = 0;
 	output = input = target = previousError = 0;
 	errorAmplificationCoef = 1.0f;
@@ -247,6 +250,7 @@ PidIndustrial::PidIndustrial(pid_s *parameters) : Pid(parameters) {
 }
 
 float PidIndustrial::getOutput(float target, float input, float dTime) {
+	SeqLockWriteScope scope(&stateLock);
 	float ad, bd;
 	float error = (target - input) * errorAmplificationCoef;
 	float pTerm = parameters->pFactor * error;
@@ -9,6 +9,7 @@
 
 #include "engine_state_generated.h"
 #include "pid_state_generated.h"
+#include "seqlock.h"
 
 #if EFI_PROD_CODE || EFI_SIMULATOR
 #include "tunerstudio_configuration.h"
@@ -68,6 +69,10 @@ public:
 	// todo: move this to pid_s one day
 	float iTermMin = -1000000.0;
 	float iTermMax =  1000000.0;
+	/**
+	 * guards pid_state_s, see TS_GET_STRUCT
+	 */
+	SeqLock stateLock;
 protected:
 	pid_s *parameters;
 
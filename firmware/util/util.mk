@@ -10,11 +10,13 @@ UTILSRC_CPP = \
     $(UTIL_DIR)/containers/cyclic_buffer.cpp \
 	$(UTIL_DIR)/containers/listener_array.cpp \
 	$(UTIL_DIR)/containers/counter64.cpp \
+	$(UTIL_DIR)/containers/seqlock.cpp \
 	$(UTIL_DIR)/containers/local_version_holder.cpp \
 	$(UTIL_DIR)/containers/table_helper.cpp \
 	$(UTIL_DIR)/math/pid.cpp \
 	$(UTIL_DIR)/math/avg_values.cpp \
 	$(UTIL_DIR)/math/interpolation.cpp \
+	$(UTIL_DIR)/latency_histogram.cpp \
 	$(PROJECT_DIR)/util/datalogging.cpp \
 	$(PROJECT_DIR)/util/loggingcentral.cpp \
 	$(PROJECT_DIR)/util/cli_registry.cpp \